@@ -17,12 +17,15 @@ layout(std140, binding = 2) uniform Light{
     float quadratic_attenuation;
     float intensity;
     vec4 color;
+    mat4 world_to_profile;
+    int ies_profile_layer;
 } scene_light;
 
 layout(std140, binding = 3) uniform CommonData{
     vec4 camera_position;
     float light_camera_far_plane;
     float shadow_threshold;
+    float distance_to_furthest_ies_vertex;
 };
 
 layout (location = 0) uniform sampler2D g_positions;
@@ -31,6 +34,17 @@ layout (location = 2) uniform sampler2D g_diffuse;
 
 layout (location = 3) uniform samplerCube light_shadow_map;
 layout (location = 4) uniform samplerCube ies_masking_texture;
+layout (location = 5) uniform sampler2DArray ies_profiles;
+#ifdef IES_LOOKUP_MODE
+const int ies_lookup_mode = IES_LOOKUP_MODE;
+#else
+layout (location = 6) uniform int ies_lookup_mode;
+#endif
+
+const float PI = 3.14159265359;
+const int IES_LOOKUP_MASK = 0;
+const int IES_LOOKUP_ATLAS = 1;
+const int IES_LOOKUP_HARMONICS = 2;
 
 float compute_shadow_factor(vec3 light_to_fragment, float distance_from_light){
     float depth = texture(light_shadow_map, light_to_fragment).r;
@@ -43,6 +57,8 @@ float compute_shadow_factor(vec3 light_to_fragment, float distance_from_light){
     }
 }
 
+#include "ies_intensity.glsl"
+
 void main(){
     vec3 world_position = texture(g_positions, uv_coords).xyz;
     vec3 n = texture(g_normals, uv_coords).xyz;
@@ -62,9 +78,18 @@ void main(){
     d = d * attenuation_factor;
     vec3 diffuse_component = d * diffuse_color * scene_light.intensity;
 
-    vec3 mask_value = texture(ies_masking_texture, -l).rgb;
-    float multiplier = mask_value.r;
-    bool is_active = (mask_value.b == 1.0);
+    float multiplier;
+    bool is_active;
+    if(ies_lookup_mode != IES_LOOKUP_MASK){
+        float normalized_intensity = (ies_lookup_mode == IES_LOOKUP_ATLAS) ? profile_intensity(-l)
+                                                                          : harmonics_intensity(-l);
+        multiplier = normalized_intensity * distance_to_furthest_ies_vertex;
+        is_active = normalized_intensity > 0.0;
+    } else {
+        vec3 mask_value = texture(ies_masking_texture, -l).rgb;
+        multiplier = mask_value.r;
+        is_active = (mask_value.b == 1.0);
+    }
     diffuse_component *= is_active ? multiplier : 0.0;
 
     direct_lighting = vec4(diffuse_component * shadow_factor, 1.0);
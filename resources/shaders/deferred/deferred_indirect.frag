@@ -12,6 +12,8 @@ layout(std140, binding = 2) uniform Light{
     float quadratic_attenuation;
     float intensity;
     vec4 color;
+    mat4 world_to_profile;
+    int ies_profile_layer;
 } scene_light;
 
 layout (location = 0) uniform sampler2D g_positions;
@@ -22,7 +24,12 @@ layout (location = 4) uniform samplerCube rsm_normal_map;
 layout (location = 5) uniform samplerCube rsm_flux_map;
 layout (location = 6) uniform sampler1D sampling_offsets;
 
+//  A fixed count lets the compiler unroll the sampling loop
+#ifdef SAMPLES_PER_FRAGMENT
+const int samples_per_fragment = SAMPLES_PER_FRAGMENT;
+#else
 layout (location = 10) uniform int samples_per_fragment;
+#endif
 layout (location = 11) uniform float displacement_sphere_radius;
 
 void main(){
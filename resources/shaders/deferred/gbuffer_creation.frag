@@ -2,11 +2,7 @@
 
 in vec3 world_position;
 in vec3 world_normal;
-
-layout (std140, binding = 1) uniform MaterialProperties{
-    vec4 diffuse_color;
-    float shininess;
-};
+flat in vec4 object_diffuse_color;
 
 layout (location = 0) out vec4 gbuff_position;
 layout (location = 1) out vec4 gbuff_normal;
@@ -15,5 +11,5 @@ layout (location = 2) out vec4 gbuff_diffuse;
 void main(){
     gbuff_position = vec4(world_position, 1.0);
     gbuff_normal = vec4(world_normal, 1.0);
-    gbuff_diffuse = diffuse_color;
+    gbuff_diffuse = object_diffuse_color;
 }
\ No newline at end of file
@@ -9,17 +9,24 @@ layout(std140, binding = 0) uniform GBufferMatrices{
     uniform mat4 transposed_inversed_model;
 };
 
+layout (std140, binding = 1) uniform MaterialProperties{
+    vec4 diffuse_color;
+    float shininess;
+};
+
 //   This will be needed to write light-space positions on a cubemap;
 //  and this will need to be moved to a geometry shader
 //      uniform mat4 light_view_projection[6];
 
 out vec3 world_position;
 out vec3 world_normal;
+flat out vec4 object_diffuse_color;
 
 void main(){
     vec4 w_position = model * vec4(vertex_position, 1.0);
 
     world_position = w_position.xyz;
     world_normal = normalize(mat3(transposed_inversed_model) * vertex_normal);
+    object_diffuse_color = diffuse_color;
     gl_Position = projection_view * w_position;
 }
\ No newline at end of file
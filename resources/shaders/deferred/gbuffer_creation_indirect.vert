@@ -0,0 +1,36 @@
+#version 430 core
+
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in uint object_index;     // per instance; the base instance of each indirect command
+
+layout(std140, binding = 0) uniform GBufferMatrices{
+    uniform mat4 projection_view;               // with P left-multiplied by V, as in P * V
+    uniform mat4 model;
+    uniform mat4 transposed_inversed_model;
+};
+
+struct ObjectShaderData{
+    mat4 model;
+    mat4 transposed_inversed_model;
+    vec4 diffuse_color;
+    vec4 shininess;
+};
+
+layout(std430, binding = 2) readonly buffer ObjectData{
+    ObjectShaderData objects[];
+};
+
+out vec3 world_position;
+out vec3 world_normal;
+flat out vec4 object_diffuse_color;
+
+void main(){
+    ObjectShaderData object = objects[object_index];
+    vec4 w_position = object.model * vec4(vertex_position, 1.0);
+
+    world_position = w_position.xyz;
+    world_normal = normalize(mat3(object.transposed_inversed_model) * vertex_normal);
+    object_diffuse_color = object.diffuse_color;
+    gl_Position = projection_view * w_position;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+//  Intensity of the IES profile towards a direction, normalized to the brightest candela value, either looked up
+//  in the profile atlas or evaluated from the fitted spherical harmonics. The including shader declares the Light
+//  block as scene_light, the ies_profiles atlas sampler and PI before including this file.
+
+layout(std140, binding = 4) uniform IESHarmonics{
+    vec4 sh_coefficients[7];
+    int sh_order;
+};
+
+float profile_intensity(vec3 light_to_fragment){
+    //  Same angular parametrization used to fill the atlas layers: vertical angle from +y,
+    //  horizontal angle around +y, both in the light's photometric frame
+    vec3 d = normalize(mat3(scene_light.world_to_profile) * light_to_fragment);
+    float vertical_angle = acos(clamp(d.y, -1.0, 1.0));
+    float horizontal_angle = atan(-d.z, d.x);
+    vec2 profile_coords = vec2(horizontal_angle / (2.0 * PI), vertical_angle / PI);
+    return texture(ies_profiles, vec3(profile_coords, float(scene_light.ies_profile_layer))).r;
+}
+
+float harmonics_intensity(vec3 light_to_fragment){
+    //  Real spherical harmonics with the photometric vertical as polar axis, as in ies_spherical_harmonics.cpp
+    vec3 d = normalize(mat3(scene_light.world_to_profile) * light_to_fragment);
+    float x = d.x;
+    float y = d.z;
+    float z = d.y;
+    float x2 = x * x;
+    float y2 = y * y;
+    float z2 = z * z;
+
+    float basis[25] = float[25](
+        0.282095,
+        0.488603 * y, 0.488603 * z, 0.488603 * x,
+        1.092548 * x * y, 1.092548 * y * z, 0.315392 * (3.0 * z2 - 1.0), 1.092548 * x * z, 0.546274 * (x2 - y2),
+        0.590044 * y * (3.0 * x2 - y2), 2.890611 * x * y * z, 0.457046 * y * (5.0 * z2 - 1.0),
+        0.373176 * z * (5.0 * z2 - 3.0), 0.457046 * x * (5.0 * z2 - 1.0), 1.445306 * z * (x2 - y2),
+        0.590044 * x * (x2 - 3.0 * y2),
+        2.503343 * x * y * (x2 - y2), 1.770131 * y * z * (3.0 * x2 - y2), 0.946175 * x * y * (7.0 * z2 - 1.0),
+        0.669047 * y * z * (7.0 * z2 - 3.0), 0.105786 * (35.0 * z2 * z2 - 30.0 * z2 + 3.0),
+        0.669047 * x * z * (7.0 * z2 - 3.0), 0.473087 * (x2 - y2) * (7.0 * z2 - 1.0),
+        1.770131 * x * z * (x2 - 3.0 * y2), 0.625836 * (x2 * (x2 - 3.0 * y2) - y2 * (3.0 * x2 - y2))
+    );
+
+    int coefficients_number = (sh_order + 1) * (sh_order + 1);
+    float result = 0.0;
+    for(int i = 0; i < coefficients_number; i++){
+        result += sh_coefficients[i / 4][i % 4] * basis[i];
+    }
+    return max(result, 0.0);
+}
@@ -12,6 +12,8 @@ layout(std140, binding = 2) uniform Light{
     float quadratic_attenuation;
     float intensity;
     vec4 color;
+    mat4 world_to_profile;
+    int ies_profile_layer;
 } scene_light;
 
 layout(std140, binding = 3) uniform CommonData{
@@ -3,11 +3,7 @@
 in vec4 fragment_position;
 in vec4 light_space_fragment_position;
 in vec3 fragment_normal;
-
-layout (std140, binding = 1) uniform MaterialProperties{
-    vec4 diffuse_color;
-    float shininess;
-};
+flat in vec4 fragment_diffuse_color;
 
 layout(std140, binding = 2) uniform Light{
     vec4 position;
@@ -17,6 +13,8 @@ layout(std140, binding = 2) uniform Light{
     float quadratic_attenuation;
     float intensity;
     vec4 color;
+    mat4 world_to_profile;
+    int ies_profile_layer;
 } scene_light;
 
 layout(std140, binding = 3) uniform CommonData{
@@ -27,11 +25,24 @@ layout(std140, binding = 3) uniform CommonData{
 };
 
 layout (location = 6) uniform samplerCube ies_masking_texture;
+layout (location = 7) uniform sampler2DArray ies_profiles;
+#ifdef IES_LOOKUP_MODE
+const int ies_lookup_mode = IES_LOOKUP_MODE;
+#else
+layout (location = 8) uniform int ies_lookup_mode;
+#endif
+
+const float PI = 3.14159265359;
+const int IES_LOOKUP_MASK = 0;
+const int IES_LOOKUP_ATLAS = 1;
+const int IES_LOOKUP_HARMONICS = 2;
 
 layout (location = 0) out vec4 fragment_world_coords;
 layout (location = 1) out vec4 fragment_normals;
 layout (location = 2) out vec4 fragment_fluxes;
 
+#include "ies_intensity.glsl"
+
 void main(){
     vec3 light_to_fragment = fragment_position.xyz - scene_light.position.xyz;
     float distance_to_light = length(light_to_fragment);
@@ -43,12 +54,23 @@ void main(){
 
     fragment_normals = vec4(fragment_normal, 1.0);
 
-    vec3 ies_mask_data = texture(ies_masking_texture, l).rgb;
-    vec4 computed_flux = diffuse_color * scene_light.color * scene_light.intensity;
-    float is_emitting_light_along_l = ies_mask_data.b;
-    float intensity_modifier = ies_mask_data.g;
+    vec4 computed_flux = fragment_diffuse_color * scene_light.color * scene_light.intensity;
+#ifdef IGNORE_IES_PROFILE
+    //  Renders as if the light were isotropic, without a IES mask
+    fragment_fluxes = computed_flux;
+#else
+    float is_emitting_light_along_l;
+    float intensity_modifier;
+    if(ies_lookup_mode != IES_LOOKUP_MASK){
+        intensity_modifier = (ies_lookup_mode == IES_LOOKUP_ATLAS) ? profile_intensity(l)
+                                                                   : harmonics_intensity(l);
+        is_emitting_light_along_l = intensity_modifier > 0.0 ? 1.0 : 0.0;
+    } else {
+        vec3 ies_mask_data = texture(ies_masking_texture, l).rgb;
+        is_emitting_light_along_l = ies_mask_data.b;
+        intensity_modifier = ies_mask_data.g;
+    }
 
-    //  Temporarily disabling this line allows to render without a IES mask
     fragment_fluxes = vec4(computed_flux.xyz * intensity_modifier * is_emitting_light_along_l, 1.0);
-    //  fragment_fluxes = computed_flux;
+#endif
 }
\ No newline at end of file
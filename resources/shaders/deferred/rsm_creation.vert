@@ -9,12 +9,19 @@ layout(std140, binding = 0) uniform GBufferMatrices{
     uniform mat4 transposed_inversed_model;
 };
 
+layout (std140, binding = 1) uniform MaterialProperties{
+    vec4 diffuse_color;
+    float shininess;
+};
+
 out VS_DATA{
     vec3 normal;
+    flat vec4 diffuse_color;
 } vertex_data;
 
 void main(){
     vec4 fragment_position = model * vec4(vertex_position, 1.0);
     vertex_data.normal = normalize(mat3(transposed_inversed_model) * vertex_normal);
+    vertex_data.diffuse_color = diffuse_color;
     gl_Position = fragment_position;
 }
\ No newline at end of file
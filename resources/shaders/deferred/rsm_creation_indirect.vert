@@ -0,0 +1,29 @@
+#version 430 core
+
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in uint object_index;     // per instance; the base instance of each indirect command
+
+struct ObjectShaderData{
+    mat4 model;
+    mat4 transposed_inversed_model;
+    vec4 diffuse_color;
+    vec4 shininess;
+};
+
+layout(std430, binding = 2) readonly buffer ObjectData{
+    ObjectShaderData objects[];
+};
+
+out VS_DATA{
+    vec3 normal;
+    flat vec4 diffuse_color;
+} vertex_data;
+
+void main(){
+    ObjectShaderData object = objects[object_index];
+    vec4 fragment_position = object.model * vec4(vertex_position, 1.0);
+    vertex_data.normal = normalize(mat3(object.transposed_inversed_model) * vertex_normal);
+    vertex_data.diffuse_color = object.diffuse_color;
+    gl_Position = fragment_position;
+}
\ No newline at end of file
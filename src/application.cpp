@@ -2,8 +2,11 @@
 
 Application* Application::instance = nullptr;
 
-Application::Application(const std::string& app_name) {
-    name = app_name;
+Application::Application(const std::string& app_name)
+        : Application(engine::WindowProperties(app_name, 800, 800)) {}
+
+Application::Application(const engine::WindowProperties& window_properties) {
+    name = window_properties.title;
     fmt::print("[APPLICATION] {} started.\n", name);
     if(instance != nullptr){
         fmt::print("[APPLICATION - ERROR] Trying to instantiate more than one application.\n");
@@ -11,9 +14,14 @@ Application::Application(const std::string& app_name) {
     instance = this;
 
     using namespace engine;
-    main_window = Window::create(WindowProperties(app_name, 800, 800));
+    main_window = Window::create(window_properties);
+    if (main_window == nullptr) {
+        fmt::print("[APPLICATION - ERROR] No window could be created for {}.\n", name);
+        std::exit(EXIT_FAILURE);
+    }
     main_window->link_to_event_queue([this](auto ptr_to_event) { push_event(std::move(ptr_to_event)); });
     OpenGL3_Renderer::initialize();
+    last_frame_time = static_cast<float>(main_window->get_time());
     running = true;
 }
 
@@ -41,22 +49,34 @@ void Application::on_event(engine::Event& event) {
 }
 
 void Application::run() {
+    PROFILE_THREAD("Main thread");
     while (running) {
-        auto time = static_cast<float>(glfwGetTime());
-        float delta_time = time - last_frame_time;
-        last_frame_time = time;
+        render_frame();
+    }
+}
+
+void Application::render_frame() {
+    PROFILE_ZONE("Frame");
+    engine::OpenGL3_Renderer::begin_frame();
+    auto time = static_cast<float>(main_window->get_time());
+    float delta_time = time - last_frame_time;
+    last_frame_time = time;
 
+    {
+        PROFILE_ZONE("Event dispatch");
         while(!received_events.empty()){
             on_event(*received_events.front());
             received_events.pop();
         }
+    }
 
-        for (auto& layer : layers) {
-            layer->update(delta_time);
-        }
-
-        main_window->on_update();
+    for (auto& layer : layers) {
+        PROFILE_ZONE("Layer update");
+        layer->update(delta_time);
     }
+
+    PROFILE_ZONE("Swap buffers");
+    main_window->on_update();
 }
 
 Application& Application::reference() {
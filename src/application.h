@@ -6,15 +6,19 @@
 #include "engine/events/window_events.h"
 #include "engine/events/keyboard_events.h"
 #include "engine/layers/layer_container.h"
+#include "utility/cpu_profiler.h"
 
 #include <fmt/core.h>
 #include <fmt/color.h>
+#include <cstdlib>
 #include <utility>
 #include <queue>
 
 class Application {
 public:
     Application(const std::string& app_name = "Cornell Box");
+    //  Headless windows let the application run without a display server, with frames uncapped
+    explicit Application(const engine::WindowProperties& window_properties);
 
     virtual ~Application();
     virtual void on_event(engine::Event& event);
@@ -24,6 +28,9 @@ public:
     void push_event(std::unique_ptr<engine::Event> event);
 
 protected:
+    //  Events received since the last frame, then every layer, then the window
+    void render_frame();
+
     virtual bool on_window_closed([[maybe_unused]] engine::WindowClosedEvent& event);
     virtual bool on_window_resized(engine::WindowResizedEvent& event);
 
@@ -0,0 +1,183 @@
+#include "benchmark_app.h"
+
+#include "../utility/random_numbers.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <chrono>
+#include <fstream>
+
+BenchmarkApp::BenchmarkApp(benchmark::BenchmarkOptions&& benchmark_options, benchmark::CameraPath&& played_path)
+        : Application(window_properties_for(benchmark_options)), options(std::move(benchmark_options)),
+          path(std::move(played_path)),
+          headless_window{engine::EGL_Headless_Window::convert_from(main_window.get())} {}
+
+void BenchmarkApp::run() {
+    PROFILE_THREAD("Main thread");
+    benchmark::BenchmarkReport report{reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+                                      reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                                      options.scene_path, options.ies_path,
+                                      options.camera_path ? options.camera_path->string() : std::string{},
+                                      options.seed, options.frames, options.warmup_frames, {}};
+
+    for (const auto offsets_number : options.offsets_numbers) {
+        for (const auto& resolution : options.resolutions) {
+            for (const auto rsm_resolution : options.rsm_resolutions) {
+                const auto configuration = benchmark::RunConfiguration{offsets_number, resolution.x, resolution.y,
+                                                                       rsm_resolution};
+                fmt::print("[BENCHMARK] {} offsets, {}x{}, RSM {}\n", offsets_number, resolution.x, resolution.y,
+                           rsm_resolution);
+                auto run_report = measure(configuration);
+                if (!run_report) {
+                    status = EXIT_FAILURE;
+                    continue;
+                }
+                fmt::print("[BENCHMARK] CPU {:.3f} ms, GPU {:.3f} ms average, GPU p99 {:.3f} ms\n",
+                           run_report->cpu_frame.mean_ms, run_report->gpu_frame.mean_ms, run_report->gpu_frame.p99_ms);
+                report.runs.push_back(std::move(*run_report));
+            }
+        }
+    }
+
+    if (!benchmark::write_json_report(options.output_path, report)) {
+        status = EXIT_FAILURE;
+        return;
+    }
+    fmt::print("[BENCHMARK] {} runs written to {}\n", report.runs.size(), options.output_path.string());
+}
+
+int BenchmarkApp::exit_status() const noexcept {
+    return status;
+}
+
+engine::WindowProperties BenchmarkApp::window_properties_for(const benchmark::BenchmarkOptions& options) {
+    auto properties = engine::WindowProperties("Cornell Box Benchmark", options.resolutions.front().x,
+                                               options.resolutions.front().y);
+    properties.vsync = false;
+    properties.headless = true;
+    return properties;
+}
+
+std::optional<benchmark::RunReport> BenchmarkApp::measure(const benchmark::RunConfiguration& configuration) {
+    using namespace engine;
+
+    //  Restarts the streams, so a run draws the same sample sets wherever it sits in the sweep
+    random_num::use_fixed_seed(options.seed);
+
+    //  The layer sizes its targets after the viewport, which the resize sets
+    headless_window->resize(configuration.width, configuration.height);
+    const auto first_keyframe = path.at(0.0f);
+    auto camera = std::make_shared<FlyCamera>(
+        first_keyframe.camera_position,
+        glm::radians(first_keyframe.camera_yaw),
+        glm::radians(first_keyframe.camera_pitch),
+        CameraProjectionParameters{
+            .aspect_ratio = static_cast<float>(configuration.width) / static_cast<float>(configuration.height),
+            .field_of_view = 45.0f,
+            .planes = CameraPlanes{0.1f, 100.0f}},
+        CameraMode::Perspective);
+
+    auto created_layer = DeferredLayer::create_using(std::weak_ptr(camera), [this](auto ptr_to_queue) {
+        push_event(std::move(ptr_to_queue));
+    }, main_window->create_shared_context(), DeferredLayerSettings{options.scene_path, options.ies_path,
+                                                                   configuration.offsets_number,
+                                                                   configuration.rsm_resolution});
+    auto& layer = *created_layer;
+    layers.push_layer(std::move(created_layer));
+    applied_keyframe.reset();
+
+    const auto loading_started = main_window->get_time();
+    while (!layer.assets_loaded()) {
+        if (main_window->get_time() - loading_started > loading_timeout_seconds) {
+            fmt::print("[BENCHMARK] {} or {} did not load within {} s\n", options.scene_path, options.ies_path,
+                       loading_timeout_seconds);
+            layers.pop_layer(&layer);
+            return std::nullopt;
+        }
+        apply_keyframe(first_keyframe, *camera, layer);
+        render_frame();
+    }
+
+    auto& profiler = layer.pass_profiler();
+    profiler.set_history_length(options.frames);
+    profiler.set_waits_for_results(true);
+    for (auto frame = std::size_t{0}; frame < options.warmup_frames; ++frame) {
+        apply_keyframe(first_keyframe, *camera, layer);
+        render_frame();
+    }
+    profiler.flush();
+    profiler.clear_history();
+
+    std::vector<float> cpu_frame_ms;
+    cpu_frame_ms.reserve(options.frames);
+    for (auto frame = std::size_t{0}; frame < options.frames; ++frame) {
+        const auto progress = options.frames > 1
+                              ? static_cast<float>(frame) / static_cast<float>(options.frames - 1) : 0.0f;
+        const auto frame_start = std::chrono::steady_clock::now();
+        apply_keyframe(path.at(progress), *camera, layer);
+        render_frame();
+        cpu_frame_ms.push_back(std::chrono::duration<float, std::milli>(
+                std::chrono::steady_clock::now() - frame_start).count());
+    }
+    profiler.flush();
+
+    auto run_report = benchmark::RunReport{configuration, benchmark::summarize(std::move(cpu_frame_ms)),
+                                           benchmark::summarize(profiler.frame_times()), {}, {}};
+    for (const auto& pass : profiler.pass_statistics()) {
+        run_report.passes.push_back(benchmark::PassTimings{std::string(pass.name),
+                                                           benchmark::summarize(profiler.pass_times(pass.name))});
+    }
+    if (options.images_directory) {
+        run_report.image_path = write_image(configuration);
+    }
+
+    layers.pop_layer(&layer);
+    return run_report;
+}
+
+void BenchmarkApp::apply_keyframe(const benchmark::PathKeyframe& keyframe, engine::FlyCamera& camera,
+                                  engine::DeferredLayer& layer) {
+    //  Only what moved is redrawn, as when the path is flown by hand
+    const auto camera_moved = !applied_keyframe ||
+                              applied_keyframe->camera_position != keyframe.camera_position ||
+                              applied_keyframe->camera_yaw != keyframe.camera_yaw ||
+                              applied_keyframe->camera_pitch != keyframe.camera_pitch;
+    const auto light_moved = !applied_keyframe ||
+                             applied_keyframe->light_position != keyframe.light_position ||
+                             applied_keyframe->light_rotation != keyframe.light_rotation;
+    if (camera_moved) {
+        camera.state.position = keyframe.camera_position;
+        camera.state.angle_around_y = glm::radians(keyframe.camera_yaw);
+        camera.state.angle_around_x = glm::radians(keyframe.camera_pitch);
+        camera.update();
+        push_event(std::make_unique<engine::CameraMovedEvent>());
+    }
+    if (light_moved) {
+        layer.place_light(glm::vec4(keyframe.light_position, 1.0f), keyframe.light_rotation);
+    }
+    applied_keyframe = keyframe;
+}
+
+std::string BenchmarkApp::write_image(const benchmark::RunConfiguration& configuration) const {
+    std::error_code error;
+    std::filesystem::create_directories(*options.images_directory, error);
+    const auto image_path = *options.images_directory / fmt::format("offsets{}_{}x{}_rsm{}.ppm",
+                                                                     configuration.offsets_number, configuration.width,
+                                                                     configuration.height, configuration.rsm_resolution);
+
+    //  Binary PPM, top row first, alpha dropped
+    const auto pixels = headless_window->read_pixels();
+    std::ofstream stream(image_path, std::ios::binary | std::ios::trunc);
+    stream << fmt::format("P6\n{} {}\n255\n", configuration.width, configuration.height);
+    const auto row_size = static_cast<std::size_t>(configuration.width) * 4;
+    for (auto row = std::size_t{configuration.height}; row-- > 0;) {
+        for (auto column = std::size_t{0}; column < row_size; column += 4) {
+            stream.write(reinterpret_cast<const char*>(&pixels[row * row_size + column]), 3);
+        }
+    }
+    if (!stream) {
+        fmt::print("[BENCHMARK] Writing {} failed\n", image_path.string());
+        return {};
+    }
+    return image_path.string();
+}
@@ -0,0 +1,45 @@
+#ifndef BENCHMARK_APP_H
+#define BENCHMARK_APP_H
+
+#include "benchmark_options.h"
+#include "benchmark_report.h"
+#include "camera_path.h"
+
+#include "../application.h"
+#include "../engine/events/scene_events.h"
+#include "../engine/layers/box_layers/deferred_layer.h"
+#include "../engine/rendering/egl_headless_window.h"
+
+#include <optional>
+
+//  Renders the camera and light path headless, once per combination of the swept parameters, each time with a
+//  deferred layer of its own, and reports the CPU and GPU frame times of every run. Runs start once the scene
+//  and the light profile are loaded and the warm-up frames are done.
+class BenchmarkApp : public Application {
+public:
+    BenchmarkApp(benchmark::BenchmarkOptions&& benchmark_options, benchmark::CameraPath&& played_path);
+    virtual ~BenchmarkApp() override = default;
+
+    virtual void run() final override;
+
+    [[nodiscard]] int exit_status() const noexcept;
+
+private:
+    //  Gives up on a run whose assets have not loaded by then
+    static constexpr double loading_timeout_seconds = 120.0;
+
+    [[nodiscard]] static engine::WindowProperties window_properties_for(const benchmark::BenchmarkOptions& options);
+
+    [[nodiscard]] std::optional<benchmark::RunReport> measure(const benchmark::RunConfiguration& configuration);
+    void apply_keyframe(const benchmark::PathKeyframe& keyframe, engine::FlyCamera& camera,
+                        engine::DeferredLayer& layer);
+    [[nodiscard]] std::string write_image(const benchmark::RunConfiguration& configuration) const;
+
+    benchmark::BenchmarkOptions options;
+    benchmark::CameraPath path;
+    engine::EGL_Headless_Window* headless_window;
+    std::optional<benchmark::PathKeyframe> applied_keyframe;
+    int status = EXIT_SUCCESS;
+};
+
+#endif //BENCHMARK_APP_H
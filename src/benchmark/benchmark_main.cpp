@@ -0,0 +1,20 @@
+#include "benchmark_app.h"
+
+int main(int argc, char** argv) {
+    auto options = benchmark::parse_options(std::span<char* const>(argv, static_cast<std::size_t>(argc)));
+    if (!options) {
+        return EXIT_FAILURE;
+    }
+    auto path = options->camera_path ? benchmark::CameraPath::load_from(*options->camera_path)
+                                     : std::optional(benchmark::CameraPath::default_path());
+    if (!path) {
+        return EXIT_FAILURE;
+    }
+
+    BenchmarkApp benchmark_application(std::move(*options), std::move(*path));
+    benchmark_application.run();
+    if constexpr (profiling::enabled) {
+        profiling::write_chrome_trace("cpu_trace.json");
+    }
+    return benchmark_application.exit_status();
+}
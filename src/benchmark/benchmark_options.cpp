@@ -0,0 +1,146 @@
+#include "benchmark_options.h"
+
+#include <fmt/core.h>
+
+#include <charconv>
+#include <limits>
+
+namespace benchmark {
+    std::optional<BenchmarkOptions> parse_options(const std::span<char* const> arguments) {
+        const auto program_name = arguments.empty() ? std::string_view("cornell_box_benchmark")
+                                                    : std::string_view(arguments.front());
+        BenchmarkOptions options;
+        for (auto i = std::size_t{1}; i < arguments.size(); ++i) {
+            const auto option = std::string_view(arguments[i]);
+            if (option == "--help" || option == "-h") {
+                print_usage(program_name);
+                return std::nullopt;
+            }
+            if (i + 1 == arguments.size()) {
+                fmt::print("[BENCHMARK] {} needs a value\n", option);
+                return std::nullopt;
+            }
+            const auto value = std::string_view(arguments[++i]);
+
+            auto valid = true;
+            if (option == "--scene") {
+                options.scene_path = value;
+            } else if (option == "--ies") {
+                options.ies_path = value;
+            } else if (option == "--path") {
+                options.camera_path = std::filesystem::path(value);
+            } else if (option == "--output") {
+                options.output_path = std::filesystem::path(value);
+            } else if (option == "--images") {
+                options.images_directory = std::filesystem::path(value);
+            } else if (option == "--frames" || option == "--warmup") {
+                const auto count = impl_details::parse_unsigned(value);
+                valid = count.has_value() && (option == "--warmup" || count.value() > 0);
+                if (valid) {
+                    (option == "--frames" ? options.frames : options.warmup_frames) = count.value();
+                }
+            } else if (option == "--seed") {
+                const auto seed = impl_details::parse_unsigned(value);
+                valid = seed.has_value() && seed.value() <= std::numeric_limits<std::uint32_t>::max();
+                if (valid) {
+                    options.seed = static_cast<std::uint32_t>(seed.value());
+                }
+            } else if (option == "--offsets" || option == "--rsm-sizes") {
+                auto values = impl_details::parse_positive_list(value);
+                valid = values.has_value();
+                if (valid) {
+                    (option == "--offsets" ? options.offsets_numbers : options.rsm_resolutions) = std::move(*values);
+                }
+            } else if (option == "--resolutions") {
+                auto resolutions = impl_details::parse_resolution_list(value);
+                valid = resolutions.has_value();
+                if (valid) {
+                    options.resolutions = std::move(*resolutions);
+                }
+            } else {
+                fmt::print("[BENCHMARK] Unknown option {}\n", option);
+                print_usage(program_name);
+                return std::nullopt;
+            }
+
+            if (!valid) {
+                fmt::print("[BENCHMARK] {} is not a valid value for {}\n", value, option);
+                return std::nullopt;
+            }
+        }
+        return options;
+    }
+
+    void print_usage(const std::string_view program_name) {
+        fmt::print("Usage: {} [options]\n"
+                   "Renders a camera and light path headless for every combination of the swept parameters,\n"
+                   "and writes the CPU and per-pass GPU frame times of each run as JSON.\n"
+                   "  --scene PATH           scene to load (resources/cornell_box_multimaterial.obj)\n"
+                   "  --ies PATH             IES profile of the light (resources/ies/111621PN.IES)\n"
+                   "  --path PATH            camera and light keyframes, one per line (built-in path)\n"
+                   "  --frames N             frames measured per run, spread over the whole path (300)\n"
+                   "  --warmup N             frames rendered at the first keyframe before measuring (30)\n"
+                   "  --offsets N[,N...]     indirect lighting samples per fragment (400)\n"
+                   "  --resolutions WxH[,..] render target sizes (800x800)\n"
+                   "  --rsm-sizes N[,N...]   RSM resolutions per cube face (400)\n"
+                   "  --seed N               seed of every random sample set (1)\n"
+                   "  --output PATH          JSON report (benchmark.json)\n"
+                   "  --images DIR           also write the last frame of each run as PPM\n",
+                   program_name);
+    }
+}
+
+namespace benchmark::impl_details {
+    std::optional<std::uint64_t> parse_unsigned(const std::string_view text) {
+        auto value = std::uint64_t{0};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::optional<std::vector<int>> parse_positive_list(const std::string_view text) {
+        std::vector<int> values;
+        for (const auto field : split_on_commas(text)) {
+            const auto value = parse_unsigned(field);
+            if (!value.has_value() || value.value() == 0 ||
+                value.value() > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+                return std::nullopt;
+            }
+            values.push_back(static_cast<int>(value.value()));
+        }
+        return values;
+    }
+
+    std::optional<std::vector<glm::uvec2>> parse_resolution_list(const std::string_view text) {
+        std::vector<glm::uvec2> resolutions;
+        for (const auto field : split_on_commas(text)) {
+            const auto separator = field.find('x');
+            if (separator == std::string_view::npos) {
+                return std::nullopt;
+            }
+            const auto width = parse_unsigned(field.substr(0, separator));
+            const auto height = parse_unsigned(field.substr(separator + 1));
+            constexpr auto largest = std::uint64_t{16384};
+            if (!width.has_value() || !height.has_value() || width.value() == 0 || height.value() == 0 ||
+                width.value() > largest || height.value() > largest) {
+                return std::nullopt;
+            }
+            resolutions.emplace_back(static_cast<unsigned>(width.value()), static_cast<unsigned>(height.value()));
+        }
+        return resolutions;
+    }
+
+    std::vector<std::string_view> split_on_commas(std::string_view text) {
+        std::vector<std::string_view> fields;
+        while (true) {
+            const auto comma = text.find(',');
+            fields.push_back(text.substr(0, comma));
+            if (comma == std::string_view::npos) {
+                return fields;
+            }
+            text.remove_prefix(comma + 1);
+        }
+    }
+}
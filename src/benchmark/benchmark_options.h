@@ -0,0 +1,42 @@
+#ifndef BENCHMARK_OPTIONS_H
+#define BENCHMARK_OPTIONS_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace benchmark {
+    //  Every combination of offsets number, resolution and RSM resolution is one run
+    struct BenchmarkOptions {
+        std::string scene_path = "resources/cornell_box_multimaterial.obj";
+        std::string ies_path = "resources/ies/111621PN.IES";
+        std::optional<std::filesystem::path> camera_path;       //  The built-in path when empty
+        std::size_t frames = 300;
+        std::size_t warmup_frames = 30;
+        std::vector<int> offsets_numbers{400};
+        std::vector<glm::uvec2> resolutions{{800u, 800u}};
+        std::vector<int> rsm_resolutions{400};
+        std::uint32_t seed = 1;
+        std::filesystem::path output_path = "benchmark.json";
+        std::optional<std::filesystem::path> images_directory;  //  Last frame of each run, as PPM
+    };
+
+    //  std::nullopt after printing what is wrong, or the usage when it was asked for
+    [[nodiscard]] std::optional<BenchmarkOptions> parse_options(std::span<char* const> arguments);
+    void print_usage(std::string_view program_name);
+
+    namespace impl_details {
+        [[nodiscard]] std::optional<std::uint64_t> parse_unsigned(std::string_view text);
+        [[nodiscard]] std::optional<std::vector<int>> parse_positive_list(std::string_view text);
+        [[nodiscard]] std::optional<std::vector<glm::uvec2>> parse_resolution_list(std::string_view text);
+        [[nodiscard]] std::vector<std::string_view> split_on_commas(std::string_view text);
+    }
+}
+
+#endif //BENCHMARK_OPTIONS_H
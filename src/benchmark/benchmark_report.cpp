@@ -0,0 +1,110 @@
+#include "benchmark_report.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+namespace benchmark {
+    TimingSummary summarize(std::vector<float> times_ms) {
+        if (times_ms.empty()) {
+            return TimingSummary{};
+        }
+        std::sort(std::begin(times_ms), std::end(times_ms));
+        const auto total = std::accumulate(std::begin(times_ms), std::end(times_ms), 0.0);
+        return TimingSummary{times_ms.size(),
+                             static_cast<float>(total / static_cast<double>(times_ms.size())),
+                             times_ms.front(),
+                             impl_details::percentile(times_ms, 0.50f),
+                             impl_details::percentile(times_ms, 0.90f),
+                             impl_details::percentile(times_ms, 0.95f),
+                             impl_details::percentile(times_ms, 0.99f),
+                             times_ms.back()};
+    }
+
+    bool write_json_report(const std::filesystem::path& path, const BenchmarkReport& report) {
+        using impl_details::json_string;
+        using impl_details::json_summary;
+
+        std::ofstream stream(path, std::ios::trunc);
+        stream << "{\n";
+        stream << fmt::format("  \"renderer\": {},\n", json_string(report.renderer));
+        stream << fmt::format("  \"gl_version\": {},\n", json_string(report.gl_version));
+        stream << fmt::format("  \"scene\": {},\n", json_string(report.scene_path));
+        stream << fmt::format("  \"ies_profile\": {},\n", json_string(report.ies_path));
+        stream << fmt::format("  \"camera_path\": {},\n",
+                              report.camera_path.empty() ? "null" : json_string(report.camera_path));
+        stream << fmt::format("  \"seed\": {},\n", report.seed);
+        stream << fmt::format("  \"frames\": {},\n", report.frames);
+        stream << fmt::format("  \"warmup_frames\": {},\n", report.warmup_frames);
+        stream << "  \"runs\": [";
+        for (auto run = std::size_t{0}; run < report.runs.size(); ++run) {
+            const auto& [configuration, cpu_frame, gpu_frame, passes, image_path] = report.runs[run];
+            stream << (run == 0 ? "\n" : ",\n");
+            stream << "    {\n";
+            stream << fmt::format("      \"offsets_number\": {},\n", configuration.offsets_number);
+            stream << fmt::format("      \"width\": {},\n", configuration.width);
+            stream << fmt::format("      \"height\": {},\n", configuration.height);
+            stream << fmt::format("      \"rsm_resolution\": {},\n", configuration.rsm_resolution);
+            stream << fmt::format("      \"cpu_frame_ms\": {},\n", json_summary(cpu_frame));
+            stream << fmt::format("      \"gpu_frame_ms\": {},\n", json_summary(gpu_frame));
+            stream << "      \"passes\": [";
+            for (auto pass = std::size_t{0}; pass < passes.size(); ++pass) {
+                stream << (pass == 0 ? "\n" : ",\n");
+                stream << fmt::format("        {{\"name\": {}, \"gpu_ms\": {}}}", json_string(passes[pass].name),
+                                      json_summary(passes[pass].gpu));
+            }
+            stream << (passes.empty() ? "],\n" : "\n      ],\n");
+            stream << fmt::format("      \"image\": {}\n", image_path.empty() ? "null" : json_string(image_path));
+            stream << "    }";
+        }
+        stream << (report.runs.empty() ? "]\n" : "\n  ]\n");
+        stream << "}\n";
+
+        if (!stream) {
+            fmt::print("[BENCHMARK] Writing {} failed\n", path.string());
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace benchmark::impl_details {
+    float percentile(const std::vector<float>& sorted_times, const float fraction) {
+        const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<float>(sorted_times.size())));
+        return sorted_times[std::clamp<std::size_t>(rank, 1, sorted_times.size()) - 1];
+    }
+
+    std::string json_string(const std::string_view text) {
+        std::string quoted = "\"";
+        for (const auto character : text) {
+            switch (character) {
+                case '"':
+                    quoted += "\\\"";
+                    break;
+                case '\\':
+                    quoted += "\\\\";
+                    break;
+                case '\n':
+                    quoted += "\\n";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(character) < 0x20) {
+                        quoted += fmt::format("\\u{:04x}", static_cast<int>(character));
+                    } else {
+                        quoted += character;
+                    }
+            }
+        }
+        return quoted + '"';
+    }
+
+    std::string json_summary(const TimingSummary& summary) {
+        return fmt::format("{{\"samples\": {}, \"mean\": {:.4f}, \"min\": {:.4f}, \"p50\": {:.4f}, \"p90\": {:.4f}, "
+                           "\"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}}",
+                           summary.samples, summary.mean_ms, summary.min_ms, summary.p50_ms, summary.p90_ms,
+                           summary.p95_ms, summary.p99_ms, summary.max_ms);
+    }
+}
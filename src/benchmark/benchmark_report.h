@@ -0,0 +1,66 @@
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace benchmark {
+    //  In milliseconds; percentiles by nearest rank
+    struct TimingSummary {
+        std::size_t samples = 0;
+        float mean_ms = 0.0f;
+        float min_ms = 0.0f;
+        float p50_ms = 0.0f;
+        float p90_ms = 0.0f;
+        float p95_ms = 0.0f;
+        float p99_ms = 0.0f;
+        float max_ms = 0.0f;
+    };
+
+    [[nodiscard]] TimingSummary summarize(std::vector<float> times_ms);
+
+    struct RunConfiguration {
+        int offsets_number;
+        unsigned width;
+        unsigned height;
+        int rsm_resolution;
+    };
+
+    struct PassTimings {
+        std::string name;
+        TimingSummary gpu;
+    };
+
+    struct RunReport {
+        RunConfiguration configuration;
+        TimingSummary cpu_frame;
+        TimingSummary gpu_frame;        //  Sum of the timed passes
+        std::vector<PassTimings> passes;
+        std::string image_path;         //  Empty when no image was written
+    };
+
+    struct BenchmarkReport {
+        std::string renderer;
+        std::string gl_version;
+        std::string scene_path;
+        std::string ies_path;
+        std::string camera_path;        //  Empty for the built-in path
+        std::uint32_t seed;
+        std::size_t frames;
+        std::size_t warmup_frames;
+        std::vector<RunReport> runs;
+    };
+
+    bool write_json_report(const std::filesystem::path& path, const BenchmarkReport& report);
+
+    namespace impl_details {
+        [[nodiscard]] float percentile(const std::vector<float>& sorted_times, float fraction);
+        [[nodiscard]] std::string json_string(std::string_view text);
+        [[nodiscard]] std::string json_summary(const TimingSummary& summary);
+    }
+}
+
+#endif //BENCHMARK_REPORT_H
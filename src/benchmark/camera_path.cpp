@@ -0,0 +1,92 @@
+#include "camera_path.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace benchmark {
+    CameraPath::CameraPath(std::vector<PathKeyframe>&& path_keyframes) : keyframes(std::move(path_keyframes)) {
+        std::stable_sort(std::begin(keyframes), std::end(keyframes), [](const auto& first, const auto& second) {
+            return first.time < second.time;
+        });
+    }
+
+    std::optional<CameraPath> CameraPath::load_from(const std::filesystem::path& path) {
+        std::ifstream stream(path);
+        if (!stream) {
+            fmt::print("[CAMERA PATH] Cannot open {}\n", path.string());
+            return std::nullopt;
+        }
+
+        std::vector<PathKeyframe> keyframes;
+        std::string line;
+        for (auto line_number = 1u; std::getline(stream, line); ++line_number) {
+            const auto first_character = line.find_first_not_of(" \t\r");
+            if (first_character == std::string::npos || line[first_character] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            PathKeyframe keyframe{};
+            fields >> keyframe.time
+                   >> keyframe.camera_position.x >> keyframe.camera_position.y >> keyframe.camera_position.z
+                   >> keyframe.camera_yaw >> keyframe.camera_pitch
+                   >> keyframe.light_position.x >> keyframe.light_position.y >> keyframe.light_position.z
+                   >> keyframe.light_rotation.x >> keyframe.light_rotation.y >> keyframe.light_rotation.z;
+            if (!fields) {
+                fmt::print("[CAMERA PATH] {}:{} does not hold the 12 numbers of a keyframe\n", path.string(),
+                           line_number);
+                return std::nullopt;
+            }
+            keyframes.push_back(keyframe);
+        }
+        if (keyframes.empty()) {
+            fmt::print("[CAMERA PATH] {} has no keyframes\n", path.string());
+            return std::nullopt;
+        }
+        return CameraPath(std::move(keyframes));
+    }
+
+    CameraPath CameraPath::default_path() {
+        //  The first keyframe is where BoxApp starts the camera, and where the deferred layer puts the light
+        return CameraPath({
+                PathKeyframe{0.0f, {1.5f, 1.5f, -5.0f}, 0.0f, 0.0f, {1.5f, 2.6f, 1.5f}, {90.0f, 0.0f, 0.0f}},
+                PathKeyframe{1.0f, {-0.5f, 1.5f, -4.5f}, 18.4f, 0.0f, {0.8f, 2.6f, 1.0f}, {90.0f, 0.0f, 0.0f}},
+                PathKeyframe{2.0f, {1.5f, 2.2f, -3.0f}, 0.0f, -8.8f, {1.5f, 2.6f, 0.6f}, {90.0f, 0.0f, 30.0f}},
+                PathKeyframe{3.0f, {3.5f, 1.5f, -4.5f}, -18.4f, 0.0f, {2.2f, 2.6f, 1.0f}, {90.0f, 0.0f, 0.0f}},
+                PathKeyframe{4.0f, {1.5f, 1.5f, -5.0f}, 0.0f, 0.0f, {1.5f, 2.6f, 1.5f}, {90.0f, 0.0f, 0.0f}}});
+    }
+
+    PathKeyframe CameraPath::at(const float progress) const {
+        if (keyframes.size() == 1) {
+            return keyframes.front();
+        }
+        const auto start = keyframes.front().time;
+        const auto time = start + std::clamp(progress, 0.0f, 1.0f) * (keyframes.back().time - start);
+        const auto next = std::upper_bound(std::begin(keyframes) + 1, std::end(keyframes) - 1, time,
+                                           [](const float value, const auto& keyframe) {
+                                               return value < keyframe.time;
+                                           });
+        const auto& previous = *(next - 1);
+        const auto span = next->time - previous.time;
+        const auto weight = span > 0.0f ? (time - previous.time) / span : 1.0f;
+        return impl_details::interpolate(previous, *next, std::clamp(weight, 0.0f, 1.0f));
+    }
+
+    std::size_t CameraPath::keyframes_count() const {
+        return keyframes.size();
+    }
+}
+
+namespace benchmark::impl_details {
+    PathKeyframe interpolate(const PathKeyframe& from, const PathKeyframe& to, const float weight) {
+        return PathKeyframe{glm::mix(from.time, to.time, weight),
+                            glm::mix(from.camera_position, to.camera_position, weight),
+                            glm::mix(from.camera_yaw, to.camera_yaw, weight),
+                            glm::mix(from.camera_pitch, to.camera_pitch, weight),
+                            glm::mix(from.light_position, to.light_position, weight),
+                            glm::mix(from.light_rotation, to.light_rotation, weight)};
+    }
+}
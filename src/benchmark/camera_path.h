@@ -0,0 +1,47 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <glm/glm.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace benchmark {
+    //  What a FlyCamera and a Point_Light are set to at one point of the path; angles in degrees
+    struct PathKeyframe {
+        float time;
+        glm::vec3 camera_position;
+        float camera_yaw;
+        float camera_pitch;
+        glm::vec3 light_position;
+        glm::vec3 light_rotation;
+    };
+
+    //  Keyframes sorted by time, interpolated linearly; a benchmark stretches the path over however many
+    //  frames it renders, so the same path gives the same images whatever the frame rate.
+    //  In a file, every line is one keyframe of 12 numbers:
+    //      time  camera_x camera_y camera_z  camera_yaw camera_pitch  light_x light_y light_z  light_rx light_ry light_rz
+    //  Empty lines and lines starting with # are skipped.
+    class CameraPath {
+    public:
+        explicit CameraPath(std::vector<PathKeyframe>&& path_keyframes);
+
+        [[nodiscard]] static std::optional<CameraPath> load_from(const std::filesystem::path& path);
+        //  A sweep in front of the open side of the Cornell box, with the light moving across the ceiling
+        [[nodiscard]] static CameraPath default_path();
+
+        //  progress in [0, 1], from the first keyframe to the last
+        [[nodiscard]] PathKeyframe at(float progress) const;
+        [[nodiscard]] std::size_t keyframes_count() const;
+
+    private:
+        std::vector<PathKeyframe> keyframes;
+    };
+
+    namespace impl_details {
+        [[nodiscard]] PathKeyframe interpolate(const PathKeyframe& from, const PathKeyframe& to, float weight);
+    }
+}
+
+#endif //CAMERA_PATH_H
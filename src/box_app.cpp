@@ -21,7 +21,7 @@ BoxApp::BoxApp() : Application("Cornell Box App")
 
     layers.push_layer(DeferredLayer::create_using(ptr_to_camera, [this](auto ptr_to_queue) {
         push_event(std::move(ptr_to_queue));
-    }));
+    }, main_window->create_shared_context()));
 
 //    layers.push_layer(SceneLayer::create_using(ptr_to_camera, [this](auto ptr_to_queue) {
 //        push_event(std::move(ptr_to_queue));
@@ -48,27 +48,38 @@ void BoxApp::on_event(engine::Event &event)
 
 void BoxApp::run()
 {
+    PROFILE_THREAD("Main thread");
     while (running)
     {
-        auto time = static_cast<float>(glfwGetTime());
+        PROFILE_ZONE("Frame");
+        engine::OpenGL3_Renderer::begin_frame();
+        auto time = static_cast<float>(main_window->get_time());
         float delta_time = time - last_frame_time;
         last_frame_time = time;
-        while(!received_events.empty()){
-            on_event(*received_events.front());
-            received_events.pop();
+        {
+            PROFILE_ZONE("Event dispatch");
+            while(!received_events.empty()){
+                on_event(*received_events.front());
+                received_events.pop();
+            }
         }
 
         for (auto &layer : layers){
+            PROFILE_ZONE("Layer update");
             layer->update(delta_time);
         }
-        imgui->update(delta_time);
+        {
+            PROFILE_ZONE("ImGui");
+            imgui->update(delta_time);
 
-        imgui->begin();
-        for (auto &layer : layers){
-            layer->on_imgui_render();
+            imgui->begin();
+            for (auto &layer : layers){
+                layer->on_imgui_render();
+            }
+            imgui->end();
         }
-        imgui->end();
 
+        PROFILE_ZONE("Swap buffers");
         main_window->on_update();
     }
 }
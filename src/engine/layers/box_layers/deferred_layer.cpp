@@ -1,11 +1,23 @@
 #include "deferred_layer.h"
 
+#include <cassert>
+
 namespace engine {
-    DeferredLayer::DeferredLayer(std::weak_ptr<FlyCamera> controlled_camera, [[maybe_unused]] LayerCreationKey key)
-            : camera(std::move(controlled_camera)) {}
+    DeferredLayer::DeferredLayer(std::weak_ptr<FlyCamera> controlled_camera, DeferredLayerSettings layer_settings,
+                                 [[maybe_unused]] LayerCreationKey key)
+            : camera(std::move(controlled_camera)), settings(std::move(layer_settings)),
+              offsets_number{settings.offsets_number} {}
 
     void DeferredLayer::on_attach() {
-        objects = default_load_scene("resources/cornell_box_multimaterial.obj");
+        geometry_pool = std::make_shared<GeometryPool>(VertexBufferLayout({
+                                                               VertexBufferElement(ShaderDataType::Float3,
+                                                                                   "position"),
+                                                               VertexBufferElement(ShaderDataType::Float3,
+                                                                                   "normal")}),
+                                                       1u << 16, 1u << 18);
+        //  Decoded on the workers while the rest of the layer is set up, uploaded by update() from the first frame
+        stream_scene(settings.scene_path);
+        stream_IES_light(files::make_path_absolute(std::string(settings.ies_path)));
 
         light = Point_Light(glm::vec4(1.5f, 2.6f, 1.5f, 1.0f),
                             LightAttenuationParameters{1.0f, 0.5f, 1.8f});
@@ -15,7 +27,9 @@ namespace engine {
         glGetFloatv(GL_VIEWPORT, viewport_size.get());
         std::transform(&viewport_size[2], &viewport_size[4], glm::value_ptr(target_resolution),
                        [](const auto f) { return static_cast<int>(f); });
-        texture_resolution = glm::vec2{target_resolution[0] / 2, target_resolution[1] / 2};
+        texture_resolution = settings.rsm_resolution > 0
+                             ? glm::vec<2, int>{settings.rsm_resolution, settings.rsm_resolution}
+                             : glm::vec<2, int>{target_resolution[0] / 2, target_resolution[1] / 2};
 
         std::array<GLenum, 3> color_attachments{GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
 
@@ -36,34 +50,37 @@ namespace engine {
         direct_pass_setup();
         indirect_pass_setup();
 
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+        OpenGL3_Renderer::enable(GL_DEPTH_TEST);
+        OpenGL3_Renderer::enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
         glDepthMask(GL_TRUE);
-        glEnable(GL_BLEND);
-        glBlendEquation(GL_FUNC_ADD);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-
-        gbuffer_creation = shader::create_shader_from("resources/shaders/deferred/gbuffer_creation.vert",
-                                                      "resources/shaders/deferred/gbuffer_creation.frag");
-        wireframe_drawer = shader::create_shader_from("resources/shaders/deferred/gbuffer_creation.vert",
-                                                      "resources/shaders/deferred/wireframe_to_gbuffer.frag");
-        quad_render = shader::create_shader_from("resources/shaders/deferred/quad_rendering.vert",
-                                                 "resources/shaders/deferred/quad_rendering.frag");
-        deferred_direct = shader::create_shader_from("resources/shaders/deferred/quad_rendering.vert",
-                                                     "resources/shaders/deferred/deferred_direct.frag");
-        rsm_creation = shader::create_shader_from("resources/shaders/deferred/rsm_creation.vert",
-                                                  "resources/shaders/deferred/rsm_creation.frag",
-                                                  "resources/shaders/deferred/rsm_creation.geom");
-        mask_creation = shader::create_shader_from("resources/shaders/deferred/rsm_creation.vert",
-                                                   "resources/shaders/deferred/ies_mask_creation.frag",
-                                                   "resources/shaders/deferred/rsm_creation.geom");
-        deferred_indirect = shader::create_shader_from("resources/shaders/deferred/quad_rendering.vert",
-                                                       "resources/shaders/deferred/deferred_indirect.frag");
-
-        const auto path_to_IES_data = files::make_path_absolute("resources/ies/111621PN.IES");
-        load_IES_light_as_VAO(path_to_IES_data);
+        OpenGL3_Renderer::enable(GL_BLEND);
+        OpenGL3_Renderer::set_blend_equation(GL_FUNC_ADD);
+        OpenGL3_Renderer::set_blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        OpenGL3_Renderer::enable(GL_CULL_FACE);
+        OpenGL3_Renderer::set_cull_face(GL_BACK);
+
+        shader_library = std::make_unique<ShaderLibrary>();
+        gbuffer_creation = shader_library->program("resources/shaders/deferred/gbuffer_creation.vert",
+                                                   "resources/shaders/deferred/gbuffer_creation.frag");
+        wireframe_drawer = shader_library->program("resources/shaders/deferred/gbuffer_creation.vert",
+                                                   "resources/shaders/deferred/wireframe_to_gbuffer.frag");
+        quad_render = shader_library->program("resources/shaders/deferred/quad_rendering.vert",
+                                              "resources/shaders/deferred/quad_rendering.frag");
+        mask_creation = shader_library->program("resources/shaders/deferred/rsm_creation.vert",
+                                                "resources/shaders/deferred/ies_mask_creation.frag",
+                                                "resources/shaders/deferred/rsm_creation.geom");
+        if (SceneDrawBatch::is_supported()) {
+            gbuffer_creation_indirect = shader_library->program("resources/shaders/deferred/gbuffer_creation_indirect.vert",
+                                                                "resources/shaders/deferred/gbuffer_creation.frag");
+            occlusion_culler = std::make_unique<OcclusionCuller>(
+                    shader_library->compute_program("resources/shaders/deferred/hiz_depth_pyramid.comp"),
+                    shader_library->compute_program("resources/shaders/deferred/occlusion_culling.comp"),
+                    target_resolution[0], target_resolution[1]);
+        }
+        ies_mesh_generator = std::make_unique<IES_Mesh_Generator>(
+                shader_library->compute_program("resources/shaders/deferred/ies_mesh_generation.comp"));
+        select_shader_variants();
+        verify_uniform_block_layouts();
         uniform_buffers_setup();
     }
 
@@ -85,169 +102,461 @@ namespace engine {
 
     void DeferredLayer::update(float delta_time) {
         [[maybe_unused]] float timestep = delta_time;
+        asset_jobs.run_uploads(std::chrono::microseconds(static_cast<long long>(upload_budget_ms * 1000.0f)));
+        if (upload_thread) {
+            upload_thread->poll_completed();
+        }
         if (auto view_camera = camera.lock()) {
+            gpu_profiler.begin_frame();
 
-            glBlendEquation(GL_FUNC_ADD);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glEnable(GL_DEPTH_TEST);
+            OpenGL3_Renderer::set_blend_equation(GL_FUNC_ADD);
+            OpenGL3_Renderer::set_blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            OpenGL3_Renderer::enable(GL_DEPTH_TEST);
 
+            object_uniforms->begin_frame();
             if (scene_changed) {
                 update_camera_related_buffers();
+                write_object_uniforms();
                 update_scene_buffers_and_representations();
+                gpu_profiler.begin_pass("G-buffer");
                 create_gbuffer();
+                gpu_profiler.end_pass();
                 //  conditionally, draw_wireframe()
-                if (draw_wireframe_in_scene){
+                if (draw_wireframe_in_scene && light_profile_loaded){
+                    gpu_profiler.begin_pass("Photometric solid wireframe");
                     gbuffer_creation_fbo->bind_as(GL_FRAMEBUFFER);
-                    glViewport(0, 0, target_resolution[0], target_resolution[1]);
+                    OpenGL3_Renderer::set_viewport(0, 0, target_resolution[0], target_resolution[1]);
                     wireframe_drawer->use();
                     gbuffer_diffuse_texture->bind_to_slot(2);
-                    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                    OpenGL3_Renderer::set_polygon_mode(GL_LINE);
+                    gbuffer_matrices.model = ies_model_matrix;
+                    gbuffer_matrices.transposed_inversed_model = ies_inverse_transposed_matrix;
                     gbuffer_transformation->bind_to_uniform_buffer_target();
-                    gbuffer_transformation->copy_to_buffer(64, 4 * 4 * 4, glm::value_ptr(ies_model_matrix));
-                    gbuffer_transformation->copy_to_buffer(128, 4 * 4 * 4, glm::value_ptr(ies_inverse_transposed_matrix));
+                    gbuffer_transformation->copy_to_buffer(0, sizeof(gbuffer_matrices), &gbuffer_matrices);
                     gbuffer_transformation->unbind_from_uniform_buffer_target();
+                    const auto wireframe_material = MaterialPropertiesBlock{wireframe_color, 0.0f, {}};
                     material_buffer->bind_to_uniform_buffer_target();
-                    material_buffer->copy_to_buffer(0, 16, glm::value_ptr(wireframe_color));
+                    material_buffer->copy_to_buffer(0, sizeof(wireframe_material), &wireframe_material);
                     material_buffer->unbind_from_uniform_buffer_target();
-                    OpenGL3_Renderer::draw(ies_light_vao);
-                    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                    displayed_lod_level = select_displayed_lod_level();
+                    OpenGL3_Renderer::draw(photometric_solid_at(displayed_lod_level));
+                    OpenGL3_Renderer::set_polygon_mode(GL_FILL);
                     gbuffer_creation_fbo->unbind_from(GL_FRAMEBUFFER);
+                    gpu_profiler.end_pass();
                 }
                 scene_changed = false;
                 camera_moved = false;
             } else if (camera_moved) {
                 update_camera_related_buffers();
+                write_object_uniforms();
+                gpu_profiler.begin_pass("G-buffer");
                 create_gbuffer();
-                if (draw_wireframe_in_scene){
+                gpu_profiler.end_pass();
+                if (draw_wireframe_in_scene && light_profile_loaded){
+                    gpu_profiler.begin_pass("Photometric solid wireframe");
                     gbuffer_creation_fbo->bind_as(GL_FRAMEBUFFER);
-                    glViewport(0, 0, target_resolution[0], target_resolution[1]);
+                    OpenGL3_Renderer::set_viewport(0, 0, target_resolution[0], target_resolution[1]);
                     wireframe_drawer->use();
                     gbuffer_diffuse_texture->bind_to_slot(2);
-                    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                    OpenGL3_Renderer::set_polygon_mode(GL_LINE);
+                    gbuffer_matrices.model = ies_model_matrix;
+                    gbuffer_matrices.transposed_inversed_model = ies_inverse_transposed_matrix;
                     gbuffer_transformation->bind_to_uniform_buffer_target();
-                    gbuffer_transformation->copy_to_buffer(64, 4 * 4 * 4, glm::value_ptr(ies_model_matrix));
-                    gbuffer_transformation->copy_to_buffer(128, 4 * 4 * 4, glm::value_ptr(ies_inverse_transposed_matrix));
+                    gbuffer_transformation->copy_to_buffer(0, sizeof(gbuffer_matrices), &gbuffer_matrices);
                     gbuffer_transformation->unbind_from_uniform_buffer_target();
+                    const auto wireframe_material = MaterialPropertiesBlock{wireframe_color, 0.0f, {}};
                     material_buffer->bind_to_uniform_buffer_target();
-                    material_buffer->copy_to_buffer(0, 16, glm::value_ptr(wireframe_color));
+                    material_buffer->copy_to_buffer(0, sizeof(wireframe_material), &wireframe_material);
                     material_buffer->unbind_from_uniform_buffer_target();
-                    OpenGL3_Renderer::draw(ies_light_vao);
-                    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                    displayed_lod_level = select_displayed_lod_level();
+                    OpenGL3_Renderer::draw(photometric_solid_at(displayed_lod_level));
+                    OpenGL3_Renderer::set_polygon_mode(GL_FILL);
                     gbuffer_creation_fbo->unbind_from(GL_FRAMEBUFFER);
+                    gpu_profiler.end_pass();
                 }
                 camera_moved = false;
             }
 
+            gpu_profiler.begin_pass("Direct lighting");
             render_direct_lighting();
+            gpu_profiler.begin_pass("Indirect lighting");
             render_indirect_lighting();
+            gpu_profiler.end_pass();
 
-            glBlendEquation(GL_FUNC_ADD);
-            glBlendFunc(GL_ONE, GL_ONE);
-            glDisable(GL_DEPTH_TEST);
+            OpenGL3_Renderer::set_blend_equation(GL_FUNC_ADD);
+            OpenGL3_Renderer::set_blend_function(GL_ONE, GL_ONE);
+            OpenGL3_Renderer::disable(GL_DEPTH_TEST);
 
-            glEnable(GL_FRAMEBUFFER_SRGB);
+            OpenGL3_Renderer::enable(GL_FRAMEBUFFER_SRGB);
+            gpu_profiler.begin_pass("Composite");
             sum_lighting_components();
-            glDisable(GL_FRAMEBUFFER_SRGB);
+            gpu_profiler.end_pass();
+            OpenGL3_Renderer::disable(GL_FRAMEBUFFER_SRGB);
+            object_uniforms->end_frame();
+            gpu_profiler.end_frame();
+        }
+    }
+
+    void DeferredLayer::place_light(const glm::vec4& position, const glm::vec3& rotation_in_degrees) {
+        light.translate_to(position);
+        light.set_rotation(rotation_in_degrees);
+        event_pump(std::make_unique<SceneChangedEvent>());
+    }
+
+    void DeferredLayer::set_object_transform(const std::size_t object_index, const glm::mat4& transform) {
+        if (object_index >= objects.size()) {
+            return;
         }
+        auto& o = objects[object_index];
+        o.transform = transform;
+        o.transpose_inverse_transform = glm::transpose(glm::inverse(transform));
+        object_transforms_changed = true;
+        event_pump(std::make_unique<SceneChangedEvent>());
+    }
+
+    bool DeferredLayer::assets_loaded() const {
+        return light_profile_loaded && !scene_streaming && asset_jobs.jobs_in_flight() == 0;
+    }
+
+    OpenGL3_GPU_Profiler& DeferredLayer::pass_profiler() {
+        return gpu_profiler;
     }
 
     void DeferredLayer::create_gbuffer() {
         gbuffer_creation_fbo->bind_as(GL_FRAMEBUFFER);
-        glViewport(0, 0, target_resolution[0], target_resolution[1]);
+        OpenGL3_Renderer::set_viewport(0, 0, target_resolution[0], target_resolution[1]);
         OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
         OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        gbuffer_creation->use();
+        const auto& gbuffer_shader = use_indirect_scene_draws ? gbuffer_creation_indirect : gbuffer_creation;
+        gbuffer_shader->use();
 
         gbuffer_positions_texture->bind_to_slot(0);
         gbuffer_normals_texture->bind_to_slot(1);
         gbuffer_diffuse_texture->bind_to_slot(2);
 
+        if (use_indirect_scene_draws && occlusion_culling) {
+            //  What was visible last time lays down the depth the rest of the scene is tested against
+            occlusion_culler->draw_visible_last_frame(*scene_batch);
+            occlusion_culler->cull_against(*gbuffer_depth_texture, gbuffer_matrices.projection_view);
+            gbuffer_shader->use();
+            occlusion_culler->draw_newly_visible(*scene_batch);
+        } else {
+            cull_for_camera();
+            draw_scene_objects(RenderPass::GBuffer, *gbuffer_shader, camera.lock()->position(),
+                               front_to_back_gbuffer ? DrawOrder::Front_To_Back : DrawOrder::State_Changes_First);
+        }
+        gbuffer_creation_fbo->unbind_from(GL_FRAMEBUFFER);
+    }
+
+    void DeferredLayer::write_object_uniforms() {
+        if (use_indirect_scene_draws) {
+            //  The batch keeps its own per-object storage buffer
+            return;
+        }
+        const auto view_camera = camera.lock();
+        const auto projection_view_matrix = view_camera->projection_matrix() * view_camera->view_matrix();
+
+        //  One record per distinct material: draws sorted by material then bind the same range back to back,
+        //  which the state cache elides
+        std::vector<int> material_offsets(materials_count, -1);
+        object_uniform_ranges.clear();
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            const auto& o = objects[i];
+            auto& material_offset = material_offsets[object_material_ids[i]];
+            if (material_offset < 0) {
+                material_offset = object_uniforms->allocate(sizeof(MaterialPropertiesBlock));
+                if (material_offset < 0) {
+                    break;
+                }
+                const auto material = MaterialPropertiesBlock{o.material.data.diffuse_color,
+                                                              o.material.data.shininess, {}};
+                object_uniforms->copy_to_buffer(material_offset, sizeof(material), &material);
+            }
+            const auto ranges = ObjectUniformRanges{object_uniforms->allocate(sizeof(GBufferMatricesBlock)),
+                                                    material_offset};
+            if (ranges.transformations < 0) {
+                break;
+            }
+            const auto matrices = GBufferMatricesBlock{projection_view_matrix, o.transform,
+                                                       o.transpose_inverse_transform};
+            object_uniforms->copy_to_buffer(ranges.transformations, sizeof(matrices), &matrices);
+            object_uniform_ranges.push_back(ranges);
+        }
+        object_uniforms->commit_writes();
+        //  allocate_object_uniforms sizes the region for every object and material, running out is a bug
+        assert(object_uniform_ranges.size() == objects.size() && "object uniforms outgrew their frame region");
+        if (object_uniform_ranges.size() != objects.size()) {
+            object_uniform_ranges.clear();
+        }
+    }
+
+    void DeferredLayer::assign_material_ids() {
+        std::unordered_map<std::string, unsigned int> ids_by_name;
+        object_material_ids.clear();
         for (const auto& o : objects) {
-            const auto& model_matrix = o.transform;
-            const auto& transposed_inversed_model_matrix = o.transpose_inverse_transform;
-            gbuffer_transformation->bind_to_uniform_buffer_target();
-            gbuffer_transformation->copy_to_buffer(64, 64, glm::value_ptr(model_matrix));
-            gbuffer_transformation->copy_to_buffer(128, 64, glm::value_ptr(transposed_inversed_model_matrix));
-            gbuffer_transformation->unbind_from_uniform_buffer_target();
-            material_buffer->bind_to_uniform_buffer_target();
-            material_buffer->copy_to_buffer(0, 16, glm::value_ptr(o.material.data.diffuse_color));
-            material_buffer->copy_to_buffer(16, 4, &o.material.data.shininess);
-            material_buffer->unbind_from_uniform_buffer_target();
-            OpenGL3_Renderer::draw(*(o.vao));
+            const auto [id, inserted] = ids_by_name.try_emplace(o.material.name,
+                                                                static_cast<unsigned int>(ids_by_name.size()));
+            object_material_ids.push_back(id->second);
+        }
+        materials_count = static_cast<unsigned int>(ids_by_name.size());
+    }
+
+    std::vector<AABB> DeferredLayer::scene_world_bounds() const {
+        std::vector<AABB> bounds(objects.size());
+        std::transform(std::begin(objects), std::end(objects), std::begin(bounds),
+                       [](const SceneObject& o) { return o.world_bounds(); });
+        return bounds;
+    }
+
+    void DeferredLayer::cull_for_camera() {
+        const auto view_camera = camera.lock();
+        scene_bvh.cull(Frustum(view_camera->projection_matrix() * view_camera->view_matrix()), camera_visible_objects);
+        culling_statistics.camera_visible = static_cast<unsigned int>(camera_visible_objects.size());
+        culling_statistics.camera_culled = static_cast<unsigned int>(objects.size() - camera_visible_objects.size());
+    }
+
+    void DeferredLayer::cull_for_light_faces(const std::vector<glm::mat4>& light_transformations) {
+        std::vector<Frustum> faces(std::begin(light_transformations), std::end(light_transformations));
+        scene_bvh.cull_faces(faces, rsm_culled_faces);
+        culling_statistics.faces_culled = 0;
+        for (const auto mask : rsm_culled_faces) {
+            culling_statistics.faces_culled += static_cast<unsigned int>(std::popcount(mask));
         }
+        culling_statistics.face_draws = static_cast<unsigned int>(objects.size() * faces.size()) -
+                                        culling_statistics.faces_culled;
+    }
+
+    void DeferredLayer::select_light_space_lods(const glm::vec3& light_position) {
+        //  A cube face spans 90 degrees: at distance d from the light, a texel at the center of a face covers
+        //  2d / resolution, and texels away from the center cover more
+        const auto texel_size_per_distance = 2.0f / static_cast<float>(texture_resolution[0]);
+        light_space_lods.assign(objects.size(), 0);
+        culling_statistics.rsm_triangles = 0;
+        culling_statistics.rsm_full_detail_triangles = 0;
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            const auto& o = objects[i];
+            const auto bounds = o.world_bounds();
+            const auto distance = glm::distance(light_position, glm::clamp(light_position, bounds.min, bounds.max));
+            const auto max_world_error = light_space_max_error * texel_size_per_distance * distance;
+
+            auto level = std::size_t{0};
+            while (level + 1 < o.lod_levels() && o.lod_world_error(level + 1) <= max_world_error) {
+                ++level;
+            }
+            light_space_lods[i] = static_cast<std::uint8_t>(level);
+            culling_statistics.rsm_triangles += o.lod_range(level).index_count / 3;
+            culling_statistics.rsm_full_detail_triangles += o.geometry_range().index_count / 3;
+        }
+    }
+
+    void DeferredLayer::draw_scene_objects(const RenderPass pass, const Shader& shader, const glm::vec3& eye_position,
+                                           const DrawOrder order) {
+        if (use_indirect_scene_draws) {
+            scene_batch->draw();
+            return;
+        }
+        if (objects.empty() || object_uniform_ranges.size() != objects.size()) {
+            return;
+        }
+
+        //  Imported objects keep identity transforms with their vertices already in world space, so the depth
+        //  is taken at the center of the world bounds; the light pass renders every cube face at once, so there
+        //  it is the radial distance rather than a view-space depth
+        const auto view_matrix = camera.lock()->view_matrix();
+        std::vector<float> distances(objects.size());
+        std::transform(std::begin(objects), std::end(objects), std::begin(distances), [&](const SceneObject& o) {
+            const auto center = o.world_bounds().center();
+            if (pass == RenderPass::RSM) {
+                return glm::distance(eye_position, center);
+            }
+            return std::max(-(view_matrix * glm::vec4(center, 1.0f)).z, 0.0f);
+        });
+        const auto furthest = std::max(*std::max_element(std::begin(distances), std::end(distances)), 1.0e-6f);
+
+        scene_queue.clear();
+        const auto queue_object = [&](const std::uint32_t i) {
+            scene_queue.push(make_sort_key(pass, shader.id, object_material_ids[i], objects[i].vertex_array().get_id(),
+                                           distances[i] / furthest, order), i);
+        };
+        if (frustum_culling && pass == RenderPass::GBuffer) {
+            std::for_each(std::begin(camera_visible_objects), std::end(camera_visible_objects), queue_object);
+        } else {
+            for (std::uint32_t i = 0; i < objects.size(); ++i) {
+                if (!frustum_culling || pass != RenderPass::RSM || rsm_culled_faces[i] != SceneBVH::all_faces_culled) {
+                    queue_object(i);
+                }
+            }
+        }
+        scene_queue.sort();
+
+        for (const auto& packet : scene_queue.packets()) {
+            const auto i = packet.payload;
+            if (pass == RenderPass::RSM) {
+                shader.set(rsm_culled_faces_mask, frustum_culling ? static_cast<unsigned int>(rsm_culled_faces[i]) : 0u);
+            }
+            object_uniforms->bind_range_to_binding_point(0, object_uniform_ranges[i].transformations,
+                                                         sizeof(GBufferMatricesBlock));
+            object_uniforms->bind_range_to_binding_point(1, object_uniform_ranges[i].material,
+                                                         sizeof(MaterialPropertiesBlock));
+            const auto range = pass == RenderPass::RSM ? objects[i].lod_range(light_space_lods[i])
+                                                       : objects[i].geometry_range();
+            OpenGL3_Renderer::draw(objects[i].vertex_array(), range);
+        }
+        //  The wireframe and light-mask passes still go through the whole-buffer bindings
+        gbuffer_transformation->bind_to_binding_point(0);
+        material_buffer->bind_to_binding_point(1);
+    }
+
+    void DeferredLayer::stream_scene(const std::string& path_to_scene) {
+        scene_streaming = true;
+        asset_jobs.submit([this, path_to_scene]() -> jobs::UploadStep {
+            std::shared_ptr<std::vector<scenes::MeshData>> meshes;
+            try {
+                meshes = std::make_shared<std::vector<scenes::MeshData>>(default_load_scene_meshes(path_to_scene));
+            } catch (const std::exception& error) {
+                //  Dropping the job would leave the flag set, and with it reload_scene() blocked for good
+                return [this, path_to_scene, message = std::string(error.what())]() {
+                    fmt::print("[DEFERRED LAYER] Loading {} failed, the scene is left as it is: {}\n",
+                               path_to_scene, message);
+                    scene_streaming = false;
+                    return true;
+                };
+            }
+            auto uploaded = std::make_shared<std::vector<SceneObject>>();
+            uploaded->reserve(meshes->size());
+            //  One mesh per step; the scene on screen is only replaced once all of them are on the GPU
+            return [this, meshes, uploaded]() {
+                if (upload_thread) {
+                    stage_scene(meshes);
+                    return true;
+                }
+                if (uploaded->size() < meshes->size()) {
+                    uploaded->push_back(scenes::upload_mesh((*meshes)[uploaded->size()], geometry_pool));
+                    return false;
+                }
+                replace_scene(std::move(*uploaded));
+                return true;
+            };
+        });
+    }
+
+    void DeferredLayer::stage_scene(std::shared_ptr<const std::vector<scenes::MeshData>> meshes) {
+        if (meshes->empty()) {
+            replace_scene({});
+            return;
+        }
+        //  Staged buffers come back in submission order, so the objects keep the order of the meshes
+        auto uploaded = std::make_shared<std::vector<SceneObject>>();
+        uploaded->reserve(meshes->size());
+        for (std::size_t i = 0; i < meshes->size(); ++i) {
+            upload_thread->stage(scenes::staged_size_of((*meshes)[i]),
+                                 [meshes, i](std::byte* destination) {
+                                     scenes::write_staged_mesh((*meshes)[i], destination);
+                                 },
+                                 [this, meshes, uploaded, i](const StagingBuffer& staged) {
+                                     uploaded->push_back(scenes::upload_staged_mesh((*meshes)[i], staged,
+                                                                                    geometry_pool));
+                                     if (uploaded->size() == meshes->size()) {
+                                         replace_scene(std::move(*uploaded));
+                                     }
+                                 });
+        }
+    }
+
+    void DeferredLayer::replace_scene(std::vector<SceneObject>&& streamed_objects) {
+        scene_batch.reset();
+        objects = std::move(streamed_objects);
+        object_transforms_changed = false;
+        assign_material_ids();
+        scene_bvh.build(scene_world_bounds());
+        allocate_object_uniforms();
+        if (SceneDrawBatch::is_supported()) {
+            scene_batch = std::make_unique<SceneDrawBatch>(objects);
+            occlusion_culler->reset(*scene_batch, scene_world_bounds());
+        }
+        scene_streaming = false;
+        event_pump(std::make_unique<SceneChangedEvent>());
+    }
+
+    void DeferredLayer::reload_scene() {
+        //  The old scene stays on screen, and in the pool, until the new one is uploaded
+        if (!scene_streaming) {
+            stream_scene(settings.scene_path);
+        }
+    }
+
+    void DeferredLayer::run_draw_submission_benchmark() {
+        const auto view_camera = camera.lock();
+        gbuffer_creation_fbo->bind_as(GL_FRAMEBUFFER);
+        OpenGL3_Renderer::set_viewport(0, 0, target_resolution[0], target_resolution[1]);
+        draw_submission_timings = benchmark_draw_submission(*gbuffer_creation, *gbuffer_creation_indirect,
+                                                            view_camera->projection_matrix() * view_camera->view_matrix());
         gbuffer_creation_fbo->unbind_from(GL_FRAMEBUFFER);
+        gbuffer_transformation->bind_to_binding_point(0);
+        material_buffer->bind_to_binding_point(1);
+        event_pump(std::make_unique<SceneChangedEvent>());
     }
 
     void DeferredLayer::update_light_mask(const std::vector<glm::mat4>& light_transforms) {
         mask_creation_fbo->bind_as(GL_FRAMEBUFFER);
-        glViewport(0, 0, texture_resolution[0], texture_resolution[1]);
-        glCullFace(GL_FRONT);
+        OpenGL3_Renderer::set_viewport(0, 0, texture_resolution[0], texture_resolution[1]);
+        OpenGL3_Renderer::set_cull_face(GL_FRONT);
         OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
         OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         mask_creation->use();
-        for (unsigned int i = 0u; i < 6; ++i) {
-            mask_creation->set_mat4(0 + i,
-                                    light_transforms[i]);
-        }
+        mask_creation->set(mask_light_transforms, light_transforms.data(), static_cast<int>(light_transforms.size()));
+        gbuffer_matrices.model = ies_model_matrix;
         gbuffer_transformation->bind_to_uniform_buffer_target();
-        gbuffer_transformation->copy_to_buffer(64, 64, glm::value_ptr(ies_model_matrix));
+        gbuffer_transformation->copy_to_buffer(0, sizeof(gbuffer_matrices), &gbuffer_matrices);
         gbuffer_transformation->unbind_from_uniform_buffer_target();
-        OpenGL3_Renderer::draw(ies_light_vao);
+        //  The mask only needs the silhouette of the solid, so a coarse level is enough
+        if (light_profile_loaded) {
+            OpenGL3_Renderer::draw(photometric_solid_at(static_cast<std::size_t>(mask_lod_level)));
+        }
         mask_creation_fbo->unbind_from(GL_FRAMEBUFFER);
     }
 
     void
     DeferredLayer::update_rsm(const std::vector<glm::mat4>& light_transformations) {
         rsm_creation_fbo->bind_as(GL_FRAMEBUFFER);
-        glViewport(0, 0, texture_resolution[0], texture_resolution[1]);
-        glCullFace(GL_BACK);
+        OpenGL3_Renderer::set_viewport(0, 0, texture_resolution[0], texture_resolution[1]);
+        OpenGL3_Renderer::set_cull_face(GL_BACK);
         OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
         OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        rsm_creation->use();
+        const auto& rsm_shader = use_indirect_scene_draws ? rsm_creation_indirect : rsm_creation;
+        const auto& light_transforms_uniform = use_indirect_scene_draws ? rsm_indirect_light_transforms
+                                                                        : rsm_light_transforms;
+        rsm_shader->use();
         rsm_positions->bind_to_slot(0);
         rsm_normals->bind_to_slot(1);
         rsm_fluxes->bind_to_slot(2);
         light_mask->bind_to_slot(3);
-        rsm_creation->set_int(6, 3);
-
-        for (int i = 0; i < 6; ++i) {
-            rsm_creation->set_mat4(0 + i, light_transformations[i]);
-        }
-
-        for (const auto& o : objects) {
-            const auto& model_matrix = o.transform;
-            const auto& transposed_inversed_model_matrix = o.transpose_inverse_transform;
-            gbuffer_transformation->bind_to_uniform_buffer_target();
-            gbuffer_transformation->copy_to_buffer(64, 64, glm::value_ptr(model_matrix));
-            gbuffer_transformation->copy_to_buffer(128, 64, glm::value_ptr(transposed_inversed_model_matrix));
-            gbuffer_transformation->unbind_from_uniform_buffer_target();
-            material_buffer->bind_to_uniform_buffer_target();
-            material_buffer->copy_to_buffer(0, 16, glm::value_ptr(o.material.data.diffuse_color));
-            material_buffer->copy_to_buffer(16, 4, &o.material.data.shininess);
-            material_buffer->unbind_from_uniform_buffer_target();
-            OpenGL3_Renderer::draw(*(o.vao));
-        }
+        ies_profiles.bind_to_slot(4);
+        rsm_shader->set(light_transforms_uniform, light_transformations.data(),
+                        static_cast<int>(light_transformations.size()));
+
+        cull_for_light_faces(light_transformations);
+        select_light_space_lods(glm::vec3(light.get_representative_data().position));
+        //  All six faces are drawn at once, so there is no single front to sort by
+        draw_scene_objects(RenderPass::RSM, *rsm_shader, glm::vec3(light.get_representative_data().position),
+                           DrawOrder::State_Changes_First);
         rsm_creation_fbo->unbind_from(GL_FRAMEBUFFER);
     }
 
     void DeferredLayer::render_direct_lighting() {
         direct_pass_fbo->bind_as(GL_FRAMEBUFFER);
-        glViewport(0, 0, target_resolution[0], target_resolution[1]);
+        OpenGL3_Renderer::set_viewport(0, 0, target_resolution[0], target_resolution[1]);
         OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
         OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         deferred_direct->use();
-        deferred_direct->set_int(0, 0);
-        deferred_direct->set_int(1, 1);
-        deferred_direct->set_int(2, 2);
-        deferred_direct->set_int(3, 3);
-        deferred_direct->set_int(4, 4);
         gbuffer_positions_texture->bind_to_slot(0);
         gbuffer_normals_texture->bind_to_slot(1);
         gbuffer_diffuse_texture->bind_to_slot(2);
         shadow_map->bind_to_slot(3);
         light_mask->bind_to_slot(4);
+        ies_profiles.bind_to_slot(5);
 
         OpenGL3_Renderer::draw(quad.vao);
         direct_pass_fbo->unbind_from(GL_FRAMEBUFFER);
@@ -258,16 +567,7 @@ namespace engine {
         OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
         OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         deferred_indirect->use();
-
-        deferred_indirect->set_int(0, 0);
-        deferred_indirect->set_int(1, 1);
-        deferred_indirect->set_int(2, 2);
-        deferred_indirect->set_int(3, 3);
-        deferred_indirect->set_int(4, 4);
-        deferred_indirect->set_int(5, 5);
-        deferred_indirect->set_int(6, 6);
-        deferred_indirect->set_int(10, offsets_number);
-        deferred_indirect->set_float(11, offset_displacement_radius);
+        deferred_indirect->set(indirect_displacement_radius, offset_displacement_radius);
         gbuffer_positions_texture->bind_to_slot(0);
         gbuffer_normals_texture->bind_to_slot(1);
         gbuffer_diffuse_texture->bind_to_slot(2);
@@ -283,7 +583,6 @@ namespace engine {
         OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
         OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         quad_render->use();
-        quad_render->set_int(0, 0);
         direct_pass_output->bind_to_slot(0);
         OpenGL3_Renderer::draw(quad.vao);
         indirect_pass_output->bind_to_slot(0);
@@ -308,38 +607,175 @@ namespace engine {
             event_pump(std::make_unique<SceneChangedEvent>());
         }
         ImGui::Text("Photometric Solid size: %.5f", max_distance_to_ies_vertex * scale_modifier);
+        auto lookup = static_cast<int>(ies_lookup);
+        if(ImGui::Combo("IES lookup", &lookup, "Rasterized light mask\0Profile atlas\0Spherical harmonics\0")){
+            ies_lookup = static_cast<IES_Lookup>(lookup);
+            select_shader_variants();
+            event_pump(std::make_unique<SceneChangedEvent>());
+        }
+        if(ImGui::Checkbox("Ignore IES profile in RSM", &rsm_ignores_ies_profile)){
+            select_shader_variants();
+            event_pump(std::make_unique<SceneChangedEvent>());
+        }
+        if(ies_lookup == IES_Lookup::Profile_Atlas){
+            ImGui::Text("IES profiles in atlas: %u (%.1f KiB)", ies_profiles.profiles_count(),
+                        static_cast<float>(ies_profiles.memory_footprint()) / 1024.0f);
+        }
+        if(ies_lookup == IES_Lookup::Spherical_Harmonics && light_profile_loaded){
+            if(ImGui::SliderInt("Harmonics order", &harmonics_order, 0,
+                                static_cast<int>(ies::adapter::max_spherical_harmonics_order))){
+                fit_light_profile_harmonics();
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+            ImGui::Text("%zu coefficients, RMS error %.4f, max error %.4f",
+                        light_profile_harmonics.coefficients.size(),
+                        light_profile_harmonics.rms_error, light_profile_harmonics.max_error);
+        }
         if(ImGui::Checkbox("Show Photometric Solid", &draw_wireframe_in_scene)){
             event_pump(std::make_unique<SceneChangedEvent>());
         }
+        if(IES_Mesh_Generator::is_supported() && light_profile_loaded){
+            if(ImGui::Checkbox("Generate Photometric Solid on GPU", &generate_solid_on_gpu)){
+                rebuild_photometric_solid();
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+            if(generate_solid_on_gpu &&
+               ImGui::SliderInt("Photometric Solid subdivision", &solid_subdivision, 2, 256)){
+                rebuild_photometric_solid();
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+        }
+        ImGui::Text("Geometry pool: %u/%u vertices, %u/%u indices, %zu free blocks",
+                    geometry_pool->used_vertices(), geometry_pool->vertex_capacity(),
+                    geometry_pool->used_indices(), geometry_pool->index_capacity(), geometry_pool->free_blocks());
+        if(upload_thread && upload_thread->pending_uploads() > 0){
+            ImGui::Text("Upload thread: %u staging buffers pending", upload_thread->pending_uploads());
+        }
+        if(asset_jobs.jobs_in_flight() > 0 || scene_streaming){
+            ImGui::Text("Streaming %u assets%s", asset_jobs.jobs_in_flight(), scene_streaming ? ", scene included" : "");
+        } else if(ImGui::Button("Reload scene")){
+            reload_scene();
+        }
+        ImGui::SliderFloat("Upload budget per frame (ms)", &upload_budget_ms, 0.1f, 16.0f, "%.1f",
+                           ImGuiSliderFlags_Logarithmic);
+        const auto state_counters = OpenGL3_Renderer::state_counters();
+        ImGui::Text("GL state calls last frame: %u issued, %u elided", state_counters.issued, state_counters.elided);
+        if(ImGui::Checkbox("Front-to-back G-buffer draws", &front_to_back_gbuffer)){
+            event_pump(std::make_unique<SceneChangedEvent>());
+        }
+        if(ImGui::Checkbox("Frustum culling", &frustum_culling)){
+            event_pump(std::make_unique<SceneChangedEvent>());
+        }
+        if(frustum_culling && !use_indirect_scene_draws){
+            ImGui::Text("Camera: %u visible, %u culled", culling_statistics.camera_visible,
+                        culling_statistics.camera_culled);
+            ImGui::Text("RSM: %u object faces drawn, %u culled", culling_statistics.face_draws,
+                        culling_statistics.faces_culled);
+        }
+        if(!use_indirect_scene_draws){
+            if(ImGui::SliderFloat("Light-space proxy error (texels)", &light_space_max_error, 0.0f, 8.0f, "%.2f")){
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+            ImGui::Text("RSM triangles per face: %u of %u", culling_statistics.rsm_triangles,
+                        culling_statistics.rsm_full_detail_triangles);
+        }
+        if(scene_batch){
+            if(ImGui::Checkbox("Multi-draw-indirect scene passes", &use_indirect_scene_draws)){
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+            if(use_indirect_scene_draws){
+                if(ImGui::Checkbox("Hi-Z occlusion culling", &occlusion_culling)){
+                    event_pump(std::make_unique<SceneChangedEvent>());
+                }
+                if(occlusion_culling){
+                    const auto& occlusion = occlusion_culler->statistics();
+                    ImGui::Text("Occlusion: %u drawn first, %u drawn second, %u culled (%u triangles)",
+                                occlusion.first_phase_objects, occlusion.second_phase_objects,
+                                occlusion.culled_objects, occlusion.culled_triangles);
+                }
+            }
+            if(ImGui::Button("Benchmark draw submission (10k objects)")){
+                run_draw_submission_benchmark();
+            }
+            if(draw_submission_timings.objects > 0){
+                ImGui::Text("Per-object: %.3f ms CPU, %.3f ms GPU", draw_submission_timings.per_object_cpu_ms,
+                            draw_submission_timings.per_object_gpu_ms);
+                ImGui::Text("Indirect: %.3f ms CPU, %.3f ms GPU", draw_submission_timings.indirect_cpu_ms,
+                            draw_submission_timings.indirect_gpu_ms);
+            }
+        }
+        if(!generate_solid_on_gpu && ies_light_lods.levels() > 0){
+            if(ImGui::SliderFloat("Max screen-space error (px)", &max_screen_space_error, 0.1f, 32.0f, "%.1f",
+                                  ImGuiSliderFlags_Logarithmic)){
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+            if(ies_lookup == IES_Lookup::Light_Mask &&
+               ImGui::SliderInt("Light mask LOD", &mask_lod_level, 0, static_cast<int>(ies_light_lods.levels()) - 1)){
+                event_pump(std::make_unique<SceneChangedEvent>());
+            }
+            ImGui::Text("Displayed LOD: %zu (%u triangles)", displayed_lod_level,
+                        ies_light_lods.level(displayed_lod_level).triangles);
+        }
         if(draw_wireframe_in_scene){
             if(ImGui::ColorEdit4("Wireframe color", glm::value_ptr(wireframe_color))){
                 event_pump(std::make_unique<SceneChangedEvent>());
             }
         }
         ImGui::End();
+
+        draw_gpu_profiler_window();
     }
 
-    std::vector<SceneObject> default_load_scene(const std::string& path_to_scene) {
+    void DeferredLayer::draw_gpu_profiler_window() {
+        ImGui::Begin("GPU profiler");
+        auto timing = gpu_profiler.is_enabled();
+        if(ImGui::Checkbox("Time passes", &timing)){
+            gpu_profiler.set_enabled(timing);
+        }
+        //  Passes that only run when the scene or the light changes are averaged over the frames that ran them
+        ImGui::Text("%-28s %8s %8s %8s %8s", "Pass", "Last", "Average", "Min", "Max");
+        for(const auto& pass : gpu_profiler.pass_statistics()){
+            ImGui::Text("%-28.*s %8.3f %8.3f %8.3f %8.3f", static_cast<int>(pass.name.size()), pass.name.data(),
+                        pass.last_ms, pass.average_ms, pass.min_ms, pass.max_ms);
+        }
+        const auto frame_times = gpu_profiler.frame_times();
+        if(!frame_times.empty()){
+            const auto slowest = *std::max_element(std::begin(frame_times), std::end(frame_times));
+            const auto overlay = fmt::format("{:.3f} ms", frame_times.back());
+            ImGui::PlotLines("GPU frame (ms)", frame_times.data(), static_cast<int>(frame_times.size()), 0,
+                             overlay.c_str(), 0.0f, slowest * 1.1f, ImVec2(0.0f, 80.0f));
+        }
+        if(ImGui::Button("Export CSV")){
+            if(gpu_profiler.export_csv("gpu_passes.csv")){
+                fmt::print("[DEFERRED LAYER] GPU pass timings written to gpu_passes.csv\n");
+            }
+        }
+        if constexpr (profiling::enabled){
+            ImGui::SameLine();
+            if(ImGui::Button("Write CPU trace")){
+                if(profiling::write_chrome_trace("cpu_trace.json")){
+                    fmt::print("[DEFERRED LAYER] CPU zones written to cpu_trace.json\n");
+                }
+            }
+        }
+        ImGui::End();
+    }
+
+    std::vector<scenes::MeshData> default_load_scene_meshes(const std::string& path_to_scene) {
         constexpr unsigned int postprocessing_flags = aiProcess_GenNormals |
                                                       aiProcess_Triangulate |
                                                       aiProcess_ValidateDataStructure;
-        auto scene_objects = scenes::load_scene_objects_from(path_to_scene, postprocessing_flags);
+        auto meshes = scenes::load_scene_meshes_from(path_to_scene, postprocessing_flags);
 
         //  This scaling is needed for the cornell_box_multimaterial.obj scene
         //  The scene has a maximum height of 548.0f; to take it in the range [0, 3] we divide by:
         //  548.0f / 3.0f ~= 185.0f
+        //  upload_mesh derives the transposed inverse from the scaled transform
         const auto scaling_factor = 1.0f / 185.0f;
-        const auto scale_by = [](const float scale_factor, std::vector<SceneObject>& scene) {
-            for (auto&& object : scene) {
-                const auto T = object.transform;
-                const auto scene_scaling = glm::scale(T, glm::vec3(scale_factor));
-                const auto transposed_inverse_scene_scaling = glm::transpose(glm::inverse(scene_scaling));
-                object.transform = scene_scaling;
-                object.transpose_inverse_transform = transposed_inverse_scene_scaling;
-            }
-        };
-        scale_by(scaling_factor, scene_objects);
-        return scene_objects;
+        for (auto&& mesh : meshes) {
+            mesh.transform = glm::scale(mesh.transform, glm::vec3(scaling_factor));
+        }
+        return meshes;
     }
 
 
@@ -520,29 +956,144 @@ namespace engine {
     }
 
     void DeferredLayer::uniform_buffers_setup() {
-        gbuffer_transformation = std::make_shared<UniformBuffer>((4 * 4 * 4) * 3, GL_DYNAMIC_DRAW);
+        gbuffer_transformation = std::make_shared<UniformBuffer>(sizeof(GBufferMatricesBlock), GL_DYNAMIC_DRAW);
         gbuffer_transformation->bind_to_binding_point(0);
         gbuffer_transformation->unbind_from_uniform_buffer_target();
 
-        material_buffer = std::make_shared<UniformBuffer>(16 + 4, GL_DYNAMIC_DRAW);
+        material_buffer = std::make_shared<UniformBuffer>(sizeof(MaterialPropertiesBlock), GL_DYNAMIC_DRAW);
         material_buffer->bind_to_binding_point(1);
         material_buffer->unbind_from_uniform_buffer_target();
 
-        light_buffer = std::make_shared<UniformBuffer>((16 * 3) + (4 * 4), GL_DYNAMIC_DRAW);
+        allocate_object_uniforms();
+
+        light_buffer = std::make_shared<UniformBuffer>(sizeof(LightBlock), GL_DYNAMIC_DRAW);
         light_buffer->bind_to_binding_point(2);
         light_buffer->unbind_from_uniform_buffer_target();
 
-        common_buffer = std::make_shared<UniformBuffer>((16 * 1) + (4 * 3), GL_DYNAMIC_DRAW);
+        common_buffer = std::make_shared<UniformBuffer>(sizeof(CommonDataBlock), GL_DYNAMIC_DRAW);
         common_buffer->bind_to_binding_point(3);
         common_buffer->bind_to_uniform_buffer_target();
         const auto view_camera = camera.lock();
-        const auto camera_position_projective = glm::vec4(view_camera->position(), 1.0f);
-        common_buffer->copy_to_buffer(0, 16, glm::value_ptr(camera_position_projective));
-        common_buffer->copy_to_buffer(16, 4, &light_camera_far_plane);
-        common_buffer->copy_to_buffer(20, 4, &shadow_threshold);
-        const auto ies_solid_scale = max_distance_to_ies_vertex * scale_modifier;
-        common_buffer->copy_to_buffer(24, 4, &ies_solid_scale);
+        common_data = CommonDataBlock{glm::vec4(view_camera->position(), 1.0f), light_camera_far_plane,
+                                      shadow_threshold, max_distance_to_ies_vertex * scale_modifier, 0.0f};
+        common_buffer->copy_to_buffer(0, sizeof(common_data), &common_data);
         common_buffer->unbind_from_uniform_buffer_target();
+
+        //  IESHarmonics: vec4[7] packing up to 25 coefficients, followed by the order
+        harmonics_buffer = std::make_shared<UniformBuffer>(sizeof(IESHarmonicsBlock), GL_DYNAMIC_DRAW);
+        harmonics_buffer->bind_to_binding_point(4);
+        harmonics_buffer->unbind_from_uniform_buffer_target();
+        //  Zero coefficients until the light profile is loaded
+        upload_light_profile_harmonics();
+    }
+
+    void DeferredLayer::allocate_object_uniforms() {
+        //  write_object_uniforms() takes one aligned matrices record per object and one material record per
+        //  distinct material each frame, which is exactly what a frame region holds
+        const auto matrices_record_size = UniformBuffer::aligned_to_offset_requirement(sizeof(GBufferMatricesBlock));
+        const auto material_record_size = UniformBuffer::aligned_to_offset_requirement(sizeof(MaterialPropertiesBlock));
+        const auto frame_demand = matrices_record_size * static_cast<int>(objects.size()) +
+                                  material_record_size * static_cast<int>(materials_count);
+        object_uniforms = std::make_shared<UniformBuffer>(std::max(frame_demand, material_record_size), 3,
+                                                          UniformBufferMode::Persistent_Ring);
+    }
+
+    void DeferredLayer::select_shader_variants() {
+        //  Settings that only change on user input are compiled into the programs, so that the sampling loop
+        //  is unrolled and the unused IES lookups stripped; every combination is built the first time it is used
+        const auto lookup_mode = shader::ShaderDefine{"IES_LOOKUP_MODE", std::to_string(static_cast<int>(ies_lookup))};
+        auto rsm_defines = shader::ShaderDefines{lookup_mode};
+        if (rsm_ignores_ies_profile) {
+            rsm_defines.push_back({"IGNORE_IES_PROFILE", "1"});
+        }
+
+        rsm_creation = shader_library->program("resources/shaders/deferred/rsm_creation.vert",
+                                               "resources/shaders/deferred/rsm_creation.frag",
+                                               "resources/shaders/deferred/rsm_creation.geom", rsm_defines);
+        if (SceneDrawBatch::is_supported()) {
+            rsm_creation_indirect = shader_library->program("resources/shaders/deferred/rsm_creation_indirect.vert",
+                                                            "resources/shaders/deferred/rsm_creation.frag",
+                                                            "resources/shaders/deferred/rsm_creation.geom",
+                                                            rsm_defines);
+        }
+        deferred_direct = shader_library->program("resources/shaders/deferred/quad_rendering.vert",
+                                                  "resources/shaders/deferred/deferred_direct.frag", {lookup_mode});
+        //  offsets_texture holds exactly offsets_number samples
+        deferred_indirect = shader_library->program("resources/shaders/deferred/quad_rendering.vert",
+                                                    "resources/shaders/deferred/deferred_indirect.frag",
+                                                    {{"SAMPLES_PER_FRAGMENT", std::to_string(offsets_number)}});
+        resolve_shader_uniforms();
+    }
+
+    void DeferredLayer::resolve_shader_uniforms() {
+        //  Samplers never change texture unit, so they are assigned once instead of on every pass. Those
+        //  of the lookups a permutation strips are inactive, and skipped.
+        const auto assign_texture_units = [](const Shader& shader,
+                                             std::initializer_list<std::pair<std::string_view, int>> units) {
+            shader.use();
+            for (const auto& [sampler, unit] : units) {
+                if (shader.find_uniform(sampler) != nullptr) {
+                    shader.set(shader.uniform<int>(sampler), unit);
+                }
+            }
+        };
+
+        mask_light_transforms = mask_creation->uniform<glm::mat4>("light_view_projection_transforms");
+        rsm_light_transforms = rsm_creation->uniform<glm::mat4>("light_view_projection_transforms");
+        rsm_culled_faces_mask = rsm_creation->uniform<unsigned int>("culled_faces");
+        assign_texture_units(*rsm_creation, {{"ies_masking_texture", 3}, {"ies_profiles", 4}});
+        if (rsm_creation_indirect) {
+            rsm_indirect_light_transforms = rsm_creation_indirect->uniform<glm::mat4>("light_view_projection_transforms");
+            assign_texture_units(*rsm_creation_indirect, {{"ies_masking_texture", 3}, {"ies_profiles", 4}});
+        }
+
+        assign_texture_units(*deferred_direct, {{"g_positions", 0}, {"g_normals", 1}, {"g_diffuse", 2},
+                                                {"light_shadow_map", 3}, {"ies_masking_texture", 4},
+                                                {"ies_profiles", 5}});
+
+        indirect_displacement_radius = deferred_indirect->uniform<float>("displacement_sphere_radius");
+        assign_texture_units(*deferred_indirect, {{"g_positions", 0}, {"g_normals", 1}, {"g_diffuse_colors", 2},
+                                                  {"rsm_position_map", 3}, {"rsm_normal_map", 4},
+                                                  {"rsm_flux_map", 5}, {"sampling_offsets", 6}});
+
+        assign_texture_units(*quad_render, {{"image_to_quad", 0}});
+    }
+
+    void DeferredLayer::verify_uniform_block_layouts() const {
+        auto programs = std::vector<const Shader*>{gbuffer_creation.get(), wireframe_drawer.get(), mask_creation.get(),
+                                                   rsm_creation.get(), deferred_direct.get(), deferred_indirect.get()};
+        if (gbuffer_creation_indirect) {
+            programs.push_back(gbuffer_creation_indirect.get());
+            programs.push_back(rsm_creation_indirect.get());
+        }
+        auto all_match = true;
+        for (const auto program : programs) {
+            all_match &= verify_block_layout<GBufferMatricesBlock>(*program);
+            all_match &= verify_block_layout<MaterialPropertiesBlock>(*program);
+            all_match &= verify_block_layout<LightBlock>(*program);
+            all_match &= verify_block_layout<CommonDataBlock>(*program);
+            all_match &= verify_block_layout<IESHarmonicsBlock>(*program);
+        }
+        if (!all_match) {
+            fmt::print("[DEFERRED LAYER] Uniform block layouts differ from the shaders, lighting will be wrong\n");
+        }
+    }
+
+    void DeferredLayer::fit_light_profile_harmonics() {
+        light_profile_harmonics = ies::adapter::fit_spherical_harmonics(light_profile_document,
+                                                                        static_cast<unsigned int>(harmonics_order));
+        upload_light_profile_harmonics();
+    }
+
+    void DeferredLayer::upload_light_profile_harmonics() {
+        auto harmonics = IESHarmonicsBlock{};
+        std::copy_n(std::begin(light_profile_harmonics.coefficients),
+                    std::min(light_profile_harmonics.coefficients.size(), harmonics.sh_coefficients.size() * 4),
+                    glm::value_ptr(harmonics.sh_coefficients[0]));
+        harmonics.sh_order = static_cast<int>(light_profile_harmonics.order);
+        harmonics_buffer->bind_to_uniform_buffer_target();
+        harmonics_buffer->copy_to_buffer(0, sizeof(harmonics), &harmonics);
+        harmonics_buffer->unbind_from_uniform_buffer_target();
     }
 
 
@@ -573,51 +1124,83 @@ namespace engine {
         return ies_light_model_matrix;
     }
 
-    void DeferredLayer::load_IES_light_as_VAO(const std::filesystem::path& path_to_IES_data) {
-        auto document = ies::IES_Default_Parser()
-                .parse(path_to_IES_data.filename().string(), files::read_file(path_to_IES_data));
-        ies::adapter::IES_Mesh photometric_solid = ies::adapter::IES_Mesh::interpolate_from(document, 3);
-//        const auto photometric_solid = ies::adapter::IES_Mesh(document);
+    void DeferredLayer::stream_IES_light(const std::filesystem::path& path_to_IES_data) {
+        const auto order = static_cast<unsigned int>(harmonics_order);
+        asset_jobs.submit([this, path_to_IES_data, order]() -> jobs::UploadStep {
+            auto document = std::make_shared<ies::IES_Document>(ies::IES_Default_Parser().parse(
+                    path_to_IES_data.filename().string(), files::read_file(path_to_IES_data)));
+            const auto& candelas = document->photometric_description.measured_data.candelas_per_angle_pair;
+            if (candelas.empty()) {
+                fmt::print("[DEFERRED LAYER] {} holds no candela values, the light profile is left as it is\n",
+                           path_to_IES_data.string());
+                return []() { return true; };
+            }
+            auto meshes = std::make_shared<IES_Mesh_Levels>(
+                    IES_Mesh_LOD_Chain::mesh_levels(*document, photometric_solid_interpolation));
+            const auto brightest = *std::max_element(std::begin(candelas), std::end(candelas));
+            auto harmonics = ies::adapter::fit_spherical_harmonics(*document, order);
+
+            return [this, document, meshes, brightest, harmonics]() {
+                light_profile_layer = ies_profiles.add_profile(*document);
+                max_candela = brightest;
+                light_profile_document = std::move(*document);
+
+                //  The GPU generator is only offered once the profile is loaded, so the solid comes from the CPU
+                ies_light_lods.upload_levels(*meshes);
+                max_distance_to_ies_vertex = ies_light_lods.max_distance_to_vertex();
+                //  A profile dark in every direction gives a solid collapsed on the origin, left unscaled
+                scale_modifier = max_distance_to_ies_vertex > 0.0f ? 1.5f / max_distance_to_ies_vertex : 1.0f;
+                common_data.distance_to_furthest_ies_vertex = max_distance_to_ies_vertex * scale_modifier;
+
+                light_profile_harmonics = harmonics;
+                upload_light_profile_harmonics();
+                light_profile_loaded = true;
+                event_pump(std::make_unique<SceneChangedEvent>());
+                return true;
+            };
+        });
+    }
 
-        const auto vertices = photometric_solid.get_vertices();
+    void DeferredLayer::rebuild_photometric_solid() {
+        if (generate_solid_on_gpu) {
+            ies_mesh_generator->generate_into(ies_light_vao, ies_profiles, light_profile_layer, max_candela,
+                                              static_cast<unsigned int>(solid_subdivision));
+            max_distance_to_ies_vertex = max_candela;
+            return;
+        }
 
-        max_distance_to_ies_vertex = [](const std::vector<float>& vs) -> float {
-            float result = 0.0f;
-            for (auto i = 0u; i < vs.size() / 3; ++i) {
-                const glm::vec3 p(vs[3 * i + 0],
-                                  vs[3 * i + 1],
-                                  vs[3 * i + 2]);
-                const auto p_to_origin = glm::length(p);
-                if (result < p_to_origin) {
-                    result = p_to_origin;
-                }
-            }
-            return result;
-        }(vertices);
+        //  The GPU generator writes its own vertex array, the levels uploaded with the profile are still current
+        max_distance_to_ies_vertex = ies_light_lods.max_distance_to_vertex();
+    }
 
-        scale_modifier = 1.5f / max_distance_to_ies_vertex;
+    const VertexArray& DeferredLayer::photometric_solid_at(const std::size_t lod_level) const {
+        if (generate_solid_on_gpu || ies_light_lods.levels() == 0) {
+            return ies_light_vao;
+        }
+        return *ies_light_lods.level(lod_level).vao;
+    }
 
-        auto vbo = std::make_shared<VertexBuffer>(vertices.size() * sizeof(float),
-                                                  vertices.data());
-        vbo->set_buffer_layout(VertexBufferLayout({
-                                                          VertexBufferElement(ShaderDataType::Float3,
-                                                                              "position"),
-                                                          VertexBufferElement(ShaderDataType::Float3,
-                                                                              "normal")}));
-        ies_light_vao.set_vbo(std::move(vbo));
-        ies_light_vao.set_ebo(std::make_shared<ElementBuffer>(photometric_solid.get_indices()));
+    std::size_t DeferredLayer::select_displayed_lod_level() const {
+        const auto view_camera = camera.lock();
+        if (!view_camera || ies_light_lods.levels() == 0) {
+            return 0;
+        }
+        const auto distance_to_light = glm::distance(view_camera->position(), light.get_position_as_vec3());
+        //  P[1][1] is the cotangent of half the vertical field of view
+        const auto projection_scale = view_camera->projection_matrix()[1][1] * static_cast<float>(target_resolution[1]) * 0.5f;
+        return ies_light_lods.select_level(scale_modifier, distance_to_light, projection_scale, max_screen_space_error);
     }
 
     void DeferredLayer::update_camera_related_buffers() {
-        common_buffer->bind_to_uniform_buffer_target();
         const auto view_camera = camera.lock();
-        const auto camera_position_projective = glm::vec4(view_camera->position(), 1.0f);
-        const auto projection_view_matrix = view_camera->projection_matrix() * view_camera->view_matrix();
+        common_data.camera_position = glm::vec4(view_camera->position(), 1.0f);
+        gbuffer_matrices.projection_view = view_camera->projection_matrix() * view_camera->view_matrix();
 
-        common_buffer->copy_to_buffer(0, 16, glm::value_ptr(camera_position_projective));
+        common_buffer->bind_to_uniform_buffer_target();
+        common_buffer->copy_to_buffer(0, sizeof(common_data), &common_data);
         common_buffer->unbind_from_uniform_buffer_target();
         gbuffer_transformation->bind_to_uniform_buffer_target();
-        gbuffer_transformation->copy_to_buffer(0, 64, glm::value_ptr(projection_view_matrix));
+        gbuffer_transformation->copy_to_buffer(0, sizeof(gbuffer_matrices), &gbuffer_matrices);
         gbuffer_transformation->unbind_from_uniform_buffer_target();
     }
 
@@ -625,6 +1208,19 @@ namespace engine {
         constexpr auto light_intensity = 1.0f;
         constexpr auto light_color = glm::vec4(1.0f);
 
+        //  Most scene changes only move the light; replace_scene builds the structures from scratch
+        if (object_transforms_changed) {
+            const auto world_bounds = scene_world_bounds();
+            scene_bvh.refit(world_bounds);
+            if (scene_batch) {
+                scene_batch->update_object_data(objects);
+            }
+            if (scene_batch && occlusion_culler) {
+                occlusion_culler->update_bounds(world_bounds);
+            }
+            object_transforms_changed = false;
+        }
+
         const auto light_data = light.get_representative_data();
         const auto light_position = glm::vec3(light_data.position);
         const auto light_orientation = glm::mat4_cast(light.get_orientation());
@@ -643,18 +1239,24 @@ namespace engine {
         ies_model_matrix = compute_light_model_matrix(light_position,
                                                       light_orientation);
         ies_inverse_transposed_matrix = glm::transpose(glm::inverse(ies_model_matrix));
+        //  Rotation part of ies_model_matrix, inverted: takes world directions to the photometric frame
+        const auto world_to_profile = glm::transpose(glm::rotate(light_orientation, glm::radians(90.0f),
+                                                                 glm::vec3(1.0f, 0.0f, 0.0f)));
+        const auto light_block = LightBlock{light_data.position, light_data.direction,
+                                            light.attenuation.constant, light.attenuation.linear,
+                                            light.attenuation.quadratic, light_intensity, light_color,
+                                            world_to_profile, static_cast<int>(light_profile_layer), {}};
 
         light_buffer->bind_to_uniform_buffer_target();
-        light_buffer->copy_to_buffer(0, 16, glm::value_ptr(light_data.position));
-        light_buffer->copy_to_buffer(16, 16, glm::value_ptr(light_data.direction));
-        light_buffer->copy_to_buffer(32, 4, &light.attenuation.constant);
-        light_buffer->copy_to_buffer(36, 4, &light.attenuation.linear);
-        light_buffer->copy_to_buffer(40, 4, &light.attenuation.quadratic);
-        light_buffer->copy_to_buffer(44, 4, &light_intensity);
-        light_buffer->copy_to_buffer(48, 16, glm::value_ptr(light_color));
+        light_buffer->copy_to_buffer(0, sizeof(light_block), &light_block);
         light_buffer->unbind_from_uniform_buffer_target();
 
-        update_light_mask(light_transforms);
+        if (ies_lookup == IES_Lookup::Light_Mask) {
+            gpu_profiler.begin_pass("IES mask");
+            update_light_mask(light_transforms);
+        }
+        gpu_profiler.begin_pass("RSM");
         update_rsm(light_transforms);
+        gpu_profiler.end_pass();
     }
 }
\ No newline at end of file
@@ -8,20 +8,37 @@
 #include "../../rendering/renderer.h"
 #include "../../rendering/opengl3_framebuffer.h"
 #include "../../rendering/opengl3_texture.h"
+#include "../../rendering/opengl3_gpu_profiler.h"
+#include "../../rendering/render_queue.h"
 #include "../../rendering/fly_camera.h"
+#include "../../rendering/ies_mesh_generator.h"
+#include "../../rendering/ies_mesh_lod_chain.h"
+#include "../../rendering/ies_profile_atlas.h"
+#include "../../rendering/opengl3_upload_thread.h"
+#include "../../rendering/shader_library.h"
 #include "../../rendering/shader_loading.h"
+#include "../../rendering/uniform_block_layouts.h"
 #include "../../rendering/uniform_buffer.h"
+#include "../../scene_management/draw_submission_benchmark.h"
+#include "../../scene_management/scene_draw_batch.h"
+#include "../../scene_management/occlusion_culler.h"
 #include "../../scene_management/scene_loading.h"
 #include "../../scene_management/point_light.h"
+#include "../../scene_management/scene_bvh.h"
 
 #include "../../../ies/ies_default_parser.h"
 #include "../../../ies/adapter/ies_mesh.h"
+#include "../../../ies/adapter/ies_spherical_harmonics.h"
 
+#include "../../../utility/cpu_profiler.h"
+#include "../../../utility/job_system.h"
 #include "../../../utility/random_numbers.h"
 
 #include <imgui/imgui.h>
 #include <glm/glm.hpp>
 
+#include <bit>
+
 namespace engine{
     struct RenderingQuad {
         std::array<glm::vec2, 8> vertex_data;
@@ -45,14 +62,50 @@ namespace engine{
         }
     };
 
+    //  Offsets of one object's GBufferMatrices and MaterialProperties records in the per-frame uniform arena
+    struct ObjectUniformRanges {
+        int transformations;
+        int material;
+    };
+
+    struct CullingStatistics {
+        unsigned int camera_visible = 0;
+        unsigned int camera_culled = 0;
+        unsigned int face_draws = 0;        //  Object and cube face pairs rendered into the RSM
+        unsigned int faces_culled = 0;
+        unsigned int rsm_triangles = 0;             //  Per cube face, with the proxies in place of the meshes
+        unsigned int rsm_full_detail_triangles = 0;
+    };
+
+    //  How the direct and RSM passes read the photometric distribution; values match the GLSL constants
+    enum class IES_Lookup : int {
+        Light_Mask = 0, Profile_Atlas = 1, Spherical_Harmonics = 2
+    };
+
+    //  What the layer is created with; paths are relative to the working directory
+    struct DeferredLayerSettings {
+        std::string scene_path = "resources/cornell_box_multimaterial.obj";
+        std::string ies_path = "resources/ies/111621PN.IES";
+        int offsets_number;
+        int rsm_resolution = 0;     //  Per cube face; 0 for half the target resolution
+    };
+
     class DeferredLayer : public Layer{
     public:
-        DeferredLayer(std::weak_ptr<FlyCamera> controlled_camera, LayerCreationKey key);
+        DeferredLayer(std::weak_ptr<FlyCamera> controlled_camera, DeferredLayerSettings layer_settings,
+                      LayerCreationKey key);
 
+        //  Without an upload context the scene geometry is uploaded on the render thread
         template<class FnCallback>
-        static std::unique_ptr<DeferredLayer> create_using(std::weak_ptr<FlyCamera> controlled_camera, FnCallback event_pump_callback){
-            auto layer = std::make_unique<DeferredLayer>(std::move(controlled_camera), LayerCreationKey{});
+        static std::unique_ptr<DeferredLayer> create_using(std::weak_ptr<FlyCamera> controlled_camera, FnCallback event_pump_callback,
+                                                           std::unique_ptr<RenderingContext> upload_context = nullptr,
+                                                           DeferredLayerSettings layer_settings = {}){
+            auto layer = std::make_unique<DeferredLayer>(std::move(controlled_camera), std::move(layer_settings),
+                                                         LayerCreationKey{});
             layer->event_pump = event_pump_callback;
+            if (upload_context) {
+                layer->upload_thread = std::make_unique<OpenGL3_Upload_Thread>(std::move(upload_context));
+            }
             return layer;
         }
 
@@ -68,9 +121,18 @@ namespace engine{
         void update(float delta_time) override;
         void on_imgui_render() override;
 
+        //  As the light controls do: the scene is lit again on the next update
+        void place_light(const glm::vec4& position, const glm::vec3& rotation_in_degrees);
+        //  Culling structures follow on the next update, only when some transform has changed since the last one
+        void set_object_transform(std::size_t object_index, const glm::mat4& transform);
+        //  True once the scene and the light profile streamed by on_attach are on the GPU
+        [[nodiscard]] bool assets_loaded() const;
+        [[nodiscard]] OpenGL3_GPU_Profiler& pass_profiler();
+
     private:
         std::weak_ptr<FlyCamera> camera;
         std::function<void(std::unique_ptr<Event>)> event_pump;
+        DeferredLayerSettings settings;
 
         glm::vec<2, int> target_resolution {0, 0};
         glm::vec<2, int> texture_resolution {0, 0};
@@ -81,17 +143,56 @@ namespace engine{
         int offsets_number = 400;
         float offset_displacement_radius = 2.0f;
         bool draw_wireframe_in_scene = true;
+        IES_Lookup ies_lookup = IES_Lookup::Profile_Atlas;
+        bool rsm_ignores_ies_profile = false;
+        int harmonics_order = 3;
+        bool generate_solid_on_gpu = false;
+        int solid_subdivision = 32;
+        float max_candela = 1.0f;
+        float max_screen_space_error = 1.0f;   //  In pixels, drives the LOD of the displayed solid
+        int mask_lod_level = 2;
+        std::size_t displayed_lod_level = 0;
+        float light_space_max_error = 1.0f;    //  In RSM texels, drives the proxies drawn in light space
+        bool use_indirect_scene_draws = false;
+        bool front_to_back_gbuffer = true;
+        bool frustum_culling = true;
+        bool occlusion_culling = true;     //  Only on the multi-draw-indirect path
+        CullingStatistics culling_statistics;
+        DrawSubmissionTimings draw_submission_timings;
+        OpenGL3_GPU_Profiler gpu_profiler;
         glm::vec4 wireframe_color = {0.20f, 1.00f, 1.00f, 0.60f};
+        float upload_budget_ms = 2.0f;      //  GL thread time given to streamed assets every frame
+        bool scene_streaming = false;
+        bool light_profile_loaded = false;
+
+        //  From the finest to the coarsest level; the last one is the measured grid itself
+        static constexpr std::array<uint16_t, 4> photometric_solid_interpolation{6, 3, 1, 0};
 
         VertexArray ies_light_vao;
+        IES_Mesh_LOD_Chain ies_light_lods;
         Point_Light light;
         glm::mat4 ies_model_matrix;
         glm::mat4 ies_inverse_transposed_matrix;
+        IES_Profile_Atlas ies_profiles;
+        unsigned int light_profile_layer = 0;
+        ies::IES_Document light_profile_document;
+        ies::adapter::Spherical_Harmonics_Fit light_profile_harmonics;
+        std::shared_ptr<GeometryPool> geometry_pool;
         std::vector<SceneObject> objects;
+        std::vector<unsigned int> object_material_ids;     //  Objects with equal materials share an id
+        unsigned int materials_count = 0;
+        bool object_transforms_changed = false;        //  Bounds in the BVH and the occlusion culler are stale
+        RenderQueue scene_queue;
+        SceneBVH scene_bvh;
+        std::vector<std::uint32_t> camera_visible_objects;
+        std::vector<std::uint8_t> rsm_culled_faces;
+        std::vector<std::uint8_t> light_space_lods;
+        std::unique_ptr<SceneDrawBatch> scene_batch;
+        std::unique_ptr<OcclusionCuller> occlusion_culler;
         RenderingQuad quad;
 
         std::unique_ptr<OpenGL3_FrameBuffer> gbuffer_creation_fbo;
-        std::unique_ptr<OpenGL3_Texture2D> gbuffer_depth_texture;           //TODO: this might be unnecessary
+        std::unique_ptr<OpenGL3_Texture2D> gbuffer_depth_texture;           //  Source of the Hi-Z pyramid for occlusion culling
         std::unique_ptr<OpenGL3_Texture2D> gbuffer_positions_texture;
         std::unique_ptr<OpenGL3_Texture2D> gbuffer_normals_texture;
         std::unique_ptr<OpenGL3_Texture2D> gbuffer_diffuse_texture;
@@ -116,21 +217,53 @@ namespace engine{
 
         bool camera_moved = true;
         bool scene_changed = true;
+        std::unique_ptr<ShaderLibrary> shader_library;
         std::shared_ptr<Shader> gbuffer_creation;   //  Should update when camera moves or scene changes
+        std::shared_ptr<Shader> gbuffer_creation_indirect;
         std::shared_ptr<Shader> wireframe_drawer;
         std::shared_ptr<Shader> mask_creation;      //  Should update when light moves or scene changes
         std::shared_ptr<Shader> rsm_creation;       //  Should update when light moves or scene changes
+        std::shared_ptr<Shader> rsm_creation_indirect;
         std::shared_ptr<Shader> deferred_direct;
         std::shared_ptr<Shader> deferred_indirect;
         std::shared_ptr<Shader> quad_render;
+        std::unique_ptr<IES_Mesh_Generator> ies_mesh_generator;
+
+        Uniform<glm::mat4> mask_light_transforms;
+        Uniform<glm::mat4> rsm_light_transforms;
+        Uniform<glm::mat4> rsm_indirect_light_transforms;
+        Uniform<unsigned int> rsm_culled_faces_mask;
+        Uniform<float> indirect_displacement_radius;
 
         std::shared_ptr<UniformBuffer> gbuffer_transformation;
         std::shared_ptr<UniformBuffer> material_buffer;
         std::shared_ptr<UniformBuffer> light_buffer;
         std::shared_ptr<UniformBuffer> common_buffer;
+        std::shared_ptr<UniformBuffer> harmonics_buffer;
+        std::shared_ptr<UniformBuffer> object_uniforms;
+        std::vector<ObjectUniformRanges> object_uniform_ranges;
+        GBufferMatricesBlock gbuffer_matrices{};
+        CommonDataBlock common_data{};
+
+        std::unique_ptr<OpenGL3_Upload_Thread> upload_thread;
+        //  Declared last so that it is destroyed first: its workers are joined before the members their
+        //  upload steps refer to go away
+        jobs::JobSystem asset_jobs;
 
 
         void create_gbuffer();
+        void write_object_uniforms();
+        void assign_material_ids();
+        [[nodiscard]] std::vector<AABB> scene_world_bounds() const;
+        void cull_for_camera();
+        void cull_for_light_faces(const std::vector<glm::mat4>& light_transformations);
+        void select_light_space_lods(const glm::vec3& light_position);
+        void draw_scene_objects(RenderPass pass, const Shader& shader, const glm::vec3& eye_position, DrawOrder order);
+        void run_draw_submission_benchmark();
+        void stream_scene(const std::string& path_to_scene);
+        void stage_scene(std::shared_ptr<const std::vector<scenes::MeshData>> meshes);
+        void replace_scene(std::vector<SceneObject>&& streamed_objects);
+        void reload_scene();
         void update_rsm(const std::vector<glm::mat4>& light_transformations);
         void update_light_mask(const std::vector<glm::mat4>& light_transforms);
         void render_direct_lighting();
@@ -143,20 +276,30 @@ namespace engine{
         void direct_pass_setup();
         void indirect_pass_setup();
         void uniform_buffers_setup();
+        void allocate_object_uniforms();
+        void select_shader_variants();
+        void resolve_shader_uniforms();
+        void verify_uniform_block_layouts() const;
+        void draw_gpu_profiler_window();
 
         [[nodiscard]] std::vector<glm::mat4> compute_cubemap_view_projection_transforms(const glm::vec3& camera_position,
                                                                           const glm::mat4& camera_projection_matrix) const;
         [[nodiscard]] glm::mat4 compute_light_model_matrix(const glm::vec3& light_position,
                                                            const glm::mat4& light_orientation) const;
 
-        //TODO: refactor this better, so that it can be a free function
-        void load_IES_light_as_VAO(const std::filesystem::path& path_to_IES_data);
+        void stream_IES_light(const std::filesystem::path& path_to_IES_data);
+        void rebuild_photometric_solid();
+        [[nodiscard]] const VertexArray& photometric_solid_at(std::size_t lod_level) const;
+        [[nodiscard]] std::size_t select_displayed_lod_level() const;
+        void fit_light_profile_harmonics();
+        void upload_light_profile_harmonics();
         void update_camera_related_buffers();
         void update_scene_buffers_and_representations();
     };
 
 
-    [[nodiscard]] std::vector<SceneObject> default_load_scene(const std::string& path_to_scene);
+    //  Meshes of the scene at path_to_scene, scaled to the size the layer expects; touches no GL state
+    [[nodiscard]] std::vector<scenes::MeshData> default_load_scene_meshes(const std::string& path_to_scene);
 }
 
 #endif //DEFERRED_LAYER_H
\ No newline at end of file
@@ -161,15 +161,15 @@ namespace engine {
             glDrawBuffers(1, buffer_enums.get());
             mask_fbo->unbind_from(GL_FRAMEBUFFER);
 
-            glEnable(GL_DEPTH_TEST);
+            OpenGL3_Renderer::enable(GL_DEPTH_TEST);
             glDepthMask(GL_TRUE);
-            glEnable(GL_BLEND);
-            glBlendEquation(GL_FUNC_ADD);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            OpenGL3_Renderer::enable(GL_BLEND);
+            OpenGL3_Renderer::set_blend_equation(GL_FUNC_ADD);
+            OpenGL3_Renderer::set_blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
-            glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+            OpenGL3_Renderer::enable(GL_CULL_FACE);
+            OpenGL3_Renderer::set_cull_face(GL_BACK);
+            OpenGL3_Renderer::enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 
             //TODO: refactor as IES_Loader class or as a free function
             const auto path_to_IES_data = files::make_path_absolute("resources/ies/111621PN.IES");
@@ -289,9 +289,9 @@ namespace engine {
 
             //  Depth mask uniforms and drawing
             mask_fbo->bind_as(GL_FRAMEBUFFER);
-            glCullFace(GL_FRONT);
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            glViewport(0, 0, texture_dimension[0], texture_dimension[1]);
+            OpenGL3_Renderer::set_cull_face(GL_FRONT);
+            OpenGL3_Renderer::set_polygon_mode(GL_FILL);
+            OpenGL3_Renderer::set_viewport(0, 0, texture_dimension[0], texture_dimension[1]);
             OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             depthmask_shader->use();
@@ -310,8 +310,8 @@ namespace engine {
 
             //  RSM uniforms and drawing
             rsm_fbo->bind_as(GL_FRAMEBUFFER);
-            glCullFace(GL_BACK);
-            glViewport(0, 0, texture_dimension[0], texture_dimension[1]);
+            OpenGL3_Renderer::set_cull_face(GL_BACK);
+            OpenGL3_Renderer::set_viewport(0, 0, texture_dimension[0], texture_dimension[1]);
             OpenGL3_Renderer::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             rsm_generation_shader->use();
@@ -353,7 +353,7 @@ namespace engine {
 
 
             //  Final pass for rendering the scene
-            glViewport(0, 0, viewport_dimension[2], viewport_dimension[3]);
+            OpenGL3_Renderer::set_viewport(0, 0, viewport_dimension[2], viewport_dimension[3]);
             OpenGL3_Renderer::set_clear_color(0.0f, 0.0f, 0.0f, 1.0f);
             OpenGL3_Renderer::clear();
 
@@ -362,14 +362,14 @@ namespace engine {
                 draw_shader->set_bool(11, hide_direct_component);
             }
 
-            glEnable(GL_FRAMEBUFFER_SRGB);
+            OpenGL3_Renderer::enable(GL_FRAMEBUFFER_SRGB);
             draw_indirect_light ? draw_scene(glm::vec3(), camera_view_matrix, camera_projection_matrix, draw_shader)
                                 : draw_scene(
                     glm::vec3(), camera_view_matrix, camera_projection_matrix, no_indirect_shader);
-            glDisable(GL_FRAMEBUFFER_SRGB);
+            OpenGL3_Renderer::disable(GL_FRAMEBUFFER_SRGB);
             
             if (ies_light_wireframe) {
-                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                OpenGL3_Renderer::set_polygon_mode(GL_LINE);
                 wireframe_shader->use();
                 matrices_buffer->bind_to_uniform_buffer_target();
                 matrices_buffer->copy_to_buffer(0, 4 * 4 * 4, glm::value_ptr(ies_light_model_matrix));
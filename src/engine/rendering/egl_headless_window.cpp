@@ -0,0 +1,166 @@
+#include "egl_headless_window.h"
+
+#include "opengl3_state_cache.h"
+
+#include <fmt/core.h>
+#include <glad/glad.h>
+
+#include <string_view>
+
+namespace engine {
+    EGL_Headless_Window::EGL_Headless_Window(const WindowProperties& properties)
+            : creation_time{std::chrono::steady_clock::now()}, width{properties.width}, height{properties.height} {
+        display = open_display();
+        auto major = EGLint{0};
+        auto minor = EGLint{0};
+        if (display == EGL_NO_DISPLAY || eglInitialize(display, &major, &minor) == EGL_FALSE) {
+            fmt::print("[EGL HEADLESS WINDOW] Failed to open an EGL display, error {:#x}\n", eglGetError());
+            return;
+        }
+
+        context = std::make_unique<OpenGL3_EGL_Context>(display);
+        if (!context->is_valid()) {
+            return;
+        }
+        context->initialize();
+        create_framebuffer();
+
+        fmt::print("[EGL HEADLESS WINDOW] Creation of OpenGL context, version {}, on {} through EGL {}.{}, "
+                   "was successful.\n", reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                   reinterpret_cast<const char*>(glGetString(GL_RENDERER)), major, minor);
+    }
+
+    EGL_Headless_Window::~EGL_Headless_Window() {
+        if (is_open()) {
+            context->make_current();
+            destroy_framebuffer();
+        }
+        context.reset();
+        if (display != EGL_NO_DISPLAY) {
+            eglTerminate(display);
+        }
+        eglReleaseThread();
+    }
+
+    bool EGL_Headless_Window::is_open() const noexcept {
+        return context != nullptr && context->is_valid();
+    }
+
+    void EGL_Headless_Window::on_update() {
+        context->swap_buffers();
+    }
+
+    unsigned EGL_Headless_Window::get_width() const noexcept {
+        return width;
+    }
+
+    unsigned EGL_Headless_Window::get_height() const noexcept {
+        return height;
+    }
+
+    void *EGL_Headless_Window::get_native_window() const noexcept {
+        return nullptr;
+    }
+
+    double EGL_Headless_Window::get_time() const noexcept {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - creation_time).count();
+    }
+
+    void EGL_Headless_Window::link_to_event_queue(const Window::EventQueueAccess& push_function) noexcept {
+        event_pump_function = push_function;
+    }
+
+    std::unique_ptr<RenderingContext> EGL_Headless_Window::create_shared_context() const {
+        return context->create_shared_context();
+    }
+
+    void EGL_Headless_Window::resize(const unsigned new_width, const unsigned new_height) {
+        if (new_width == width && new_height == height) {
+            return;
+        }
+        width = new_width;
+        height = new_height;
+        destroy_framebuffer();
+        create_framebuffer();
+        if (event_pump_function) {
+            event_pump_function(std::make_unique<WindowResizedEvent>(width, height));
+        }
+    }
+
+    std::vector<std::uint8_t> EGL_Headless_Window::read_pixels() const {
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+        OpenGL3_State_Cache::bind_framebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_BYTE,
+                     pixels.data());
+        return pixels;
+    }
+
+    EGLDisplay EGL_Headless_Window::open_display() {
+        const auto* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        const auto has_extension = [client_extensions](const std::string_view name) {
+            return client_extensions != nullptr &&
+                   std::string_view(client_extensions).find(name) != std::string_view::npos;
+        };
+        const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (get_platform_display == nullptr) {
+            return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        if (has_extension("EGL_MESA_platform_surfaceless")) {
+            return get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (has_extension("EGL_EXT_platform_device")) {
+            const auto query_devices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(
+                    eglGetProcAddress("eglQueryDevicesEXT"));
+            auto device = EGLDeviceEXT{};
+            auto devices_count = EGLint{0};
+            if (query_devices != nullptr && query_devices(1, &device, &devices_count) == EGL_TRUE &&
+                devices_count > 0) {
+                return get_platform_display(EGL_PLATFORM_DEVICE_EXT, device, nullptr);
+            }
+        }
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    void EGL_Headless_Window::create_framebuffer() {
+        glGenRenderbuffers(1, &color_renderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+        glGenRenderbuffers(1, &depth_stencil_renderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_stencil_renderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, static_cast<GLsizei>(width),
+                              static_cast<GLsizei>(height));
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &framebuffer);
+        OpenGL3_State_Cache::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_renderbuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                  depth_stencil_renderbuffer);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            fmt::print("[EGL HEADLESS WINDOW] The {}x{} framebuffer is incomplete\n", width, height);
+        }
+
+        //  Without a surface there is no default framebuffer, and the viewport starts out empty
+        OpenGL3_State_Cache::set_default_framebuffer(framebuffer);
+        OpenGL3_State_Cache::set_viewport(0, 0, static_cast<int>(width), static_cast<int>(height));
+    }
+
+    void EGL_Headless_Window::destroy_framebuffer() {
+        OpenGL3_State_Cache::set_default_framebuffer(0);
+        OpenGL3_State_Cache::forget_framebuffer(framebuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &color_renderbuffer);
+        glDeleteRenderbuffers(1, &depth_stencil_renderbuffer);
+        framebuffer = 0;
+        color_renderbuffer = 0;
+        depth_stencil_renderbuffer = 0;
+    }
+
+    EGL_Headless_Window* EGL_Headless_Window::convert_from(Window* abstract_window) {
+        return dynamic_cast<EGL_Headless_Window*>(abstract_window);
+    }
+}
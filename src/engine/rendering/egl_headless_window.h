@@ -0,0 +1,74 @@
+#ifndef EGL_HEADLESS_WINDOW_H
+#define EGL_HEADLESS_WINDOW_H
+
+#include "window.h"
+#include "opengl3_egl_context.h"
+#include "../events/window_events.h"
+
+#include <EGL/egl.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+    //  A window without a display server, for batch and benchmark runs: the frame goes to a framebuffer object
+    //  that stands in for the default framebuffer, and is read back rather than presented. Nothing waits
+    //  for a vertical blank and no input events are ever sent.
+    //  Uses Mesa's surfaceless platform when there is one (llvmpipe works), otherwise the first EGL device.
+    class EGL_Headless_Window : public Window {
+    public:
+        static EGL_Headless_Window* convert_from(Window* abstract_window);
+
+        explicit EGL_Headless_Window(const WindowProperties& properties);
+
+        EGL_Headless_Window(const EGL_Headless_Window& other) = delete;
+        EGL_Headless_Window(EGL_Headless_Window&& other) = delete;
+        EGL_Headless_Window& operator=(const EGL_Headless_Window& other) = delete;
+        EGL_Headless_Window& operator=(EGL_Headless_Window&& other) = delete;
+        virtual ~EGL_Headless_Window() override;
+
+        //  False when no display or context could be had, e.g. no EGL driver is installed
+        [[nodiscard]] bool is_open() const noexcept;
+
+        void on_update() override;
+
+        [[nodiscard]] unsigned get_width() const noexcept override;
+
+        [[nodiscard]] unsigned get_height() const noexcept override;
+
+        //  There is no native window; nullptr
+        [[nodiscard]] void *get_native_window() const noexcept override;
+
+        [[nodiscard]] double get_time() const noexcept override;
+
+        void link_to_event_queue(const EventQueueAccess& push_function) noexcept override;
+
+        [[nodiscard]] std::unique_ptr<RenderingContext> create_shared_context() const override;
+
+        //  Reallocates the framebuffer and sends a WindowResizedEvent, as a resized window would
+        void resize(unsigned new_width, unsigned new_height);
+
+        //  RGBA8 of the last frame, bottom row first
+        [[nodiscard]] std::vector<std::uint8_t> read_pixels() const;
+
+    private:
+        [[nodiscard]] static EGLDisplay open_display();
+
+        void create_framebuffer();
+        void destroy_framebuffer();
+
+        EGLDisplay display = EGL_NO_DISPLAY;
+        std::unique_ptr<OpenGL3_EGL_Context> context;
+        unsigned int framebuffer = 0;
+        unsigned int color_renderbuffer = 0;
+        unsigned int depth_stencil_renderbuffer = 0;
+        std::chrono::steady_clock::time_point creation_time;
+
+        unsigned width;
+        unsigned height;
+        EventQueueAccess event_pump_function;
+    };
+}
+
+#endif //EGL_HEADLESS_WINDOW_H
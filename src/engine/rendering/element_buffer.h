@@ -1,6 +1,8 @@
 #ifndef ELEMENT_BUFFER_H
 #define ELEMENT_BUFFER_H
 
+#include "opengl3_state_cache.h"
+
 #include <glad/glad.h>
 
 namespace engine {
@@ -9,6 +11,8 @@ namespace engine {
         explicit ElementBuffer(const unsigned int* indices, const unsigned int count)
                 : id{0}, size{count} {
             glGenBuffers(1, &id);
+            //  The element array binding is vertex array state; vertex arrays stay bound after draws
+            OpenGL3_State_Cache::bind_vertex_array(0);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, size * sizeof(unsigned int), indices, GL_STATIC_DRAW);
         }
@@ -22,7 +26,10 @@ namespace engine {
                                 indices.size()) {};
 
 
-        ~ElementBuffer() { glDeleteBuffers(1, &id); }
+        ~ElementBuffer() {
+            OpenGL3_State_Cache::forget_buffer(id);
+            glDeleteBuffers(1, &id);
+        }
 
         void bind() const {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
@@ -32,10 +39,36 @@ namespace engine {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
 
+        void bind_to_storage_binding_point(const unsigned int binding_point) const {
+            OpenGL3_State_Cache::bind_buffer_base(GL_SHADER_STORAGE_BUFFER, binding_point, id);
+        }
+
         unsigned int get_count() const {
             return size;
         }
 
+        unsigned int get_id() const {
+            return id;
+        }
+
+        //  Goes through GL_COPY_WRITE_BUFFER, so that the element buffer of the bound VAO is left untouched
+        void set_sub_data(const unsigned int first_index, const unsigned int* indices, const unsigned int count) const {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, first_index * sizeof(unsigned int), count * sizeof(unsigned int),
+                            indices);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+
+        //  destination_index counts indices, not bytes
+        void copy_to(const ElementBuffer& destination, const unsigned int destination_index) const {
+            glBindBuffer(GL_COPY_READ_BUFFER, id);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, destination.id);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                                destination_index * sizeof(unsigned int), size * sizeof(unsigned int));
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+
     private:
         unsigned int id;
         unsigned int size;
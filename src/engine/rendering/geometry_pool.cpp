@@ -0,0 +1,201 @@
+#include "geometry_pool.h"
+
+#include <algorithm>
+
+namespace engine {
+    GeometryPool::GeometryPool(const VertexBufferLayout& vertex_layout, const unsigned int initial_vertex_capacity,
+                               const unsigned int initial_index_capacity)
+            : layout{vertex_layout}, vertex_stride{vertex_layout.get_stride()},
+              vertices_capacity{std::max(initial_vertex_capacity, 1u)},
+              indices_capacity{std::max(initial_index_capacity, 1u)} {
+        vbo = std::make_shared<VertexBuffer>(vertices_capacity * vertex_stride);
+        vbo->set_buffer_layout(layout);
+        ebo = std::make_shared<ElementBuffer>(nullptr, indices_capacity);
+        vao.set_vbo(std::shared_ptr<VertexBuffer>(vbo));
+        vao.set_ebo(std::shared_ptr<ElementBuffer>(ebo));
+        vao.unbind();
+        free_vertices.push_back(FreeBlock{0, vertices_capacity});
+        free_indices.push_back(FreeBlock{0, indices_capacity});
+    }
+
+    GeometryRange GeometryPool::allocate(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+        const auto vertex_count = static_cast<unsigned int>(vertices.size() * sizeof(float) / vertex_stride);
+        const auto index_count = static_cast<unsigned int>(indices.size());
+        const auto range = reserve(vertex_count, index_count);
+        vbo->set_sub_data(range.base_vertex * vertex_stride, vertex_count * vertex_stride, vertices.data());
+        ebo->set_sub_data(range.first_index, indices.data(), index_count);
+        return range;
+    }
+
+    GeometryRange GeometryPool::allocate_from(const unsigned int source_buffer, const unsigned int vertices_offset,
+                                              const unsigned int vertex_count, const unsigned int indices_offset,
+                                              const unsigned int index_count) {
+        const auto range = reserve(vertex_count, index_count);
+        glBindBuffer(GL_COPY_READ_BUFFER, source_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vbo->get_id());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, vertices_offset,
+                            range.base_vertex * vertex_stride, vertex_count * vertex_stride);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ebo->get_id());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, indices_offset,
+                            range.first_index * sizeof(unsigned int), index_count * sizeof(unsigned int));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        return range;
+    }
+
+    GeometryRange GeometryPool::reserve(const unsigned int vertex_count, const unsigned int index_count) {
+        auto base_vertex = 0u;
+        if (!take_from(free_vertices, vertex_count, base_vertex)) {
+            grow_vertices(vertex_count);
+            [[maybe_unused]] const auto taken = take_from(free_vertices, vertex_count, base_vertex);
+        }
+        auto first_index = 0u;
+        if (!take_from(free_indices, index_count, first_index)) {
+            grow_indices(index_count);
+            [[maybe_unused]] const auto taken = take_from(free_indices, index_count, first_index);
+        }
+        vertices_in_use += vertex_count;
+        indices_in_use += index_count;
+        return GeometryRange{static_cast<int>(base_vertex), vertex_count, first_index, index_count};
+    }
+
+    void GeometryPool::release(const GeometryRange& range) {
+        give_back(free_vertices, FreeBlock{static_cast<unsigned int>(range.base_vertex), range.vertex_count});
+        give_back(free_indices, FreeBlock{range.first_index, range.index_count});
+        vertices_in_use -= range.vertex_count;
+        indices_in_use -= range.index_count;
+    }
+
+    const VertexArray& GeometryPool::vertex_array() const {
+        return vao;
+    }
+
+    const std::shared_ptr<VertexBuffer>& GeometryPool::vertex_buffer() const {
+        return vbo;
+    }
+
+    const std::shared_ptr<ElementBuffer>& GeometryPool::element_buffer() const {
+        return ebo;
+    }
+
+    unsigned int GeometryPool::vertex_capacity() const {
+        return vertices_capacity;
+    }
+
+    unsigned int GeometryPool::index_capacity() const {
+        return indices_capacity;
+    }
+
+    unsigned int GeometryPool::used_vertices() const {
+        return vertices_in_use;
+    }
+
+    unsigned int GeometryPool::used_indices() const {
+        return indices_in_use;
+    }
+
+    std::size_t GeometryPool::free_blocks() const {
+        return free_vertices.size() + free_indices.size();
+    }
+
+    bool GeometryPool::take_from(std::vector<FreeBlock>& free_list, const unsigned int count, unsigned int& offset) {
+        const auto block = std::find_if(std::begin(free_list), std::end(free_list),
+                                        [count](const FreeBlock& b) { return b.count >= count; });
+        if (block == std::end(free_list)) {
+            return false;
+        }
+        offset = block->offset;
+        block->offset += count;
+        block->count -= count;
+        if (block->count == 0) {
+            free_list.erase(block);
+        }
+        return true;
+    }
+
+    void GeometryPool::give_back(std::vector<FreeBlock>& free_list, const FreeBlock block) {
+        if (block.count == 0) {
+            return;
+        }
+        //  The list is kept sorted by offset, so only the neighbours of the insertion point can be merged
+        auto next = std::lower_bound(std::begin(free_list), std::end(free_list), block.offset,
+                                     [](const FreeBlock& b, const unsigned int offset) { return b.offset < offset; });
+        auto inserted = free_list.insert(next, block);
+        if (const auto following = std::next(inserted);
+                following != std::end(free_list) && inserted->offset + inserted->count == following->offset) {
+            inserted->count += following->count;
+            inserted = std::prev(free_list.erase(following));
+        }
+        if (inserted != std::begin(free_list)) {
+            if (const auto previous = std::prev(inserted); previous->offset + previous->count == inserted->offset) {
+                previous->count += inserted->count;
+                free_list.erase(inserted);
+            }
+        }
+    }
+
+    void GeometryPool::grow_vertices(const unsigned int minimum_free_vertices) {
+        const auto old_capacity = vertices_capacity;
+        vertices_capacity = std::max(old_capacity * 2, old_capacity + minimum_free_vertices);
+
+        auto grown_vbo = std::make_shared<VertexBuffer>(vertices_capacity * vertex_stride);
+        grown_vbo->set_buffer_layout(layout);
+        vbo->copy_to(*grown_vbo, 0);
+        vbo = std::move(grown_vbo);
+        vao.set_vbo(std::shared_ptr<VertexBuffer>(vbo));
+        vao.unbind();
+        give_back(free_vertices, FreeBlock{old_capacity, vertices_capacity - old_capacity});
+    }
+
+    void GeometryPool::grow_indices(const unsigned int minimum_free_indices) {
+        const auto old_capacity = indices_capacity;
+        indices_capacity = std::max(old_capacity * 2, old_capacity + minimum_free_indices);
+
+        //  Created while no VAO is bound, so that the pool's VAO keeps the old buffer until set_ebo
+        vao.unbind();
+        auto grown_ebo = std::make_shared<ElementBuffer>(nullptr, indices_capacity);
+        ebo->copy_to(*grown_ebo, 0);
+        ebo = std::move(grown_ebo);
+        vao.set_ebo(std::shared_ptr<ElementBuffer>(ebo));
+        vao.unbind();
+        give_back(free_indices, FreeBlock{old_capacity, indices_capacity - old_capacity});
+    }
+
+    GeometryAllocation::GeometryAllocation(std::shared_ptr<GeometryPool> pool_owner, const GeometryRange& range_in_pool)
+            : owner{std::move(pool_owner)}, allocated_range{range_in_pool} {}
+
+    GeometryAllocation::GeometryAllocation(GeometryAllocation&& other) noexcept
+            : owner{std::move(other.owner)}, allocated_range{other.allocated_range} {
+        other.owner = nullptr;
+    }
+
+    GeometryAllocation& GeometryAllocation::operator=(GeometryAllocation&& other) noexcept {
+        if (this != &other) {
+            if (owner) {
+                owner->release(allocated_range);
+            }
+            owner = std::move(other.owner);
+            allocated_range = other.allocated_range;
+            other.owner = nullptr;
+        }
+        return *this;
+    }
+
+    GeometryAllocation::~GeometryAllocation() {
+        if (owner) {
+            owner->release(allocated_range);
+        }
+    }
+
+    bool GeometryAllocation::is_valid() const {
+        return owner != nullptr;
+    }
+
+    const GeometryRange& GeometryAllocation::range() const {
+        return allocated_range;
+    }
+
+    const std::shared_ptr<GeometryPool>& GeometryAllocation::pool() const {
+        return owner;
+    }
+}
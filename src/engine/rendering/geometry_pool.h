@@ -0,0 +1,100 @@
+#ifndef GEOMETRY_POOL_H
+#define GEOMETRY_POOL_H
+
+#include "vertex_array.h"
+
+#include <memory>
+#include <vector>
+
+namespace engine {
+    //  Where a mesh lives inside a GeometryPool; base_vertex is added to every index when drawing
+    struct GeometryRange {
+        int base_vertex = 0;
+        unsigned int vertex_count = 0;
+        unsigned int first_index = 0;
+        unsigned int index_count = 0;
+    };
+
+    //  Vertices and indices of many meshes sharing one layout, suballocated from one vertex buffer and one
+    //  element buffer bound to a single VAO. Released ranges go back to first-fit free lists whose adjacent
+    //  blocks are merged, so meshes can be unloaded and reloaded without fragmenting the buffers; when no
+    //  block is large enough the buffers grow geometrically and the old content is copied on the GPU.
+    class GeometryPool {
+    public:
+        GeometryPool(const VertexBufferLayout& vertex_layout, unsigned int initial_vertex_capacity,
+                     unsigned int initial_index_capacity);
+
+        GeometryPool(const GeometryPool& other) = delete;
+        GeometryPool(GeometryPool&& other) = delete;
+        GeometryPool& operator=(const GeometryPool& other) = delete;
+        GeometryPool& operator=(GeometryPool&& other) = delete;
+        ~GeometryPool() = default;
+
+        //  vertices are interleaved following the pool's layout
+        [[nodiscard]] GeometryRange allocate(const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
+        //  Same as allocate, with the data copied on the GPU from source_buffer, starting at the given byte offsets
+        [[nodiscard]] GeometryRange allocate_from(unsigned int source_buffer, unsigned int vertices_offset,
+                                                  unsigned int vertex_count, unsigned int indices_offset,
+                                                  unsigned int index_count);
+        void release(const GeometryRange& range);
+
+        [[nodiscard]] const VertexArray& vertex_array() const;
+        [[nodiscard]] const std::shared_ptr<VertexBuffer>& vertex_buffer() const;
+        [[nodiscard]] const std::shared_ptr<ElementBuffer>& element_buffer() const;
+
+        [[nodiscard]] unsigned int vertex_capacity() const;
+        [[nodiscard]] unsigned int index_capacity() const;
+        [[nodiscard]] unsigned int used_vertices() const;
+        [[nodiscard]] unsigned int used_indices() const;
+        [[nodiscard]] std::size_t free_blocks() const;
+
+    private:
+        struct FreeBlock {
+            unsigned int offset;
+            unsigned int count;
+        };
+
+        [[nodiscard]] GeometryRange reserve(unsigned int vertex_count, unsigned int index_count);
+        [[nodiscard]] static bool take_from(std::vector<FreeBlock>& free_list, unsigned int count, unsigned int& offset);
+        static void give_back(std::vector<FreeBlock>& free_list, FreeBlock block);
+
+        void grow_vertices(unsigned int minimum_free_vertices);
+        void grow_indices(unsigned int minimum_free_indices);
+
+        VertexBufferLayout layout;
+        unsigned int vertex_stride;
+        unsigned int vertices_capacity;
+        unsigned int indices_capacity;
+        unsigned int vertices_in_use = 0;
+        unsigned int indices_in_use = 0;
+
+        VertexArray vao;
+        std::shared_ptr<VertexBuffer> vbo;
+        std::shared_ptr<ElementBuffer> ebo;
+        std::vector<FreeBlock> free_vertices;
+        std::vector<FreeBlock> free_indices;
+    };
+
+    //  Owns a range of a pool and gives it back when destroyed
+    class GeometryAllocation {
+    public:
+        GeometryAllocation() = default;
+        GeometryAllocation(std::shared_ptr<GeometryPool> pool_owner, const GeometryRange& range_in_pool);
+
+        GeometryAllocation(const GeometryAllocation& other) = delete;
+        GeometryAllocation(GeometryAllocation&& other) noexcept;
+        GeometryAllocation& operator=(const GeometryAllocation& other) = delete;
+        GeometryAllocation& operator=(GeometryAllocation&& other) noexcept;
+        ~GeometryAllocation();
+
+        [[nodiscard]] bool is_valid() const;
+        [[nodiscard]] const GeometryRange& range() const;
+        [[nodiscard]] const std::shared_ptr<GeometryPool>& pool() const;
+
+    private:
+        std::shared_ptr<GeometryPool> owner;
+        GeometryRange allocated_range;
+    };
+}
+
+#endif //GEOMETRY_POOL_H
@@ -29,10 +29,18 @@ namespace engine {
         return window;
     }
 
+    double GLFW_Window_Impl::get_time() const noexcept {
+        return glfwGetTime();
+    }
+
     void GLFW_Window_Impl::link_to_event_queue(const Window::EventQueueAccess& push_function) noexcept {
         data.event_pump_function = push_function;
     }
 
+    std::unique_ptr<RenderingContext> GLFW_Window_Impl::create_shared_context() const {
+        return context->create_shared_context();
+    }
+
     void GLFW_Window_Impl::initialize(const WindowProperties& properties) {
         data.title = properties.title;
         data.width = properties.width;
@@ -59,7 +67,7 @@ namespace engine {
         context = RenderingContext::create(window);
         context->initialize();
         glfwSetWindowUserPointer(window, &data);
-        glfwSwapInterval(1);
+        glfwSwapInterval(properties.vsync ? 1 : 0);
 
         glfwSetWindowSizeCallback(window, window_resize_callback);
         glfwSetWindowCloseCallback(window, window_close_callback);
@@ -28,8 +28,12 @@ namespace engine {
 
         [[nodiscard]] void *get_native_window() const noexcept override;
 
+        [[nodiscard]] double get_time() const noexcept override;
+
         void link_to_event_queue(const EventQueueAccess& push_function) noexcept override;
 
+        [[nodiscard]] std::unique_ptr<RenderingContext> create_shared_context() const override;
+
     private:
         virtual void initialize(const WindowProperties& properties);
 
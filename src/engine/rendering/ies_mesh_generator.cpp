@@ -0,0 +1,55 @@
+#include "ies_mesh_generator.h"
+
+namespace engine {
+    IES_Mesh_Generator::IES_Mesh_Generator(std::shared_ptr<Shader> mesh_generation_shader)
+            : generation_shader(std::move(mesh_generation_shader)) {}
+
+    bool IES_Mesh_Generator::is_supported() {
+        return GLAD_GL_VERSION_4_3 != 0;
+    }
+
+    void IES_Mesh_Generator::generate_into(VertexArray& target, IES_Profile_Atlas& atlas,
+                                           const unsigned int profile_layer, const float max_candela,
+                                           const unsigned int subdivision) {
+        constexpr auto floats_per_vertex = 6u;
+        constexpr auto indices_per_quad = 6u;
+        constexpr auto work_group_size = 8u;
+
+        const auto horizontal_samples = 4 * subdivision + 1;
+        const auto vertical_samples = 2 * subdivision + 1;
+        const auto vertices_number = horizontal_samples * vertical_samples;
+        const auto indices_number = (horizontal_samples - 1) * (vertical_samples - 1) * indices_per_quad;
+
+        //  Buffers are only reallocated when the density changes; their content never goes through the CPU
+        if (target.get_vbo().get() != generated_buffer ||
+            vertices_number != generated_vertices || indices_number != generated_indices) {
+            auto vbo = std::make_shared<VertexBuffer>(vertices_number * floats_per_vertex * sizeof(float));
+            vbo->set_buffer_layout(VertexBufferLayout({
+                                                              VertexBufferElement(ShaderDataType::Float3,
+                                                                                  "position"),
+                                                              VertexBufferElement(ShaderDataType::Float3,
+                                                                                  "normal")}));
+            target.set_vbo(std::move(vbo));
+            target.set_ebo(std::make_shared<ElementBuffer>(nullptr, indices_number));
+            target.unbind();
+            generated_buffer = target.get_vbo().get();
+            generated_vertices = vertices_number;
+            generated_indices = indices_number;
+        }
+
+        generation_shader->use();
+        atlas.bind_to_slot(0);
+        generation_shader->set_int(0, 0);
+        generation_shader->set_int(1, static_cast<int>(profile_layer));
+        generation_shader->set_uint(2, horizontal_samples);
+        generation_shader->set_uint(3, vertical_samples);
+        generation_shader->set_float(4, max_candela);
+        target.get_vbo()->bind_to_storage_binding_point(0);
+        target.get_ebo()->bind_to_storage_binding_point(1);
+
+        glDispatchCompute((horizontal_samples + work_group_size - 1) / work_group_size,
+                          (vertical_samples + work_group_size - 1) / work_group_size,
+                          1);
+        glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT);
+    }
+}
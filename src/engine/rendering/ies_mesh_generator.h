@@ -0,0 +1,39 @@
+#ifndef IES_MESH_GENERATOR_H
+#define IES_MESH_GENERATOR_H
+
+#include "ies_profile_atlas.h"
+#include "shader.h"
+#include "vertex_array.h"
+
+#include <memory>
+
+namespace engine {
+    //  Builds the photometric solid of an atlas profile with a compute shader, writing positions, normals
+    //  and indices straight into the buffers of the target VertexArray; the CPU counterpart is
+    //  ies::adapter::IES_Mesh::interpolate_from.
+    class IES_Mesh_Generator {
+    public:
+        explicit IES_Mesh_Generator(std::shared_ptr<Shader> mesh_generation_shader);
+
+        IES_Mesh_Generator(const IES_Mesh_Generator& other) = delete;
+        IES_Mesh_Generator(IES_Mesh_Generator&& other) = delete;
+        IES_Mesh_Generator& operator=(const IES_Mesh_Generator& other) = delete;
+        IES_Mesh_Generator& operator=(IES_Mesh_Generator&& other) = delete;
+        ~IES_Mesh_Generator() = default;
+
+        [[nodiscard]] static bool is_supported();
+
+        //  The solid gets 4 * subdivision + 1 samples around the vertical axis and
+        //  2 * subdivision + 1 from the top to the bottom pole
+        void generate_into(VertexArray& target, IES_Profile_Atlas& atlas, unsigned int profile_layer,
+                           float max_candela, unsigned int subdivision);
+
+    private:
+        std::shared_ptr<Shader> generation_shader;
+        const VertexBuffer* generated_buffer = nullptr;
+        unsigned int generated_vertices = 0;
+        unsigned int generated_indices = 0;
+    };
+}
+
+#endif //IES_MESH_GENERATOR_H
@@ -0,0 +1,240 @@
+#include "ies_mesh_lod_chain.h"
+
+#include "../../utility/cpu_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace engine {
+    void IES_Mesh_LOD_Chain::build_from(const ies::IES_Document& document,
+                                        const std::span<const uint16_t> interpolated_points_per_level) {
+        upload_levels(mesh_levels(document, interpolated_points_per_level));
+    }
+
+    IES_Mesh_Levels IES_Mesh_LOD_Chain::mesh_levels(const ies::IES_Document& document,
+                                                    const std::span<const uint16_t> interpolated_points_per_level) {
+        PROFILE_ZONE("IES meshing");
+        IES_Mesh_Levels levels;
+        levels.meshes.reserve(interpolated_points_per_level.size());
+        for (const auto points_per_edge : interpolated_points_per_level) {
+            levels.meshes.push_back(points_per_edge == 0
+                                    ? ies::adapter::IES_Mesh(document)
+                                    : ies::adapter::IES_Mesh::interpolate_from(document, points_per_edge));
+        }
+        levels.deviations.reserve(levels.meshes.size());
+        for (const auto& mesh : levels.meshes) {
+            levels.deviations.push_back(&mesh == &levels.meshes.front()
+                                        ? 0.0f : impl_details::max_deviation(mesh, levels.meshes.front()));
+        }
+        return levels;
+    }
+
+    void IES_Mesh_LOD_Chain::upload_levels(const IES_Mesh_Levels& levels) {
+        const auto& meshes = levels.meshes;
+        lods.clear();
+        lods.reserve(meshes.size());
+        furthest_vertex_distance = 0.0f;
+        if (!meshes.empty()) {
+            for (const auto& p : meshes.front().positions_view()) {
+                furthest_vertex_distance = std::max(furthest_vertex_distance, glm::length(p));
+            }
+        }
+        for (std::size_t i = 0; i < meshes.size(); ++i) {
+            lods.push_back(upload(meshes[i], i < levels.deviations.size() ? levels.deviations[i] : 0.0f));
+        }
+    }
+
+    std::size_t IES_Mesh_LOD_Chain::levels() const {
+        return lods.size();
+    }
+
+    const IES_Mesh_LOD& IES_Mesh_LOD_Chain::level(const std::size_t level_index) const {
+        return lods[std::min(level_index, lods.size() - 1)];
+    }
+
+    float IES_Mesh_LOD_Chain::max_distance_to_vertex() const {
+        return furthest_vertex_distance;
+    }
+
+    std::size_t IES_Mesh_LOD_Chain::select_level(const float world_scale, const float distance_to_camera,
+                                                 const float projection_scale, const float max_screen_error) const {
+        const auto distance = std::max(distance_to_camera, 0.0001f);
+        for (auto i = lods.size(); i > 0; --i) {
+            const auto screen_error = lods[i - 1].geometric_error * world_scale / distance * projection_scale;
+            if (screen_error <= max_screen_error) {
+                return i - 1;
+            }
+        }
+        return 0;
+    }
+
+    IES_Mesh_LOD IES_Mesh_LOD_Chain::upload(const ies::adapter::IES_Mesh& mesh, const float geometric_error) {
+        const auto indices = mesh.indices_view();
+        const auto vertices_size = static_cast<unsigned int>(mesh.interleaved_vertices_size() * sizeof(float));
+        auto vbo = std::make_shared<VertexBuffer>(vertices_size);
+        auto* mapped_vertices = static_cast<float*>(vbo->map_for_writing(0, vertices_size));
+        if (mapped_vertices != nullptr) {
+            mesh.write_vertices_to({mapped_vertices, mesh.interleaved_vertices_size()});
+        }
+        //  A failed map or a store corrupted while mapped leaves the buffer undefined, upload it the plain way
+        if (mapped_vertices == nullptr || !vbo->unmap()) {
+            const auto vertices = mesh.get_vertices();
+            vbo->set_data(vertices_size, vertices.data());
+        }
+        vbo->set_buffer_layout(VertexBufferLayout({
+                                                          VertexBufferElement(ShaderDataType::Float3,
+                                                                              "position"),
+                                                          VertexBufferElement(ShaderDataType::Float3,
+                                                                              "normal")}));
+        auto vao = std::make_unique<VertexArray>();
+        vao->set_vbo(std::move(vbo));
+        vao->set_ebo(std::make_shared<ElementBuffer>(indices.data(), static_cast<unsigned int>(indices.size())));
+        vao->unbind();
+        return IES_Mesh_LOD{std::move(vao), geometric_error, static_cast<unsigned int>(indices.size() / 3)};
+    }
+}
+
+namespace engine::impl_details {
+    TriangleGrid::TriangleGrid(const std::span<const glm::vec3> mesh_positions,
+                               const std::span<const unsigned int> mesh_indices)
+            : positions(mesh_positions), indices(mesh_indices) {
+        const auto triangles_count = indices.size() / 3;
+        if (positions.empty() || triangles_count == 0) {
+            cell_starts.assign(2, 0);
+            return;
+        }
+        auto lowest = positions.front();
+        auto highest = positions.front();
+        for (const auto& p : positions) {
+            lowest = glm::min(lowest, p);
+            highest = glm::max(highest, p);
+        }
+        auto edges_length = 0.0f;
+        for (std::size_t i = 0; i < triangles_count * 3; i += 3) {
+            edges_length += glm::distance(positions[indices[i]], positions[indices[i + 1]]);
+        }
+        //  Cells about as large as a triangle, but no more than max_cells_per_axis along the widest side
+        const auto extent = highest - lowest;
+        const auto widest = std::max({extent.x, extent.y, extent.z});
+        cell_size = std::max({edges_length / static_cast<float>(triangles_count),
+                              widest / static_cast<float>(max_cells_per_axis), 1.0e-6f});
+        origin = lowest;
+        cells = glm::clamp(glm::ivec3(extent / cell_size) + 1, 1, max_cells_per_axis);
+
+        //  Every triangle goes into the cells its bounding box overlaps; counted first, then filled
+        const auto for_each_cell_of = [this](const std::size_t triangle, const auto& action) {
+            const auto& a = positions[indices[triangle * 3]];
+            const auto& b = positions[indices[triangle * 3 + 1]];
+            const auto& c = positions[indices[triangle * 3 + 2]];
+            const auto first = cell_of(glm::min(a, glm::min(b, c)));
+            const auto last = cell_of(glm::max(a, glm::max(b, c)));
+            for (auto z = first.z; z <= last.z; ++z) {
+                for (auto y = first.y; y <= last.y; ++y) {
+                    for (auto x = first.x; x <= last.x; ++x) {
+                        action(cell_index({x, y, z}));
+                    }
+                }
+            }
+        };
+        cell_starts.assign(static_cast<std::size_t>(cells.x) * cells.y * cells.z + 1, 0);
+        for (std::size_t t = 0; t < triangles_count; ++t) {
+            for_each_cell_of(t, [this](const std::size_t cell) { ++cell_starts[cell + 1]; });
+        }
+        std::partial_sum(std::begin(cell_starts), std::end(cell_starts), std::begin(cell_starts));
+        cell_triangles.resize(cell_starts.back());
+        auto next_slot = std::vector<unsigned int>(std::begin(cell_starts), std::end(cell_starts) - 1);
+        for (std::size_t t = 0; t < triangles_count; ++t) {
+            for_each_cell_of(t, [&](const std::size_t cell) {
+                cell_triangles[next_slot[cell]++] = static_cast<unsigned int>(t);
+            });
+        }
+    }
+
+    float TriangleGrid::distance_to(const glm::vec3& point) const {
+        const auto center = cell_of(point);
+        const auto max_ring = std::max({cells.x, cells.y, cells.z});
+        auto closest = std::numeric_limits<float>::max();
+        //  Rings of cells around the one of the point, until no cell left outside the searched box can hold
+        //  anything closer; sides of the box on the border of the grid have nothing beyond them
+        const auto local = (point - origin) / cell_size;
+        for (auto ring = 0; ring <= max_ring; ++ring) {
+            const auto first = glm::max(center - ring, glm::ivec3(0));
+            const auto last = glm::min(center + ring, cells - 1);
+            for (auto z = first.z; z <= last.z; ++z) {
+                for (auto y = first.y; y <= last.y; ++y) {
+                    for (auto x = first.x; x <= last.x; ++x) {
+                        const auto offset = glm::abs(glm::ivec3(x, y, z) - center);
+                        if (std::max({offset.x, offset.y, offset.z}) != ring) {
+                            continue;
+                        }
+                        const auto cell = cell_index({x, y, z});
+                        for (auto k = cell_starts[cell]; k < cell_starts[cell + 1]; ++k) {
+                            const auto t = static_cast<std::size_t>(cell_triangles[k]) * 3;
+                            closest = std::min(closest, distance_to_triangle(point, positions[indices[t]],
+                                                                             positions[indices[t + 1]],
+                                                                             positions[indices[t + 2]]));
+                        }
+                    }
+                }
+            }
+            auto unsearched_distance = std::numeric_limits<float>::max();
+            for (auto axis = 0; axis < 3; ++axis) {
+                if (center[axis] - ring > 0) {
+                    const auto lower_side = static_cast<float>(center[axis] - ring);
+                    unsearched_distance = std::min(unsearched_distance, (local[axis] - lower_side) * cell_size);
+                }
+                if (center[axis] + ring < cells[axis] - 1) {
+                    const auto upper_side = static_cast<float>(center[axis] + ring + 1);
+                    unsearched_distance = std::min(unsearched_distance, (upper_side - local[axis]) * cell_size);
+                }
+            }
+            if (closest <= unsearched_distance) {
+                break;
+            }
+        }
+        return closest;
+    }
+
+    glm::ivec3 TriangleGrid::cell_of(const glm::vec3& point) const {
+        return glm::clamp(glm::ivec3(glm::floor((point - origin) / cell_size)), glm::ivec3(0), cells - 1);
+    }
+
+    std::size_t TriangleGrid::cell_index(const glm::ivec3& cell) const {
+        return (static_cast<std::size_t>(cell.z) * cells.y + cell.y) * cells.x + cell.x;
+    }
+
+    float distance_to_triangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        //  The plane is only closest when the point projects inside the triangle; degenerate triangles only
+        //  have their edges
+        const auto normal = glm::cross(b - a, c - a);
+        const auto double_area_squared = glm::dot(normal, normal);
+        if (double_area_squared > 0.0f &&
+            glm::dot(glm::cross(b - a, point - a), normal) >= 0.0f &&
+            glm::dot(glm::cross(c - b, point - b), normal) >= 0.0f &&
+            glm::dot(glm::cross(a - c, point - c), normal) >= 0.0f) {
+            return std::abs(glm::dot(point - a, normal)) / std::sqrt(double_area_squared);
+        }
+        const auto distance_to_segment = [&point](const glm::vec3& from, const glm::vec3& to) {
+            const auto direction = to - from;
+            const auto length_squared = glm::dot(direction, direction);
+            const auto t = length_squared > 0.0f
+                           ? std::clamp(glm::dot(point - from, direction) / length_squared, 0.0f, 1.0f) : 0.0f;
+            return glm::distance(point, from + t * direction);
+        };
+        return std::min({distance_to_segment(a, b), distance_to_segment(b, c), distance_to_segment(c, a)});
+    }
+
+    float max_deviation(const ies::adapter::IES_Mesh& mesh, const ies::adapter::IES_Mesh& reference) {
+        const auto farthest_vertex = [](const ies::adapter::IES_Mesh& from, const ies::adapter::IES_Mesh& to) {
+            const auto grid = TriangleGrid(to.positions_view(), to.indices_view());
+            auto farthest = 0.0f;
+            for (const auto& p : from.positions_view()) {
+                farthest = std::max(farthest, grid.distance_to(p));
+            }
+            return farthest;
+        };
+        return std::max(farthest_vertex(mesh, reference), farthest_vertex(reference, mesh));
+    }
+}
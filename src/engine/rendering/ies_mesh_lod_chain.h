@@ -0,0 +1,94 @@
+#ifndef IES_MESH_LOD_CHAIN_H
+#define IES_MESH_LOD_CHAIN_H
+
+#include "vertex_array.h"
+
+#include "../../ies/adapter/ies_mesh.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace engine {
+    struct IES_Mesh_LOD {
+        std::unique_ptr<VertexArray> vao;
+        //  Largest distance between the level and the finest one, measured from the vertices of each to the
+        //  surface of the other, in photometric (unscaled) units; 0 for the finest level
+        float geometric_error;
+        unsigned int triangles;
+    };
+
+    //  What the CPU half of IES_Mesh_LOD_Chain::build_from hands over to the GL half
+    struct IES_Mesh_Levels {
+        std::vector<ies::adapter::IES_Mesh> meshes;         //  From the finest
+        std::vector<float> deviations;                      //  Geometric errors, one per mesh
+    };
+
+    //  Photometric solids of the same document at decreasing interpolation densities; level 0 is the finest.
+    class IES_Mesh_LOD_Chain {
+    public:
+        IES_Mesh_LOD_Chain() = default;
+
+        IES_Mesh_LOD_Chain(const IES_Mesh_LOD_Chain& other) = delete;
+        IES_Mesh_LOD_Chain(IES_Mesh_LOD_Chain&& other) = delete;
+        IES_Mesh_LOD_Chain& operator=(const IES_Mesh_LOD_Chain& other) = delete;
+        IES_Mesh_LOD_Chain& operator=(IES_Mesh_LOD_Chain&& other) = delete;
+        ~IES_Mesh_LOD_Chain() = default;
+
+        //  One level per entry, ordered from the finest; 0 interpolated points keeps the measured grid
+        void build_from(const ies::IES_Document& document, std::span<const uint16_t> interpolated_points_per_level);
+        //  The CPU half of build_from, which touches no GL state and can run on any thread
+        [[nodiscard]] static IES_Mesh_Levels mesh_levels(const ies::IES_Document& document,
+                                                         std::span<const uint16_t> interpolated_points_per_level);
+        //  The GL half of build_from
+        void upload_levels(const IES_Mesh_Levels& levels);
+
+        [[nodiscard]] std::size_t levels() const;
+        [[nodiscard]] const IES_Mesh_LOD& level(std::size_t level_index) const;
+        [[nodiscard]] float max_distance_to_vertex() const;
+
+        //  Coarsest level whose geometric error, projected on screen, stays below max_screen_error pixels.
+        //  projection_scale is P[1][1] * viewport_height / 2 for a perspective projection P.
+        [[nodiscard]] std::size_t select_level(float world_scale, float distance_to_camera,
+                                               float projection_scale, float max_screen_error) const;
+
+    private:
+        [[nodiscard]] static IES_Mesh_LOD upload(const ies::adapter::IES_Mesh& mesh, float geometric_error);
+
+        std::vector<IES_Mesh_LOD> lods;
+        float furthest_vertex_distance = 0.0f;
+    };
+
+    namespace impl_details {
+        //  Uniform grid over the triangles of a mesh, for closest-point queries
+        class TriangleGrid {
+        public:
+            TriangleGrid(std::span<const glm::vec3> positions, std::span<const unsigned int> indices);
+
+            [[nodiscard]] float distance_to(const glm::vec3& point) const;
+
+        private:
+            static constexpr int max_cells_per_axis = 64;
+
+            [[nodiscard]] glm::ivec3 cell_of(const glm::vec3& point) const;
+            [[nodiscard]] std::size_t cell_index(const glm::ivec3& cell) const;
+
+            std::span<const glm::vec3> positions;
+            std::span<const unsigned int> indices;
+            glm::vec3 origin{0.0f};
+            float cell_size = 1.0f;
+            glm::ivec3 cells{1};
+            std::vector<unsigned int> cell_starts;      //  Triangles of cell i are cell_triangles[starts[i], starts[i+1])
+            std::vector<unsigned int> cell_triangles;
+        };
+
+        [[nodiscard]] float distance_to_triangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b,
+                                                 const glm::vec3& c);
+        //  Symmetric: the largest distance from a vertex of either mesh to the surface of the other
+        [[nodiscard]] float max_deviation(const ies::adapter::IES_Mesh& mesh, const ies::adapter::IES_Mesh& reference);
+    }
+}
+
+#endif //IES_MESH_LOD_CHAIN_H
@@ -0,0 +1,61 @@
+#include "ies_profile_atlas.h"
+
+namespace engine {
+    IES_Profile_Atlas::IES_Profile_Atlas(const int profile_width, const int profile_height)
+            : width(profile_width), height(profile_height) {}
+
+    unsigned int IES_Profile_Atlas::add_profile(const ies::IES_Document& document) {
+        const auto hash = ies::adapter::photometric_content_hash(document);
+        if (const auto it = layer_by_hash.find(hash); it != layer_by_hash.end()) {
+            return it->second;
+        }
+
+        const auto layer = profiles_count();
+        const auto intensities = ies::adapter::normalized_intensity_map(document, width, height);
+        layers_data.insert(std::end(layers_data), std::begin(intensities), std::end(intensities));
+        layer_by_hash.emplace(hash, layer);
+        needs_upload = true;
+        return layer;
+    }
+
+    std::optional<unsigned int> IES_Profile_Atlas::layer_of(const ies::IES_Document& document) const {
+        if (const auto it = layer_by_hash.find(ies::adapter::photometric_content_hash(document));
+                it != layer_by_hash.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    unsigned int IES_Profile_Atlas::profiles_count() const {
+        return static_cast<unsigned int>(layer_by_hash.size());
+    }
+
+    std::size_t IES_Profile_Atlas::memory_footprint() const {
+        //  GL_R16F texels
+        return static_cast<std::size_t>(width) * height * profiles_count() * 2;
+    }
+
+    void IES_Profile_Atlas::bind_to_slot(const unsigned int slot) {
+        if (needs_upload) {
+            upload();
+        }
+        if (texture) {
+            texture->bind_to_slot(slot);
+        }
+    }
+
+    void IES_Profile_Atlas::upload() {
+        //  Texture arrays cannot grow in place; profiles are few and added at load time, so the whole
+        //  array is recreated from the CPU copy whenever new layers appear
+        texture = OpenGL3_Texture2DArray_Builder()
+                .with_size(width, height, static_cast<int>(profiles_count()))
+                .with_texture_format(GL_R16F)
+                .with_data_format(GL_RED)
+                .using_underlying_data_type(GL_FLOAT)
+                .using_linear_magnification()
+                .using_linear_minification()
+                .using_horizontal_repetition()
+                .as_resource_with_data(layers_data.data());
+        needs_upload = false;
+    }
+}
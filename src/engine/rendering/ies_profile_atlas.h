@@ -0,0 +1,47 @@
+#ifndef IES_PROFILE_ATLAS_H
+#define IES_PROFILE_ATLAS_H
+
+#include "opengl3_texture.h"
+
+#include "../../ies/adapter/ies_intensity_map.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+    //  Stores each distinct IES profile once, as a normalized intensity map in a layer of a 2D texture array;
+    //  lights refer to their profile through the layer index returned by add_profile.
+    class IES_Profile_Atlas {
+    public:
+        explicit IES_Profile_Atlas(int profile_width = 256, int profile_height = 128);
+
+        IES_Profile_Atlas(const IES_Profile_Atlas& other) = delete;
+        IES_Profile_Atlas(IES_Profile_Atlas&& other) = delete;
+        IES_Profile_Atlas& operator=(const IES_Profile_Atlas& other) = delete;
+        IES_Profile_Atlas& operator=(IES_Profile_Atlas&& other) = delete;
+        ~IES_Profile_Atlas() = default;
+
+        unsigned int add_profile(const ies::IES_Document& document);
+        [[nodiscard]] std::optional<unsigned int> layer_of(const ies::IES_Document& document) const;
+        [[nodiscard]] unsigned int profiles_count() const;
+        [[nodiscard]] std::size_t memory_footprint() const;
+
+        //  Uploads the profiles added since the last call before binding the texture array
+        void bind_to_slot(unsigned int slot);
+
+    private:
+        void upload();
+
+        int width;
+        int height;
+        std::unordered_map<std::uint64_t, unsigned int> layer_by_hash;
+        std::vector<float> layers_data;
+        std::unique_ptr<OpenGL3_Texture2DArray> texture;
+        bool needs_upload = false;
+    };
+}
+
+#endif //IES_PROFILE_ATLAS_H
@@ -4,6 +4,12 @@ namespace engine {
 
     OpenGL3_Context::OpenGL3_Context(GLFWwindow *window) : main_window{window} {}
 
+    OpenGL3_Context::~OpenGL3_Context() {
+        if (owns_window) {
+            glfwDestroyWindow(main_window);
+        }
+    }
+
     void OpenGL3_Context::initialize() {
         glfwMakeContextCurrent(main_window);
 
@@ -16,4 +22,26 @@ namespace engine {
     void OpenGL3_Context::swap_buffers() {
         glfwSwapBuffers(main_window);
     }
+
+    std::unique_ptr<RenderingContext> OpenGL3_Context::create_shared_context() const {
+        //  The version and profile hints set for the main window still apply
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        auto* hidden_window = glfwCreateWindow(1, 1, "", nullptr, main_window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (hidden_window == nullptr) {
+            fmt::print("[OPENGL3 CONTEXT] Failed to create a shared context\n");
+            return nullptr;
+        }
+        auto shared_context = std::make_unique<OpenGL3_Context>(hidden_window);
+        shared_context->owns_window = true;
+        return shared_context;
+    }
+
+    void OpenGL3_Context::make_current() {
+        glfwMakeContextCurrent(main_window);
+    }
+
+    void OpenGL3_Context::release_current() {
+        glfwMakeContextCurrent(nullptr);
+    }
 }
\ No newline at end of file
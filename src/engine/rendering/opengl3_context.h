@@ -15,12 +15,21 @@ namespace engine {
     public:
         OpenGL3_Context(GLFWwindow *window);
 
+        virtual ~OpenGL3_Context() override;
+
         virtual void initialize() override;
 
         virtual void swap_buffers() override;
 
+        [[nodiscard]] virtual std::unique_ptr<RenderingContext> create_shared_context() const override;
+
+        virtual void make_current() override;
+
+        virtual void release_current() override;
+
     private:
         GLFWwindow *main_window;
+        bool owns_window = false;       //  Shared contexts live in a hidden window of their own
     };
 }
 
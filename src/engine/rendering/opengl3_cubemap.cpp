@@ -2,6 +2,7 @@
 
 namespace engine{
     OpenGL3_Cubemap::~OpenGL3_Cubemap() {
+        OpenGL3_State_Cache::forget_texture(resource_id);
         glDeleteTextures(1, &resource_id);
     }
 
@@ -10,8 +11,7 @@ namespace engine{
     }
 
     void OpenGL3_Cubemap::bind_to_slot(const unsigned int slot_number) const {
-        glActiveTexture(GL_TEXTURE0 + slot_number);
-        glBindTexture(bound_type, resource_id);
+        OpenGL3_State_Cache::bind_texture(slot_number, bound_type, resource_id);
     }
 
     OpenGL3_Cubemap::OpenGL3_Cubemap(unsigned int texture_id, unsigned int texture_width, unsigned int texture_height)
@@ -40,7 +40,7 @@ namespace engine{
 
     std::unique_ptr<OpenGL3_Cubemap> OpenGL3_Cubemap_Builder::as_resource() {
         glGenTextures(1, &id);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+        OpenGL3_State_Cache::bind_texture_to_active_unit(GL_TEXTURE_CUBE_MAP, id);
         for(auto i = 0; i < 6; ++i){
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, texture_format, width, height, 0, texture_data_format, data_type,
                          nullptr);
@@ -0,0 +1,80 @@
+#include "opengl3_egl_context.h"
+
+#include <fmt/core.h>
+#include <glad/glad.h>
+
+#include <array>
+
+namespace engine {
+    OpenGL3_EGL_Context::OpenGL3_EGL_Context(EGLDisplay egl_display, EGLContext shared_with) : display{egl_display} {
+        if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE) {
+            fmt::print("[OPENGL3 EGL CONTEXT] Desktop OpenGL is not available through EGL\n");
+            return;
+        }
+
+        constexpr std::array<EGLint, 7> config_attributes{
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_CONFORMANT, EGL_OPENGL_BIT,
+                EGL_NONE};
+        auto config = EGLConfig{};
+        auto configs_count = EGLint{0};
+        if (eglChooseConfig(display, config_attributes.data(), &config, 1, &configs_count) == EGL_FALSE ||
+            configs_count == 0) {
+            fmt::print("[OPENGL3 EGL CONTEXT] No config supports OpenGL, error {:#x}\n", eglGetError());
+            return;
+        }
+
+        constexpr std::array<EGLint, 7> context_attributes{
+                EGL_CONTEXT_MAJOR_VERSION, 4,
+                EGL_CONTEXT_MINOR_VERSION, 3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE};
+        context = eglCreateContext(display, config, shared_with, context_attributes.data());
+        if (context == EGL_NO_CONTEXT) {
+            fmt::print("[OPENGL3 EGL CONTEXT] Failed to create an OpenGL 4.3 core context, error {:#x}\n",
+                       eglGetError());
+        }
+    }
+
+    OpenGL3_EGL_Context::~OpenGL3_EGL_Context() {
+        if (context != EGL_NO_CONTEXT) {
+            if (eglGetCurrentContext() == context) {
+                release_current();
+            }
+            eglDestroyContext(display, context);
+        }
+    }
+
+    void OpenGL3_EGL_Context::initialize() {
+        make_current();
+
+        int initialization_status = gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress));
+        if (initialization_status == 0) {
+            fmt::print("[OPENGL3 EGL CONTEXT] Failed to initialize GLAD\n");
+        }
+    }
+
+    void OpenGL3_EGL_Context::swap_buffers() {
+        glFlush();
+    }
+
+    std::unique_ptr<RenderingContext> OpenGL3_EGL_Context::create_shared_context() const {
+        auto shared_context = std::make_unique<OpenGL3_EGL_Context>(display, context);
+        if (!shared_context->is_valid()) {
+            fmt::print("[OPENGL3 EGL CONTEXT] Failed to create a shared context\n");
+            return nullptr;
+        }
+        return shared_context;
+    }
+
+    void OpenGL3_EGL_Context::make_current() {
+        if (eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_FALSE) {
+            fmt::print("[OPENGL3 EGL CONTEXT] Failed to make the context current, error {:#x}\n", eglGetError());
+        }
+    }
+
+    void OpenGL3_EGL_Context::release_current() {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef OPENGL3_EGL_CONTEXT_H
+#define OPENGL3_EGL_CONTEXT_H
+
+#include "rendering_context.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace engine {
+    //  A 4.3 core context made current without any surface (EGL_KHR_surfaceless_context), so everything is
+    //  drawn into framebuffer objects. The display has to outlive every context created on it.
+    class OpenGL3_EGL_Context : public RenderingContext {
+    public:
+        OpenGL3_EGL_Context(EGLDisplay egl_display, EGLContext shared_with = EGL_NO_CONTEXT);
+
+        OpenGL3_EGL_Context(const OpenGL3_EGL_Context& other) = delete;
+        OpenGL3_EGL_Context(OpenGL3_EGL_Context&& other) = delete;
+        OpenGL3_EGL_Context& operator=(const OpenGL3_EGL_Context& other) = delete;
+        OpenGL3_EGL_Context& operator=(OpenGL3_EGL_Context&& other) = delete;
+        virtual ~OpenGL3_EGL_Context() override;
+
+        virtual void initialize() override;
+
+        //  Nothing to present: only flushes, so that the GPU gets the frame as it would on a swap
+        virtual void swap_buffers() override;
+
+        [[nodiscard]] virtual std::unique_ptr<RenderingContext> create_shared_context() const override;
+
+        virtual void make_current() override;
+
+        virtual void release_current() override;
+
+        [[nodiscard]] bool is_valid() const noexcept { return context != EGL_NO_CONTEXT; }
+
+    private:
+        EGLDisplay display;
+        EGLContext context = EGL_NO_CONTEXT;
+    };
+}
+
+#endif //OPENGL3_EGL_CONTEXT_H
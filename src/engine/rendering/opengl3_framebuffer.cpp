@@ -7,15 +7,16 @@ namespace engine{
     }
 
     OpenGL3_FrameBuffer::~OpenGL3_FrameBuffer() {
+        OpenGL3_State_Cache::forget_framebuffer(id);
         glDeleteFramebuffers(1, &id);
     }
 
     void OpenGL3_FrameBuffer::bind_as(const GLenum framebuffer_mode) {
-        glBindFramebuffer(framebuffer_mode, id);
+        OpenGL3_State_Cache::bind_framebuffer(framebuffer_mode, id);
     }
 
     void OpenGL3_FrameBuffer::unbind_from(const GLenum framebuffer_mode) {
-        glBindFramebuffer(framebuffer_mode, 0);
+        OpenGL3_State_Cache::bind_framebuffer(framebuffer_mode, OpenGL3_State_Cache::default_framebuffer());
     }
 
     /// \param framebuffer_mode  one of GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER
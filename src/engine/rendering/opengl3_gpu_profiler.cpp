@@ -0,0 +1,214 @@
+#include "opengl3_gpu_profiler.h"
+
+#include <fmt/core.h>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace engine {
+    OpenGL3_GPU_Profiler::OpenGL3_GPU_Profiler(const std::size_t history_frames)
+            : history_length(std::max<std::size_t>(history_frames, 1)) {}
+
+    OpenGL3_GPU_Profiler::~OpenGL3_GPU_Profiler() {
+        for (auto& frame_queries : queries_in_flight) {
+            if (!frame_queries.queries.empty()) {
+                glDeleteQueries(static_cast<GLsizei>(frame_queries.queries.size()), frame_queries.queries.data());
+            }
+        }
+    }
+
+    void OpenGL3_GPU_Profiler::begin_frame() {
+        auto& frame_queries = queries_in_flight[frame % frames_in_flight];
+        collect(frame_queries, waits_for_results);
+        frame_queries.frame = frame;
+    }
+
+    void OpenGL3_GPU_Profiler::end_frame() {
+        if (open_pass.has_value()) {
+            end_pass();
+        }
+        ++frame;
+    }
+
+    void OpenGL3_GPU_Profiler::begin_pass(const std::string_view name) {
+        if (!enabled) {
+            return;
+        }
+        if (open_pass.has_value()) {
+            end_pass();
+        }
+
+        const auto pass = pass_index(name);
+        if (GLAD_GL_KHR_debug) {
+            glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, static_cast<GLuint>(pass), -1, pass_names[pass].c_str());
+        }
+        auto& frame_queries = queries_in_flight[frame % frames_in_flight];
+        if (frame_queries.passes.size() == frame_queries.queries.size()) {
+            auto query = 0u;
+            glGenQueries(1, &query);
+            frame_queries.queries.push_back(query);
+        }
+        glBeginQuery(GL_TIME_ELAPSED, frame_queries.queries[frame_queries.passes.size()]);
+        frame_queries.passes.push_back(pass);
+        open_pass = pass;
+    }
+
+    void OpenGL3_GPU_Profiler::end_pass() {
+        if (!open_pass.has_value()) {
+            return;
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        if (GLAD_GL_KHR_debug) {
+            glPopDebugGroup();
+        }
+        open_pass.reset();
+    }
+
+    void OpenGL3_GPU_Profiler::set_enabled(const bool enable) {
+        if (!enable) {
+            end_pass();
+        }
+        enabled = enable;
+    }
+
+    void OpenGL3_GPU_Profiler::set_history_length(const std::size_t history_frames) {
+        history_length = std::max<std::size_t>(history_frames, 1);
+        while (history.size() > history_length) {
+            history.pop_front();
+        }
+    }
+
+    void OpenGL3_GPU_Profiler::clear_history() {
+        history.clear();
+    }
+
+    void OpenGL3_GPU_Profiler::flush() {
+        if (open_pass.has_value()) {
+            end_pass();
+        }
+        //  Oldest first, so that the history stays in frame order
+        for (auto in_flight = frames_in_flight; in_flight > 0; --in_flight) {
+            collect(queries_in_flight[(frame + frames_in_flight - in_flight) % frames_in_flight], true);
+        }
+    }
+
+    std::vector<GPUPassStatistics> OpenGL3_GPU_Profiler::pass_statistics() const {
+        std::vector<GPUPassStatistics> statistics(pass_names.size());
+        for (auto pass = std::size_t{0}; pass < pass_names.size(); ++pass) {
+            statistics[pass].name = pass_names[pass];
+        }
+        for (const auto& sample : history) {
+            for (auto pass = std::size_t{0}; pass < sample.pass_ms.size(); ++pass) {
+                const auto milliseconds = sample.pass_ms[pass];
+                if (milliseconds < 0.0f) {
+                    continue;
+                }
+                auto& pass_statistics = statistics[pass];
+                pass_statistics.min_ms = pass_statistics.samples == 0 ? milliseconds
+                                                                      : std::min(pass_statistics.min_ms, milliseconds);
+                pass_statistics.max_ms = std::max(pass_statistics.max_ms, milliseconds);
+                pass_statistics.average_ms += milliseconds;
+                pass_statistics.last_ms = milliseconds;
+                ++pass_statistics.samples;
+            }
+        }
+        for (auto& pass_statistics : statistics) {
+            if (pass_statistics.samples > 0) {
+                pass_statistics.average_ms /= static_cast<float>(pass_statistics.samples);
+            }
+        }
+        return statistics;
+    }
+
+    std::vector<float> OpenGL3_GPU_Profiler::frame_times() const {
+        std::vector<float> times;
+        times.reserve(history.size());
+        std::transform(std::begin(history), std::end(history), std::back_inserter(times),
+                       [](const auto& sample) { return sample.total_ms; });
+        return times;
+    }
+
+    std::vector<float> OpenGL3_GPU_Profiler::pass_times(const std::string_view name) const {
+        std::vector<float> times;
+        const auto found = std::find(std::begin(pass_names), std::end(pass_names), name);
+        if (found == std::end(pass_names)) {
+            return times;
+        }
+        const auto pass = static_cast<std::size_t>(std::distance(std::begin(pass_names), found));
+        for (const auto& sample : history) {
+            if (pass < sample.pass_ms.size() && sample.pass_ms[pass] >= 0.0f) {
+                times.push_back(sample.pass_ms[pass]);
+            }
+        }
+        return times;
+    }
+
+    bool OpenGL3_GPU_Profiler::export_csv(const std::filesystem::path& path) const {
+        std::ofstream stream(path, std::ios::trunc);
+        stream << "frame";
+        for (const auto& name : pass_names) {
+            stream << ',' << name;
+        }
+        stream << ",total\n";
+        for (const auto& sample : history) {
+            stream << sample.frame;
+            for (auto pass = std::size_t{0}; pass < pass_names.size(); ++pass) {
+                stream << ',';
+                if (pass < sample.pass_ms.size() && sample.pass_ms[pass] >= 0.0f) {
+                    stream << fmt::format("{:.4f}", sample.pass_ms[pass]);
+                }
+            }
+            stream << fmt::format(",{:.4f}\n", sample.total_ms);
+        }
+        if (!stream) {
+            fmt::print("[GPU PROFILER] Writing {} failed\n", path.string());
+            return false;
+        }
+        return true;
+    }
+
+    void OpenGL3_GPU_Profiler::collect(FrameQueries& frame_queries, const bool wait) {
+        if (frame_queries.passes.empty()) {
+            return;
+        }
+
+        auto sample = FrameSample{frame_queries.frame, std::vector<float>(pass_names.size(), -1.0f), 0.0f};
+        auto complete = true;
+        for (auto i = std::size_t{0}; i < frame_queries.passes.size(); ++i) {
+            if (!wait) {
+                auto available = 0;
+                glGetQueryObjectiv(frame_queries.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available == 0) {
+                    complete = false;
+                    break;
+                }
+            }
+            auto elapsed_nanoseconds = GLuint64{0};
+            glGetQueryObjectui64v(frame_queries.queries[i], GL_QUERY_RESULT, &elapsed_nanoseconds);
+            const auto milliseconds = static_cast<float>(static_cast<double>(elapsed_nanoseconds) / 1.0e6);
+            //  A pass may run more than once in a frame
+            auto& pass_ms = sample.pass_ms[frame_queries.passes[i]];
+            pass_ms = std::max(pass_ms, 0.0f) + milliseconds;
+            sample.total_ms += milliseconds;
+        }
+        frame_queries.passes.clear();
+        if (!complete) {
+            return;
+        }
+
+        history.push_back(std::move(sample));
+        if (history.size() > history_length) {
+            history.pop_front();
+        }
+    }
+
+    std::size_t OpenGL3_GPU_Profiler::pass_index(const std::string_view name) {
+        const auto found = std::find(std::begin(pass_names), std::end(pass_names), name);
+        if (found != std::end(pass_names)) {
+            return static_cast<std::size_t>(std::distance(std::begin(pass_names), found));
+        }
+        pass_names.emplace_back(name);
+        return pass_names.size() - 1;
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef OPENGL3_GPU_PROFILER_H
+#define OPENGL3_GPU_PROFILER_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine {
+    //  Over the frames kept in the history that ran the pass, in milliseconds
+    struct GPUPassStatistics {
+        std::string_view name;
+        float last_ms = 0.0f;
+        float average_ms = 0.0f;
+        float min_ms = 0.0f;
+        float max_ms = 0.0f;
+        std::size_t samples = 0;
+    };
+
+    //  Times named passes with GL_TIME_ELAPSED queries. Every frame has its own set of queries, which is
+    //  read back frames_in_flight frames later, once the GPU is done with it; a frame whose results are
+    //  still not there is dropped rather than waited for. Passes are wrapped in KHR_debug groups of the
+    //  same name, so that frame captures show them.
+    class OpenGL3_GPU_Profiler {
+    public:
+        static constexpr std::size_t frames_in_flight = 2;
+
+        explicit OpenGL3_GPU_Profiler(std::size_t history_frames = 300);
+
+        OpenGL3_GPU_Profiler(const OpenGL3_GPU_Profiler& other) = delete;
+        OpenGL3_GPU_Profiler(OpenGL3_GPU_Profiler&& other) = delete;
+        OpenGL3_GPU_Profiler& operator=(const OpenGL3_GPU_Profiler& other) = delete;
+        OpenGL3_GPU_Profiler& operator=(OpenGL3_GPU_Profiler&& other) = delete;
+        ~OpenGL3_GPU_Profiler();
+
+        void begin_frame();
+        void end_frame();
+        //  Passes cannot nest, as GL_TIME_ELAPSED queries cannot; a pass may be skipped on some frames
+        void begin_pass(std::string_view name);
+        void end_pass();
+
+        void set_enabled(bool enable);
+        [[nodiscard]] bool is_enabled() const { return enabled; }
+        //  Drops the oldest frames if the history is already longer
+        void set_history_length(std::size_t history_frames);
+        //  Stall on results that are not in yet instead of dropping their frame, when every frame has to count
+        void set_waits_for_results(bool wait) { waits_for_results = wait; }
+        void clear_history();
+        //  Waits for the frames still in flight and adds them to the history
+        void flush();
+
+        //  In the order the passes first ran
+        [[nodiscard]] std::vector<GPUPassStatistics> pass_statistics() const;
+        //  Sum of the passes of every frame in the history, oldest first
+        [[nodiscard]] std::vector<float> frame_times() const;
+        //  Of the frames in the history that ran the pass, oldest first
+        [[nodiscard]] std::vector<float> pass_times(std::string_view name) const;
+        //  One row per frame in the history and one column per pass, empty where the frame skipped the pass
+        bool export_csv(const std::filesystem::path& path) const;
+
+    private:
+        struct FrameQueries {
+            std::uint64_t frame = 0;
+            std::vector<unsigned int> queries;      //  Grows to the most passes a frame has had
+            std::vector<std::size_t> passes;        //  Pass of each query issued this frame
+        };
+
+        struct FrameSample {
+            std::uint64_t frame;
+            std::vector<float> pass_ms;             //  Negative for passes the frame skipped
+            float total_ms;
+        };
+
+        void collect(FrameQueries& frame_queries, bool wait);
+        [[nodiscard]] std::size_t pass_index(std::string_view name);
+
+        std::array<FrameQueries, frames_in_flight> queries_in_flight;
+        std::vector<std::string> pass_names;
+        std::deque<FrameSample> history;
+        std::size_t history_length;
+        std::uint64_t frame = 0;
+        std::optional<std::size_t> open_pass;
+        bool enabled = true;
+        bool waits_for_results = false;
+    };
+}
+
+#endif //OPENGL3_GPU_PROFILER_H
@@ -0,0 +1,231 @@
+#include "opengl3_state_cache.h"
+
+#include <algorithm>
+
+namespace engine {
+    OpenGL3_State_Counters OpenGL3_State_Cache::current_frame;
+    OpenGL3_State_Counters OpenGL3_State_Cache::last_frame;
+
+    OpenGL3_State_Cache::State& OpenGL3_State_Cache::state() {
+        //  Never destroyed: the context, and with it the state mirrored here, may outlive static destruction
+        static auto* cached = new State{};
+        return *cached;
+    }
+
+    unsigned int& OpenGL3_State_Cache::window_framebuffer() {
+        static unsigned int framebuffer = 0;
+        return framebuffer;
+    }
+
+    void OpenGL3_State_Cache::begin_frame() {
+        last_frame = current_frame;
+        current_frame = OpenGL3_State_Counters{};
+        invalidate();
+    }
+
+    void OpenGL3_State_Cache::invalidate() {
+        auto& cached = state();
+        cached = State{};
+        for (auto& unit : cached.textures) {
+            unit.fill(unknown);
+        }
+    }
+
+    OpenGL3_State_Counters OpenGL3_State_Cache::last_frame_counters() {
+        return last_frame;
+    }
+
+    bool OpenGL3_State_Cache::count(const bool redundant) {
+        if (redundant) {
+            ++current_frame.elided;
+        } else {
+            ++current_frame.issued;
+        }
+        return !redundant;
+    }
+
+    void OpenGL3_State_Cache::use_program(const unsigned int program) {
+        if (count(state().program == program)) {
+            glUseProgram(program);
+            state().program = program;
+        }
+    }
+
+    void OpenGL3_State_Cache::bind_vertex_array(const unsigned int vertex_array) {
+        if (count(state().vertex_array == vertex_array)) {
+            glBindVertexArray(vertex_array);
+            state().vertex_array = vertex_array;
+        }
+    }
+
+    void OpenGL3_State_Cache::activate_texture_unit(const unsigned int slot) {
+        if (count(state().active_texture_unit == slot)) {
+            glActiveTexture(GL_TEXTURE0 + slot);
+            state().active_texture_unit = slot;
+        }
+    }
+
+    void OpenGL3_State_Cache::bind_texture(const unsigned int slot, const GLenum target, const unsigned int texture) {
+        const auto column = impl_details::texture_target_index(target);
+        if (slot < tracked_texture_units && column < 4 && state().textures[slot][column] == texture) {
+            ++current_frame.elided;
+            return;
+        }
+        activate_texture_unit(slot);
+        bind_texture_to_active_unit(target, texture);
+    }
+
+    void OpenGL3_State_Cache::bind_texture_to_active_unit(const GLenum target, const unsigned int texture) {
+        const auto slot = state().active_texture_unit;
+        const auto column = impl_details::texture_target_index(target);
+        const auto tracked = slot < tracked_texture_units && column < 4;
+        if (count(tracked && state().textures[slot][column] == texture)) {
+            glBindTexture(target, texture);
+            if (tracked) {
+                state().textures[slot][column] = texture;
+            }
+        }
+    }
+
+    void OpenGL3_State_Cache::bind_buffer_base(const GLenum target, const unsigned int binding_point,
+                                               const unsigned int buffer) {
+        auto& binding = state().indexed_buffers[impl_details::indexed_binding_key(target, binding_point)];
+        if (count(binding.buffer == buffer && binding.size == 0)) {
+            glBindBufferBase(target, binding_point, buffer);
+            binding = Indexed_Buffer_Binding{buffer, 0, 0};
+        }
+    }
+
+    void OpenGL3_State_Cache::bind_buffer_range(const GLenum target, const unsigned int binding_point,
+                                                const unsigned int buffer, const GLintptr offset,
+                                                const GLsizeiptr size) {
+        auto& binding = state().indexed_buffers[impl_details::indexed_binding_key(target, binding_point)];
+        if (count(binding.buffer == buffer && binding.offset == offset && binding.size == size)) {
+            glBindBufferRange(target, binding_point, buffer, offset, size);
+            binding = Indexed_Buffer_Binding{buffer, offset, size};
+        }
+    }
+
+    void OpenGL3_State_Cache::bind_framebuffer(const GLenum target, const unsigned int framebuffer) {
+        const auto draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+        const auto read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+        const auto redundant = (!draw || state().draw_framebuffer == framebuffer) &&
+                               (!read || state().read_framebuffer == framebuffer);
+        if (count(redundant)) {
+            glBindFramebuffer(target, framebuffer);
+            if (draw) {
+                state().draw_framebuffer = framebuffer;
+            }
+            if (read) {
+                state().read_framebuffer = framebuffer;
+            }
+        }
+    }
+
+    void OpenGL3_State_Cache::set_default_framebuffer(const unsigned int framebuffer) {
+        window_framebuffer() = framebuffer;
+    }
+
+    unsigned int OpenGL3_State_Cache::default_framebuffer() {
+        return window_framebuffer();
+    }
+
+    void OpenGL3_State_Cache::set_viewport(const int x, const int y, const int width, const int height) {
+        const auto viewport = std::array<int, 4>{x, y, width, height};
+        if (count(state().viewport == viewport)) {
+            glViewport(x, y, width, height);
+            state().viewport = viewport;
+        }
+    }
+
+    void OpenGL3_State_Cache::set_capability(const GLenum capability, const bool enabled) {
+        const auto current = state().capabilities.find(capability);
+        if (count(current != std::end(state().capabilities) && current->second == enabled)) {
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+            state().capabilities[capability] = enabled;
+        }
+    }
+
+    void OpenGL3_State_Cache::set_blend_function(const GLenum source_factor, const GLenum destination_factor) {
+        const auto blend_function = std::array<GLenum, 2>{source_factor, destination_factor};
+        if (count(state().blend_function == blend_function)) {
+            glBlendFunc(source_factor, destination_factor);
+            state().blend_function = blend_function;
+        }
+    }
+
+    void OpenGL3_State_Cache::set_blend_equation(const GLenum mode) {
+        if (count(state().blend_equation == mode)) {
+            glBlendEquation(mode);
+            state().blend_equation = mode;
+        }
+    }
+
+    void OpenGL3_State_Cache::set_cull_face(const GLenum face) {
+        if (count(state().cull_face == face)) {
+            glCullFace(face);
+            state().cull_face = face;
+        }
+    }
+
+    void OpenGL3_State_Cache::set_polygon_mode(const GLenum mode) {
+        if (count(state().polygon_mode == mode)) {
+            glPolygonMode(GL_FRONT_AND_BACK, mode);
+            state().polygon_mode = mode;
+        }
+    }
+
+    void OpenGL3_State_Cache::forget_vertex_array(const unsigned int vertex_array) {
+        if (state().vertex_array == vertex_array) {
+            state().vertex_array = unknown;
+        }
+    }
+
+    void OpenGL3_State_Cache::forget_texture(const unsigned int texture) {
+        for (auto& unit : state().textures) {
+            std::replace(std::begin(unit), std::end(unit), texture, unknown);
+        }
+    }
+
+    void OpenGL3_State_Cache::forget_buffer(const unsigned int buffer) {
+        for (auto& [key, binding] : state().indexed_buffers) {
+            if (binding.buffer == buffer) {
+                binding.buffer = unknown;
+            }
+        }
+    }
+
+    void OpenGL3_State_Cache::forget_framebuffer(const unsigned int framebuffer) {
+        if (state().draw_framebuffer == framebuffer) {
+            state().draw_framebuffer = unknown;
+        }
+        if (state().read_framebuffer == framebuffer) {
+            state().read_framebuffer = unknown;
+        }
+    }
+}
+
+namespace engine::impl_details {
+    unsigned int texture_target_index(const GLenum target) {
+        switch (target) {
+            case GL_TEXTURE_1D:
+                return 0;
+            case GL_TEXTURE_2D:
+                return 1;
+            case GL_TEXTURE_2D_ARRAY:
+                return 2;
+            case GL_TEXTURE_CUBE_MAP:
+                return 3;
+            default:
+                return 4;
+        }
+    }
+
+    std::uint64_t indexed_binding_key(const GLenum target, const unsigned int binding_point) {
+        return (static_cast<std::uint64_t>(target) << 32) | binding_point;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef OPENGL3_STATE_CACHE_H
+#define OPENGL3_STATE_CACHE_H
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace engine {
+    struct OpenGL3_State_Counters {
+        unsigned int issued = 0;
+        unsigned int elided = 0;
+    };
+
+    //  Shadow copy of the GL state changed through the engine: a call that would set a value that is already
+    //  in place is not issued. State changed with raw GL calls (third party code, e.g. ImGui, included)
+    //  must be followed by invalidate(); begin_frame() invalidates as well.
+    //  Deleted objects have to be forgotten, since GL may hand out their names again.
+    //  Generic buffer targets are left alone: uploads bind them all the time and the element array
+    //  binding belongs to the bound vertex array anyway.
+    class OpenGL3_State_Cache {
+    public:
+        static constexpr unsigned int tracked_texture_units = 32;
+
+        static void begin_frame();
+        static void invalidate();
+        [[nodiscard]] static OpenGL3_State_Counters last_frame_counters();
+
+        static void use_program(unsigned int program);
+        static void bind_vertex_array(unsigned int vertex_array);
+        static void bind_texture(unsigned int slot, GLenum target, unsigned int texture);
+        //  Binds to whichever unit is active, as texture creation and updates do
+        static void bind_texture_to_active_unit(GLenum target, unsigned int texture);
+        static void bind_buffer_base(GLenum target, unsigned int binding_point, unsigned int buffer);
+        static void bind_buffer_range(GLenum target, unsigned int binding_point, unsigned int buffer,
+                                      GLintptr offset, GLsizeiptr size);
+        static void bind_framebuffer(GLenum target, unsigned int framebuffer);
+        //  What framebuffers are unbound to: 0, unless the window renders into a framebuffer object of its own
+        static void set_default_framebuffer(unsigned int framebuffer);
+        [[nodiscard]] static unsigned int default_framebuffer();
+        static void set_viewport(int x, int y, int width, int height);
+        static void set_capability(GLenum capability, bool enabled);
+        static void set_blend_function(GLenum source_factor, GLenum destination_factor);
+        static void set_blend_equation(GLenum mode);
+        static void set_cull_face(GLenum face);
+        static void set_polygon_mode(GLenum mode);
+
+        static void forget_vertex_array(unsigned int vertex_array);
+        static void forget_texture(unsigned int texture);
+        static void forget_buffer(unsigned int buffer);
+        static void forget_framebuffer(unsigned int framebuffer);
+
+    private:
+        static constexpr unsigned int unknown = 0xFFFFFFFF;
+
+        struct Indexed_Buffer_Binding {
+            unsigned int buffer = unknown;
+            GLintptr offset = 0;
+            GLsizeiptr size = 0;      //  0 for glBindBufferBase
+        };
+
+        struct State {
+            unsigned int program = unknown;
+            unsigned int vertex_array = unknown;
+            unsigned int active_texture_unit = unknown;
+            //  One column per tracked target: 1D, 2D, 2D array, cube map
+            std::array<std::array<unsigned int, 4>, tracked_texture_units> textures{};
+            std::unordered_map<std::uint64_t, Indexed_Buffer_Binding> indexed_buffers;
+            unsigned int draw_framebuffer = unknown;
+            unsigned int read_framebuffer = unknown;
+            std::array<int, 4> viewport{-1, -1, -1, -1};
+            std::unordered_map<GLenum, bool> capabilities;
+            std::array<GLenum, 2> blend_function{unknown, unknown};
+            GLenum blend_equation = unknown;
+            GLenum cull_face = unknown;
+            GLenum polygon_mode = unknown;
+        };
+
+        [[nodiscard]] static bool count(bool redundant);
+        static void activate_texture_unit(unsigned int slot);
+
+        //  Built on first use instead of at static initialization
+        [[nodiscard]] static State& state();
+        [[nodiscard]] static unsigned int& window_framebuffer();
+        static OpenGL3_State_Counters current_frame;
+        static OpenGL3_State_Counters last_frame;
+    };
+
+    namespace impl_details {
+        //  Column of a target in the per-unit texture table, 4 for targets that are not tracked
+        [[nodiscard]] unsigned int texture_target_index(GLenum target);
+
+        [[nodiscard]] std::uint64_t indexed_binding_key(GLenum target, unsigned int binding_point);
+    }
+}
+
+#endif //OPENGL3_STATE_CACHE_H
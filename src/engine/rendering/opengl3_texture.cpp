@@ -25,23 +25,23 @@ namespace engine {
                                             height{texture_height}{}
 
     OpenGL3_Texture2D::~OpenGL3_Texture2D() {
+        OpenGL3_State_Cache::forget_texture(resource_id);
         glDeleteTextures(1, &resource_id);
     }
 
     void OpenGL3_Texture2D::bind_to_slot(const unsigned int slot_number) const {
         //  slot in [0, GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)
-        glActiveTexture(GL_TEXTURE0 + slot_number);
-        glBindTexture(bound_type, resource_id);
+        OpenGL3_State_Cache::bind_texture(slot_number, bound_type, resource_id);
     }
 
     OpenGL3_Texture1D::~OpenGL3_Texture1D() {
+        OpenGL3_State_Cache::forget_texture(resource_id);
         glDeleteTextures(1, &resource_id);
     }
 
     void OpenGL3_Texture1D::bind_to_slot(const unsigned int slot_number) const {
         //  slot in [0, GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)
-        glActiveTexture(GL_TEXTURE0 + slot_number);
-        glBindTexture(bound_type, resource_id);
+        OpenGL3_State_Cache::bind_texture(slot_number, bound_type, resource_id);
     }
 
     unsigned int OpenGL3_Texture1D::id() const {
@@ -53,6 +53,32 @@ namespace engine {
         bound_type{GL_TEXTURE_1D},
         dimension{texture_dimension} {}
 
+    OpenGL3_Texture2DArray::~OpenGL3_Texture2DArray() {
+        OpenGL3_State_Cache::forget_texture(resource_id);
+        glDeleteTextures(1, &resource_id);
+    }
+
+    void OpenGL3_Texture2DArray::bind_to_slot(const unsigned int slot_number) const {
+        //  slot in [0, GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)
+        OpenGL3_State_Cache::bind_texture(slot_number, bound_type, resource_id);
+    }
+
+    unsigned int OpenGL3_Texture2DArray::id() const {
+        return resource_id;
+    }
+
+    int OpenGL3_Texture2DArray::layers() const {
+        return layers_number;
+    }
+
+    OpenGL3_Texture2DArray::OpenGL3_Texture2DArray(unsigned int texture_id, int texture_width,
+                                                   int texture_height, int texture_layers)
+    : resource_id{texture_id},
+        bound_type{GL_TEXTURE_2D_ARRAY},
+        width{texture_width},
+        height{texture_height},
+        layers_number{texture_layers} {}
+
     OpenGL3_Texture2D_Builder&& OpenGL3_Texture2D_Builder::with_size(int tex_width, int tex_height)&& {
         this->width = tex_width;
         this->height = tex_height;
@@ -78,7 +104,7 @@ namespace engine {
 
     std::unique_ptr<OpenGL3_Texture2D> OpenGL3_Texture2D_Builder::as_resource() {
         glGenTextures(1, &id);
-        glBindTexture(GL_TEXTURE_2D, id);
+        OpenGL3_State_Cache::bind_texture_to_active_unit(GL_TEXTURE_2D, id);
         glTexImage2D(GL_TEXTURE_2D, 0, texture_format, width, height, 0, texture_data_format, data_type, nullptr);
         for(auto&& parameter_pair : parameters){
             glTexParameteri(GL_TEXTURE_2D, parameter_pair.first, parameter_pair.second);
@@ -104,7 +130,7 @@ namespace engine {
 
     std::unique_ptr<OpenGL3_Texture1D> OpenGL3_Texture1D_Builder::as_resource() {
         glGenTextures(1, &id);
-        glBindTexture(GL_TEXTURE_1D, id);
+        OpenGL3_State_Cache::bind_texture_to_active_unit(GL_TEXTURE_1D, id);
         glTexImage1D(GL_TEXTURE_1D, 0, texture_format, dimension, 0, texture_data_format, data_type, nullptr);
         for(auto&& parameter_pair : parameters){
             glTexParameteri(GL_TEXTURE_1D, parameter_pair.first, parameter_pair.second);
@@ -114,11 +140,46 @@ namespace engine {
 
     std::unique_ptr<OpenGL3_Texture1D> OpenGL3_Texture1D_Builder::as_resource_with_data(const void* data) {
         glGenTextures(1, &id);
-        glBindTexture(GL_TEXTURE_1D, id);
+        OpenGL3_State_Cache::bind_texture_to_active_unit(GL_TEXTURE_1D, id);
         glTexImage1D(GL_TEXTURE_1D, 0, texture_format, dimension, 0, texture_data_format, data_type, data);
         for(auto&& parameter_pair : parameters){
             glTexParameteri(GL_TEXTURE_1D, parameter_pair.first, parameter_pair.second);
         }
         return std::unique_ptr<OpenGL3_Texture1D>(new OpenGL3_Texture1D(id, dimension));
     }
+
+    OpenGL3_Texture2DArray_Builder&& OpenGL3_Texture2DArray_Builder::with_size(int tex_width, int tex_height,
+                                                                               int tex_layers)&& {
+        this->width = tex_width;
+        this->height = tex_height;
+        this->layers = tex_layers;
+        return std::move(*this);
+    }
+
+    OpenGL3_Texture2DArray_Builder&& OpenGL3_Texture2DArray_Builder::using_clamping_to_edge()&& {
+        parameters.add_parameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        parameters.add_parameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return std::move(*this);
+    }
+
+    OpenGL3_Texture2DArray_Builder&& OpenGL3_Texture2DArray_Builder::using_horizontal_repetition()&& {
+        parameters.add_parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+        parameters.add_parameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return std::move(*this);
+    }
+
+    std::unique_ptr<OpenGL3_Texture2DArray> OpenGL3_Texture2DArray_Builder::as_resource() {
+        return as_resource_with_data(nullptr);
+    }
+
+    std::unique_ptr<OpenGL3_Texture2DArray> OpenGL3_Texture2DArray_Builder::as_resource_with_data(const void* data) {
+        glGenTextures(1, &id);
+        OpenGL3_State_Cache::bind_texture_to_active_unit(GL_TEXTURE_2D_ARRAY, id);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, texture_format, width, height, layers, 0,
+                     texture_data_format, data_type, data);
+        for(auto&& parameter_pair : parameters){
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, parameter_pair.first, parameter_pair.second);
+        }
+        return std::unique_ptr<OpenGL3_Texture2DArray>(new OpenGL3_Texture2DArray(id, width, height, layers));
+    }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef OPENGL3_TEXTURE_H
 #define OPENGL3_TEXTURE_H
 
+#include "opengl3_state_cache.h"
+
 #include <glad/glad.h>
 #include <array>
 #include <iterator>
@@ -64,6 +66,30 @@ namespace engine {
         int dimension;
     };
 
+    class OpenGL3_Texture2DArray {
+    public:
+        friend class OpenGL3_Texture2DArray_Builder;
+        void bind_to_slot(unsigned int slot) const;
+        [[nodiscard]] unsigned int id() const;
+        [[nodiscard]] int layers() const;
+
+        ~OpenGL3_Texture2DArray();
+
+        OpenGL3_Texture2DArray(const OpenGL3_Texture2DArray& other) = delete;
+        OpenGL3_Texture2DArray(OpenGL3_Texture2DArray&& other) = delete;
+        OpenGL3_Texture2DArray& operator=(const OpenGL3_Texture2DArray& other) = delete;
+        OpenGL3_Texture2DArray& operator=(OpenGL3_Texture2DArray&& other) = delete;
+    private:
+        OpenGL3_Texture2DArray(unsigned int texture_id,
+                               int texture_width, int texture_height, int texture_layers);
+
+        unsigned int resource_id;
+        GLenum bound_type;
+        int width;
+        int height;
+        int layers_number;
+    };
+
     template <typename T>
     class OpenGL3_Texture_Builder{
     public:
@@ -137,6 +163,22 @@ namespace engine {
     private:
         int dimension = 0;
     };
+
+    class OpenGL3_Texture2DArray_Builder : public OpenGL3_Texture_Builder<OpenGL3_Texture2DArray_Builder>{
+    public:
+        OpenGL3_Texture2DArray_Builder() = default;
+        [[nodiscard]] OpenGL3_Texture2DArray_Builder&& with_size(int tex_width, int tex_height, int tex_layers) &&;
+        [[nodiscard]] OpenGL3_Texture2DArray_Builder&& using_clamping_to_edge() &&;
+        //  Repeats along S, clamps to edge along T; meant for longitude-latitude parametrizations
+        [[nodiscard]] OpenGL3_Texture2DArray_Builder&& using_horizontal_repetition() &&;
+
+        [[nodiscard]] std::unique_ptr<OpenGL3_Texture2DArray> as_resource();
+        [[nodiscard]] std::unique_ptr<OpenGL3_Texture2DArray> as_resource_with_data(const void* data);
+    private:
+        int width = 0;
+        int height = 0;
+        int layers = 0;
+    };
 }
 
 #endif //OPENGL3_TEXTURE_H
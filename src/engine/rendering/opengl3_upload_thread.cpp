@@ -0,0 +1,133 @@
+#include "opengl3_upload_thread.h"
+
+#include "../../utility/cpu_profiler.h"
+
+#include <fmt/core.h>
+
+#include <vector>
+
+namespace engine {
+    OpenGL3_Upload_Thread::OpenGL3_Upload_Thread(std::unique_ptr<RenderingContext> shared_context,
+                                                 const std::size_t max_pending_uploads)
+            : context(std::move(shared_context)), staged_buffers(max_pending_uploads) {
+        uploader = std::thread(&OpenGL3_Upload_Thread::upload_loop, this);
+    }
+
+    OpenGL3_Upload_Thread::~OpenGL3_Upload_Thread() {
+        {
+            std::lock_guard lock(requests_mutex);
+            stopping = true;
+        }
+        requests_available.notify_all();
+        uploader.join();
+
+        Staged staged;
+        while (staged_buffers.try_pop(staged)) {
+            waiting_for_fence.push_back(std::move(staged));
+        }
+        for (const auto& abandoned : waiting_for_fence) {
+            glDeleteSync(abandoned.fence);
+            glDeleteBuffers(1, &abandoned.buffer.id);
+        }
+        //  The hidden window of the shared context has to go on the thread that created it
+        context.reset();
+    }
+
+    void OpenGL3_Upload_Thread::stage(const std::size_t size, StagingWriter write, StagedCallback on_staged) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(requests_mutex);
+            requests.push_back(Request{size, std::move(write), std::move(on_staged)});
+        }
+        requests_available.notify_one();
+    }
+
+    void OpenGL3_Upload_Thread::poll_completed() {
+        Staged staged;
+        while (staged_buffers.try_pop(staged)) {
+            waiting_for_fence.push_back(std::move(staged));
+        }
+        //  Fences of one context signal in order, so the first one still pending holds back the rest anyway
+        while (!waiting_for_fence.empty()) {
+            auto& oldest = waiting_for_fence.front();
+            const auto status = glClientWaitSync(oldest.fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                break;
+            }
+            if (status == GL_WAIT_FAILED) {
+                fmt::print("[UPLOAD THREAD] Waiting for a staging buffer failed, its upload is dropped\n");
+            } else {
+                oldest.on_staged(oldest.buffer);
+            }
+            glDeleteSync(oldest.fence);
+            glDeleteBuffers(1, &oldest.buffer.id);
+            waiting_for_fence.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    unsigned int OpenGL3_Upload_Thread::pending_uploads() const {
+        return pending.load(std::memory_order_relaxed);
+    }
+
+    void OpenGL3_Upload_Thread::upload_loop() {
+        PROFILE_THREAD("GL upload thread");
+        context->make_current();
+        while (true) {
+            Request request;
+            {
+                std::unique_lock lock(requests_mutex);
+                requests_available.wait(lock, [this] { return stopping || !requests.empty(); });
+                if (stopping) {
+                    break;
+                }
+                request = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            auto staged = fill_staging_buffer(request);
+            //  The render thread drains the queue every frame, a full queue only lasts until the next one
+            auto handed_over = false;
+            while (!(handed_over = staged_buffers.try_push(std::move(staged)))) {
+                if (std::lock_guard lock(requests_mutex); stopping) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            if (!handed_over) {
+                glDeleteSync(staged.fence);
+                glDeleteBuffers(1, &staged.buffer.id);
+                break;
+            }
+        }
+        context->release_current();
+    }
+
+    OpenGL3_Upload_Thread::Staged OpenGL3_Upload_Thread::fill_staging_buffer(Request& request) const {
+        PROFILE_ZONE("Fill staging buffer");
+        //  Bindings belong to this context, so they cannot disturb the render thread's state cache
+        auto buffer = StagingBuffer{0, request.size};
+        glGenBuffers(1, &buffer.id);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.id);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(request.size), nullptr, GL_STREAM_COPY);
+        if (request.size > 0) {
+            auto* mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(request.size),
+                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if (mapped != nullptr) {
+                request.write(static_cast<std::byte*>(mapped));
+            }
+            //  A store corrupted while mapped is undefined, so it is written again like an unmappable one
+            if (mapped == nullptr || glUnmapBuffer(GL_COPY_WRITE_BUFFER) != GL_TRUE) {
+                std::vector<std::byte> fallback(request.size);
+                request.write(fallback.data());
+                glBufferSubData(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(request.size), fallback.data());
+            }
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        const auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        //  Other contexts can only see the fence signal once it has been flushed from this one
+        glFlush();
+        return Staged{buffer, fence, std::move(request.on_staged)};
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef OPENGL3_UPLOAD_THREAD_H
+#define OPENGL3_UPLOAD_THREAD_H
+
+#include "rendering_context.h"
+
+#include "../../utility/lock_free_queue.h"
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace engine {
+    //  A buffer written by the upload thread, handed to the render thread once the GPU has its content;
+    //  bind it as GL_COPY_READ_BUFFER or GL_PIXEL_UNPACK_BUFFER to copy from it without a CPU round trip
+    struct StagingBuffer {
+        unsigned int id;
+        std::size_t size;
+    };
+
+    //  Owns a context shared with the render thread's. Data is written through a mapping into a staging
+    //  buffer there, and a fence behind the writes tells the render thread when it may use the buffer;
+    //  the buffer is deleted once the callback has copied it where it belongs.
+    class OpenGL3_Upload_Thread {
+    public:
+        //  Receives the mapped staging buffer, size bytes long
+        using StagingWriter = std::function<void(std::byte* destination)>;
+        using StagedCallback = std::function<void(const StagingBuffer& staged)>;
+
+        explicit OpenGL3_Upload_Thread(std::unique_ptr<RenderingContext> shared_context,
+                                       std::size_t max_pending_uploads = 256);
+
+        OpenGL3_Upload_Thread(const OpenGL3_Upload_Thread& other) = delete;
+        OpenGL3_Upload_Thread(OpenGL3_Upload_Thread&& other) = delete;
+        OpenGL3_Upload_Thread& operator=(const OpenGL3_Upload_Thread& other) = delete;
+        OpenGL3_Upload_Thread& operator=(OpenGL3_Upload_Thread&& other) = delete;
+        //  On the render thread, with its context current: staged buffers not yet handed over are deleted
+        ~OpenGL3_Upload_Thread();
+
+        void stage(std::size_t size, StagingWriter write, StagedCallback on_staged);
+        //  On the render thread: runs, in submission order, the callbacks of the buffers whose fence has
+        //  signaled, without waiting for the others
+        void poll_completed();
+
+        //  Staged or waiting to be
+        [[nodiscard]] unsigned int pending_uploads() const;
+
+    private:
+        struct Request {
+            std::size_t size;
+            StagingWriter write;
+            StagedCallback on_staged;
+        };
+
+        struct Staged {
+            StagingBuffer buffer;
+            GLsync fence;
+            StagedCallback on_staged;
+        };
+
+        void upload_loop();
+        [[nodiscard]] Staged fill_staging_buffer(Request& request) const;
+
+        std::unique_ptr<RenderingContext> context;
+        std::thread uploader;
+        std::mutex requests_mutex;
+        std::condition_variable requests_available;
+        std::deque<Request> requests;
+        bool stopping = false;
+
+        jobs::LockFreeQueue<Staged> staged_buffers;
+        std::deque<Staged> waiting_for_fence;       //  Only touched by the render thread
+        std::atomic<unsigned int> pending{0};
+    };
+}
+
+#endif //OPENGL3_UPLOAD_THREAD_H
@@ -0,0 +1,144 @@
+#include "program_binary_cache.h"
+
+#include <fmt/core.h>
+#include <glad/glad.h>
+
+#include <fstream>
+#include <vector>
+
+namespace engine::shader {
+    using namespace impl_details;
+
+    bool program_binaries_supported() {
+        if (!GLAD_GL_VERSION_4_1) {
+            return false;
+        }
+        int formats_count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats_count);
+        return formats_count > 0;
+    }
+
+    std::uint64_t driver_hash() {
+        //  A driver update changes GL_VERSION, which is what makes binaries of the previous one stale
+        auto hash = std::uint64_t{0xcbf29ce484222325};
+        for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const auto* value = reinterpret_cast<const char*>(glGetString(name));
+            hash = fnv1a(hash, value != nullptr ? std::string_view(value) : std::string_view());
+            hash = fnv1a(hash, std::string_view("\0", 1));
+        }
+        return hash;
+    }
+
+    std::uint64_t hash_program_stage(std::uint64_t key, const unsigned int gl_shader_type,
+                                     const std::string_view source) {
+        key = fnv1a(key, std::string_view(reinterpret_cast<const char*>(&gl_shader_type), sizeof(gl_shader_type)));
+        const auto length = static_cast<std::uint64_t>(source.size());
+        key = fnv1a(key, std::string_view(reinterpret_cast<const char*>(&length), sizeof(length)));
+        return fnv1a(key, source);
+    }
+
+    std::filesystem::path program_binary_path_for(const std::uint64_t key) {
+        return std::filesystem::path(program_binary_cache_directory) / fmt::format("{:016x}.progbin", key);
+    }
+
+    bool load_program_binary(const unsigned int program, const std::uint64_t key) {
+        const auto path = program_binary_path_for(key);
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            return false;
+        }
+
+        auto magic = std::array<char, 4>{};
+        auto version = std::uint32_t{0};
+        auto cached_key = std::uint64_t{0};
+        auto format = GLenum{0};
+        auto length = std::uint32_t{0};
+        stream.read(magic.data(), magic.size());
+        stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+        stream.read(reinterpret_cast<char*>(&cached_key), sizeof(cached_key));
+        stream.read(reinterpret_cast<char*>(&format), sizeof(format));
+        stream.read(reinterpret_cast<char*>(&length), sizeof(length));
+        if (!stream || magic != program_binary_magic || version != program_binary_cache_version ||
+            cached_key != key) {
+            fmt::print("[PROGRAM CACHE] {} is stale, the program will be compiled\n", path.string());
+            return false;
+        }
+
+        std::error_code error;
+        const auto file_size = std::filesystem::file_size(path, error);
+        if (error || length > file_size) {
+            fmt::print("[PROGRAM CACHE] {} is damaged, the program will be compiled\n", path.string());
+            return false;
+        }
+        std::vector<char> binary(length);
+        if (!stream.read(binary.data(), static_cast<std::streamsize>(length))) {
+            fmt::print("[PROGRAM CACHE] {} is damaged, the program will be compiled\n", path.string());
+            return false;
+        }
+
+        //  Drivers may refuse their own binaries, e.g. after an update that kept the version string
+        glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(length));
+        int linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked == 0) {
+            fmt::print("[PROGRAM CACHE] The driver refused {}, the program will be compiled\n", path.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool store_program_binary(const unsigned int program, const std::uint64_t key) {
+        int length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
+            return false;
+        }
+        std::vector<char> binary(static_cast<std::size_t>(length));
+        auto format = GLenum{0};
+        auto written = GLsizei{0};
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) {
+            return false;
+        }
+
+        const auto path = program_binary_path_for(key);
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        auto temporary_path = path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+            const auto binary_length = static_cast<std::uint32_t>(written);
+            stream.write(program_binary_magic.data(), program_binary_magic.size());
+            stream.write(reinterpret_cast<const char*>(&program_binary_cache_version),
+                         sizeof(program_binary_cache_version));
+            stream.write(reinterpret_cast<const char*>(&key), sizeof(key));
+            stream.write(reinterpret_cast<const char*>(&format), sizeof(format));
+            stream.write(reinterpret_cast<const char*>(&binary_length), sizeof(binary_length));
+            stream.write(binary.data(), static_cast<std::streamsize>(binary_length));
+            if (!stream) {
+                fmt::print("[PROGRAM CACHE] Writing {} failed\n", temporary_path.string());
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary_path, path, error);
+        if (error) {
+            fmt::print("[PROGRAM CACHE] Could not replace {}: {}\n", path.string(), error.message());
+            std::filesystem::remove(temporary_path, error);
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace engine::shader::impl_details {
+    std::uint64_t fnv1a(std::uint64_t hash, const std::string_view bytes) {
+        constexpr std::uint64_t fnv_prime = 0x100000001b3;
+        for (const auto byte : bytes) {
+            hash ^= static_cast<unsigned char>(byte);
+            hash *= fnv_prime;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef PROGRAM_BINARY_CACHE_H
+#define PROGRAM_BINARY_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace engine::shader {
+    //  Bump whenever the file layout changes, so older binaries are recompiled
+    constexpr std::uint32_t program_binary_cache_version = 1;
+
+    //  One native-endian file per program in program_binary_cache_directory, named after its key:
+    //    magic "EPRG", version, key, binary format, binary length, then the binary as glGetProgramBinary returns it.
+    //  The key hashes the driver (GL_VENDOR, GL_RENDERER and GL_VERSION) with every stage's type and full source,
+    //  so anything injected into a source before compilation is part of it as well.
+    constexpr std::string_view program_binary_cache_directory = "shader_cache";
+
+    //  Needs a current context; false when the driver has no program binary format
+    [[nodiscard]] bool program_binaries_supported();
+
+    //  Seed for program keys, stages are folded in with hash_program_stage
+    [[nodiscard]] std::uint64_t driver_hash();
+    [[nodiscard]] std::uint64_t hash_program_stage(std::uint64_t key, unsigned int gl_shader_type,
+                                                   std::string_view source);
+
+    [[nodiscard]] std::filesystem::path program_binary_path_for(std::uint64_t key);
+
+    //  Links program from the cached binary; false, leaving the program unlinked, when the binary is
+    //  missing, stale, damaged or refused by the driver
+    [[nodiscard]] bool load_program_binary(unsigned int program, std::uint64_t key);
+    //  The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+    //  Goes through a temporary file renamed at the end, so an interrupted write never leaves a truncated binary
+    bool store_program_binary(unsigned int program, std::uint64_t key);
+
+    namespace impl_details {
+        constexpr std::array<char, 4> program_binary_magic{'E', 'P', 'R', 'G'};
+
+        [[nodiscard]] std::uint64_t fnv1a(std::uint64_t hash, std::string_view bytes);
+    }
+}
+
+#endif //PROGRAM_BINARY_CACHE_H
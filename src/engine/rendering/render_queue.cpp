@@ -0,0 +1,74 @@
+#include "render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace engine {
+    std::uint64_t make_sort_key(const RenderPass pass, const unsigned int shader, const unsigned int material,
+                                const unsigned int vertex_array, const float depth, const DrawOrder order) {
+        using Layout = SortKeyLayout;
+        const auto field = [](const std::uint64_t value, const unsigned int bits) {
+            return value & ((std::uint64_t{1} << bits) - 1);
+        };
+        constexpr auto depth_steps = static_cast<float>((1u << Layout::depth_bits) - 1);
+        const auto quantized_depth = static_cast<std::uint64_t>(std::lround(std::clamp(depth, 0.0f, 1.0f) * depth_steps));
+
+        auto key = field(static_cast<std::uint64_t>(pass), Layout::pass_bits);
+        key = (key << Layout::shader_bits) | field(shader, Layout::shader_bits);
+        if (order == DrawOrder::Front_To_Back) {
+            key = (key << Layout::depth_bits) | field(quantized_depth, Layout::depth_bits);
+            key = (key << Layout::material_bits) | field(material, Layout::material_bits);
+            key = (key << Layout::vertex_array_bits) | field(vertex_array, Layout::vertex_array_bits);
+        } else {
+            key = (key << Layout::material_bits) | field(material, Layout::material_bits);
+            key = (key << Layout::vertex_array_bits) | field(vertex_array, Layout::vertex_array_bits);
+            key = (key << Layout::depth_bits) | field(quantized_depth, Layout::depth_bits);
+        }
+        return key;
+    }
+
+    void RenderQueue::clear() {
+        queued.clear();
+    }
+
+    void RenderQueue::push(const std::uint64_t key, const std::uint32_t payload) {
+        queued.push_back(DrawPacket{key, payload});
+    }
+
+    void RenderQueue::sort() {
+        if (queued.size() < 2) {
+            return;
+        }
+        scratch.resize(queued.size());
+
+        for (auto shift = 0u; shift < 64; shift += 8) {
+            std::array<std::size_t, 256> offsets{};
+            for (const auto& packet : queued) {
+                ++offsets[(packet.key >> shift) & 0xFF];
+            }
+            if (std::find(std::begin(offsets), std::end(offsets), queued.size()) != std::end(offsets)) {
+                continue;
+            }
+
+            std::size_t running_offset = 0;
+            for (auto& offset : offsets) {
+                const auto count = offset;
+                offset = running_offset;
+                running_offset += count;
+            }
+            for (const auto& packet : queued) {
+                scratch[offsets[(packet.key >> shift) & 0xFF]++] = packet;
+            }
+            std::swap(queued, scratch);
+        }
+    }
+
+    std::span<const DrawPacket> RenderQueue::packets() const {
+        return queued;
+    }
+
+    std::size_t RenderQueue::size() const {
+        return queued.size();
+    }
+}
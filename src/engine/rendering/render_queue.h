@@ -0,0 +1,57 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace engine {
+    enum class RenderPass : std::uint8_t {
+        GBuffer = 0,
+        Light_Mask = 1,
+        RSM = 2,
+        Wireframe = 3
+    };
+
+    enum class DrawOrder {
+        State_Changes_First,    //  pass | shader | material | vertex array | depth
+        Front_To_Back           //  pass | shader | depth | material | vertex array, for early-Z rejection
+    };
+
+    struct DrawPacket {
+        std::uint64_t key;
+        std::uint32_t payload;  //  What the pass needs to issue the draw, e.g. the index of a scene object
+    };
+
+    //  Bit widths of the key fields; ids wider than their field are truncated, which only costs sorting quality
+    struct SortKeyLayout {
+        static constexpr unsigned int pass_bits = 4;
+        static constexpr unsigned int shader_bits = 8;
+        static constexpr unsigned int material_bits = 16;
+        static constexpr unsigned int vertex_array_bits = 16;
+        static constexpr unsigned int depth_bits = 20;
+    };
+    static_assert(SortKeyLayout::pass_bits + SortKeyLayout::shader_bits + SortKeyLayout::material_bits +
+                  SortKeyLayout::vertex_array_bits + SortKeyLayout::depth_bits == 64);
+
+    //  depth is in [0, 1], 0 being closest to the viewer
+    [[nodiscard]] std::uint64_t make_sort_key(RenderPass pass, unsigned int shader, unsigned int material,
+                                              unsigned int vertex_array, float depth, DrawOrder order);
+
+    class RenderQueue {
+    public:
+        void clear();
+        void push(std::uint64_t key, std::uint32_t payload);
+        //  Stable LSD radix sort on bytes of the key; bytes that are equal in every packet are skipped
+        void sort();
+
+        [[nodiscard]] std::span<const DrawPacket> packets() const;
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        std::vector<DrawPacket> queued;
+        std::vector<DrawPacket> scratch;
+    };
+}
+
+#endif //RENDER_QUEUE_H
@@ -4,9 +4,17 @@ namespace engine {
     std::vector<std::unique_ptr<Shader>> OpenGL3_Renderer::loaded_shaders;
 
     void OpenGL3_Renderer::initialize() {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
+        enable(GL_BLEND);
+        set_blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        enable(GL_DEPTH_TEST);
+    }
+
+    void OpenGL3_Renderer::begin_frame() {
+        OpenGL3_State_Cache::begin_frame();
+    }
+
+    OpenGL3_State_Counters OpenGL3_Renderer::state_counters() {
+        return OpenGL3_State_Cache::last_frame_counters();
     }
 
     void OpenGL3_Renderer::clear(const int bitmask) {
@@ -23,13 +31,48 @@ namespace engine {
 
     void OpenGL3_Renderer::set_viewport(const unsigned int origin_x, const unsigned int origin_y,
                                         const unsigned int width, const unsigned int height) {
-        glViewport(origin_x, origin_y, width, height);
+        OpenGL3_State_Cache::set_viewport(origin_x, origin_y, width, height);
+    }
+
+    void OpenGL3_Renderer::enable(const GLenum capability) {
+        OpenGL3_State_Cache::set_capability(capability, true);
+    }
+
+    void OpenGL3_Renderer::disable(const GLenum capability) {
+        OpenGL3_State_Cache::set_capability(capability, false);
+    }
+
+    void OpenGL3_Renderer::set_blend_function(const GLenum source_factor, const GLenum destination_factor) {
+        OpenGL3_State_Cache::set_blend_function(source_factor, destination_factor);
+    }
+
+    void OpenGL3_Renderer::set_blend_equation(const GLenum mode) {
+        OpenGL3_State_Cache::set_blend_equation(mode);
+    }
+
+    void OpenGL3_Renderer::set_cull_face(const GLenum face) {
+        OpenGL3_State_Cache::set_cull_face(face);
+    }
+
+    void OpenGL3_Renderer::set_polygon_mode(const GLenum mode) {
+        OpenGL3_State_Cache::set_polygon_mode(mode);
     }
 
     void OpenGL3_Renderer::draw(const VertexArray& vao) {
         vao.bind();
         glDrawElements(GL_TRIANGLES, vao.get_ebo()->get_count(), GL_UNSIGNED_INT, nullptr);
-        vao.unbind();
+    }
+
+    void OpenGL3_Renderer::draw(const VertexArray& vao, const GeometryRange& range) {
+        vao.bind();
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.index_count), GL_UNSIGNED_INT,
+                                 reinterpret_cast<const void*>(range.first_index * sizeof(unsigned int)),
+                                 range.base_vertex);
+    }
+
+    void OpenGL3_Renderer::multi_draw_indirect(const VertexArray& vao, const unsigned int draw_count) {
+        vao.bind();
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(draw_count), 0);
     }
 
     unsigned int OpenGL3_Renderer::register_shader(std::unique_ptr<Shader>&& shader_to_register) {
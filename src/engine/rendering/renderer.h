@@ -1,6 +1,8 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "geometry_pool.h"
+#include "opengl3_state_cache.h"
 #include "vertex_array.h"
 #include "shader.h"
 
@@ -11,6 +13,9 @@ namespace engine{
     class OpenGL3_Renderer{
     public:
         static void initialize();
+        //  Call once per frame, before any rendering: GL state changed by others is no longer trusted
+        static void begin_frame();
+        [[nodiscard]] static OpenGL3_State_Counters state_counters();
 
         static void clear(const int bitmask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         static void set_clear_color(const glm::vec4& clear_color = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
@@ -19,7 +24,17 @@ namespace engine{
         static void set_viewport(const unsigned int origin_x, const unsigned int origin_y,
                                  const unsigned int width, const unsigned int height);
 
+        static void enable(GLenum capability);
+        static void disable(GLenum capability);
+        static void set_blend_function(GLenum source_factor, GLenum destination_factor);
+        static void set_blend_equation(GLenum mode);
+        static void set_cull_face(GLenum face);
+        static void set_polygon_mode(GLenum mode);
+
         static void draw(const VertexArray& vao);
+        static void draw(const VertexArray& vao, const GeometryRange& range);
+        //  Commands are read from the buffer bound to GL_DRAW_INDIRECT_BUFFER, tightly packed
+        static void multi_draw_indirect(const VertexArray& vao, unsigned int draw_count);
 
         static unsigned int register_shader(std::unique_ptr<Shader>&& shader_to_register);
         static Shader* get_registered_shader(unsigned int shader_index);
@@ -12,6 +12,15 @@ namespace engine {
 
         virtual void swap_buffers() = 0;
 
+        //  A context sharing buffers, textures and sync objects with this one, but not container objects
+        //  such as vertex arrays and framebuffers. Must be created on the thread that owns the window, and
+        //  made current on the thread that uses it.
+        [[nodiscard]] virtual std::unique_ptr<RenderingContext> create_shared_context() const = 0;
+
+        virtual void make_current() = 0;
+
+        virtual void release_current() = 0;
+
         static std::unique_ptr<RenderingContext> create(void *window);
     };
 }
@@ -1,5 +1,7 @@
 #include "shader.h"
 
+#include "program_binary_cache.h"
+
 namespace engine {
     Shader::Shader(std::string&& vertex_src, std::string&& fragment_src, const std::string_view vertex_name,
                    const std::string_view fragment_name) {
@@ -24,12 +26,31 @@ namespace engine {
         initialize_from_sources<3>(sources);
     }
 
+    Shader::Shader(std::string&& compute_src, const std::string_view compute_name) {
+        const std::array<shader_object_src, 1> sources{
+                shader_object_src{compute_src, compute_name, GL_COMPUTE_SHADER}
+        };
+
+        initialize_from_sources<1>(sources);
+    }
+
+    Shader::Shader(const unsigned int linking_program, std::vector<std::shared_ptr<ShaderStage>>&& attached_stages,
+                   const std::optional<std::uint64_t> binary_cache_key)
+            : id{linking_program}, link_pending{true}, pending_stages{std::move(attached_stages)},
+              pending_binary_key{binary_cache_key} {}
+
+    bool Shader::successfully_built() const {
+        finish_linking();
+        return built;
+    }
+
     void Shader::use() const {
-        glUseProgram(this->id);
+        finish_linking();
+        OpenGL3_State_Cache::use_program(this->id);
     }
 
     void Shader::set_int(const std::string_view name, const int val) const noexcept {
-        glUniform1i(glGetUniformLocation(id, name.data()), val);
+        glUniform1i(location_of(name), val);
     }
 
     void Shader::set_int(const int location, const int val) const noexcept {
@@ -37,7 +58,7 @@ namespace engine {
     }
 
     void Shader::set_bool(const std::string_view name, const bool val) const noexcept {
-        glUniform1i(glGetUniformLocation(id, name.data()), static_cast<int>(val));
+        glUniform1i(location_of(name), static_cast<int>(val));
     }
 
     void Shader::set_bool(const int location, const bool val) const noexcept {
@@ -45,11 +66,11 @@ namespace engine {
     }
 
     void Shader::set_vec2(const std::string_view name, const glm::vec2 v) const noexcept {
-        glUniform2f(glGetUniformLocation(id, name.data()), v.x, v.y);
+        glUniform2f(location_of(name), v.x, v.y);
     }
 
     void Shader::set_vec2(const std::string_view name, const float vx, const float vy) const noexcept {
-        glUniform2f(glGetUniformLocation(id, name.data()), vx, vy);
+        glUniform2f(location_of(name), vx, vy);
     }
 
     void Shader::set_vec2(const int location, const glm::vec2 v) const noexcept {
@@ -61,11 +82,11 @@ namespace engine {
     }
 
     void Shader::set_vec3(const std::string_view name, const glm::vec3 v) const noexcept {
-        glUniform3f(glGetUniformLocation(id, name.data()), v.x, v.y, v.z);
+        glUniform3f(location_of(name), v.x, v.y, v.z);
     }
 
     void Shader::set_vec3(const std::string_view name, const float vx, const float vy, const float vz) const noexcept {
-        glUniform3f(glGetUniformLocation(id, name.data()), vx, vy, vz);
+        glUniform3f(location_of(name), vx, vy, vz);
     }
 
     void Shader::set_vec3(const int location, const glm::vec3 v) const noexcept {
@@ -77,12 +98,12 @@ namespace engine {
     }
 
     void Shader::set_vec4(const std::string_view name, const glm::vec4 v) const noexcept {
-        glUniform4f(glGetUniformLocation(id, name.data()), v.x, v.y, v.z, v.w);
+        glUniform4f(location_of(name), v.x, v.y, v.z, v.w);
     }
 
     void Shader::set_vec4(const std::string_view name, const float vx, const float vy, const float vz,
                           const float vw) const noexcept {
-        glUniform4f(glGetUniformLocation(id, name.data()), vx, vy, vz, vw);
+        glUniform4f(location_of(name), vx, vy, vz, vw);
     }
 
     void Shader::set_vec4(const int location, const glm::vec4 v) const noexcept {
@@ -95,7 +116,7 @@ namespace engine {
     }
 
     void Shader::set_mat4(const std::string_view name, const glm::mat4 mat) const noexcept {
-        glUniformMatrix4fv(glGetUniformLocation(id, name.data()), 1, GL_FALSE, glm::value_ptr(mat));
+        glUniformMatrix4fv(location_of(name), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
 
@@ -104,7 +125,7 @@ namespace engine {
     }
 
     void Shader::set_uint(const std::string_view name, const unsigned int val) const noexcept {
-        glUniform1ui(glGetUniformLocation(id, name.data()), val);
+        glUniform1ui(location_of(name), val);
     }
 
     void Shader::set_uint(const int location, const unsigned int val) const noexcept {
@@ -112,21 +133,131 @@ namespace engine {
     }
 
     void Shader::set_float(const std::string_view name, const float val) const noexcept {
-        glUniform1f(glGetUniformLocation(id, name.data()), val);
+        glUniform1f(location_of(name), val);
     }
 
     void Shader::set_float(const int location, const float val) const noexcept {
         glUniform1f(location, val);
     }
 
+    const ShaderUniform* Shader::find_uniform(const std::string_view name) const {
+        finish_linking();
+        const auto found = uniforms.find(name);
+        return found != std::end(uniforms) ? &found->second : nullptr;
+    }
+
+    const ShaderUniformBlock* Shader::find_uniform_block(const std::string_view name) const {
+        finish_linking();
+        const auto found = uniform_blocks.find(name);
+        return found != std::end(uniform_blocks) ? &found->second : nullptr;
+    }
+
+    int Shader::location_of(const std::string_view name) const noexcept {
+        finish_linking();
+        const auto found = uniforms.find(name);
+        return found != std::end(uniforms) ? found->second.location : -1;
+    }
+
+    void Shader::finish_linking() const {
+        if (!link_pending) {
+            return;
+        }
+        link_pending = false;
+
+        //  Every stage is checked, so that all of the compile errors get printed
+        built = true;
+        for (const auto& stage : pending_stages) {
+            if (!stage->compiled.has_value()) {
+                stage->compiled = check_shader_object_compilation(stage->id, stage->name);
+            }
+            built &= *stage->compiled;
+        }
+        built &= check_shader_program_linking(id);
+        for (const auto& stage : pending_stages) {
+            glDetachShader(id, stage->id);
+        }
+        pending_stages.clear();
+
+        if (built) {
+            reflect_active_interface();
+            if (pending_binary_key.has_value()) {
+                shader::store_program_binary(id, *pending_binary_key);
+            }
+        }
+    }
+
+    void Shader::reflect_active_interface() const {
+        int uniforms_count = 0;
+        int longest_name = 0;
+        glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniforms_count);
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &longest_name);
+        std::string name(static_cast<std::size_t>(std::max(longest_name, 1)), '\0');
+
+        for (auto i = 0u; i < static_cast<unsigned int>(uniforms_count); ++i) {
+            int length = 0;
+            int array_size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(id, i, static_cast<GLsizei>(name.size()), &length, &array_size, &type, name.data());
+            int block_index = -1;
+            int block_offset = -1;
+            glGetActiveUniformsiv(id, 1, &i, GL_UNIFORM_BLOCK_INDEX, &block_index);
+            glGetActiveUniformsiv(id, 1, &i, GL_UNIFORM_OFFSET, &block_offset);
+
+            auto uniform_name = name.substr(0, static_cast<std::size_t>(length));
+            const auto location = block_index < 0 ? glGetUniformLocation(id, uniform_name.c_str()) : -1;
+            uniforms.insert_or_assign(uniform_name, ShaderUniform{location, type, array_size, block_index, block_offset});
+
+            //  Arrays are reported as "name[0]"; "name" and every "name[i]" resolve too, as with glGetUniformLocation
+            if (!uniform_name.ends_with("[0]")) {
+                continue;
+            }
+            const auto array_name = uniform_name.substr(0, uniform_name.size() - 3);
+            uniforms.insert_or_assign(array_name, ShaderUniform{location, type, array_size, block_index, block_offset});
+            for (auto element = 1; element < array_size && block_index < 0; ++element) {
+                const auto element_name = fmt::format("{}[{}]", array_name, element);
+                uniforms.insert_or_assign(element_name, ShaderUniform{glGetUniformLocation(id, element_name.c_str()),
+                                                                      type, array_size - element, -1, -1});
+            }
+        }
+
+        int blocks_count = 0;
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_BLOCKS, &blocks_count);
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &longest_name);
+        name.assign(static_cast<std::size_t>(std::max(longest_name, 1)), '\0');
+        for (auto i = 0u; i < static_cast<unsigned int>(blocks_count); ++i) {
+            int length = 0;
+            glGetActiveUniformBlockName(id, i, static_cast<GLsizei>(name.size()), &length, name.data());
+            ShaderUniformBlock block{i, 0, 0};
+            glGetActiveUniformBlockiv(id, i, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+            glGetActiveUniformBlockiv(id, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.data_size);
+            uniform_blocks.insert_or_assign(name.substr(0, static_cast<std::size_t>(length)), block);
+        }
+    }
+
     template<int source_size>
     void Shader::initialize_from_sources(const std::array<shader_object_src, source_size>& sources) {
+        const auto cache_binaries = shader::program_binaries_supported();
+        auto cache_key = std::uint64_t{0};
+        if (cache_binaries) {
+            cache_key = shader::driver_hash();
+            for (const auto& s : sources) {
+                cache_key = shader::hash_program_stage(cache_key, s.type, s.source);
+            }
+            id = glCreateProgram();
+            if (shader::load_program_binary(id, cache_key)) {
+                built = true;
+                reflect_active_interface();
+                return;
+            }
+            glDeleteProgram(id);
+        }
+
         std::array<unsigned int, source_size> shader_objects;
 
-        successfully_built = true;
+        built = true;
         std::transform(std::begin(sources), std::end(sources), std::begin(shader_objects), [this](const auto& s) {
             const auto shader_id = this->shader_object_from(s.source.data(), s.type);
-            successfully_built &= check_shader_object_compilation(shader_id, s.name);
+            built &= check_shader_object_compilation(shader_id, s.name);
             return shader_id;
         });
 
@@ -136,8 +267,17 @@ namespace engine {
             glAttachShader(id, shader_object);
         }
 
+        if (cache_binaries) {
+            glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
         glLinkProgram(id);
-        successfully_built &= check_shader_program_linking(id);
+        built &= check_shader_program_linking(id);
+        if (built) {
+            reflect_active_interface();
+            if (cache_binaries) {
+                shader::store_program_binary(id, cache_key);
+            }
+        }
         for (const auto shader_object : shader_objects) {
             glDeleteShader(shader_object);
         }
@@ -177,4 +317,114 @@ namespace engine {
         }
         return true;
     }
+}
+
+namespace engine::impl_details {
+    bool is_sampler_type(const GLenum type) {
+        switch (type) {
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_1D_SHADOW:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_1D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_1D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_SAMPLER_BUFFER:
+            case GL_SAMPLER_2D_RECT:
+            case GL_SAMPLER_2D_RECT_SHADOW:
+            case GL_INT_SAMPLER_1D:
+            case GL_INT_SAMPLER_2D:
+            case GL_INT_SAMPLER_3D:
+            case GL_INT_SAMPLER_CUBE:
+            case GL_INT_SAMPLER_1D_ARRAY:
+            case GL_INT_SAMPLER_2D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_1D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_3D:
+            case GL_UNSIGNED_INT_SAMPLER_CUBE:
+            case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    //  Samplers are set through their texture unit
+    bool matches_glsl_type(const GLenum type, std::type_identity<int>) {
+        return type == GL_INT || type == GL_BOOL || is_sampler_type(type);
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<unsigned int>) {
+        return type == GL_UNSIGNED_INT || type == GL_BOOL;
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<bool>) {
+        return type == GL_BOOL || type == GL_INT;
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<float>) {
+        return type == GL_FLOAT;
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<glm::vec2>) {
+        return type == GL_FLOAT_VEC2;
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<glm::vec3>) {
+        return type == GL_FLOAT_VEC3;
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<glm::vec4>) {
+        return type == GL_FLOAT_VEC4;
+    }
+
+    bool matches_glsl_type(const GLenum type, std::type_identity<glm::mat4>) {
+        return type == GL_FLOAT_MAT4;
+    }
+
+    void upload_uniform(const int location, const int count, const int* values) noexcept {
+        glUniform1iv(location, count, values);
+    }
+
+    void upload_uniform(const int location, const int count, const unsigned int* values) noexcept {
+        glUniform1uiv(location, count, values);
+    }
+
+    void upload_uniform(const int location, const int count, const bool* values) noexcept {
+        //  Converted in bounded chunks; elements of a basic-type array take consecutive locations
+        constexpr auto chunk_size = 16;
+        std::array<int, chunk_size> as_ints{};
+        for (auto first = 0; first < count; first += chunk_size) {
+            const auto chunk_count = std::min(chunk_size, count - first);
+            std::copy_n(values + first, chunk_count, as_ints.begin());
+            glUniform1iv(location + first, chunk_count, as_ints.data());
+        }
+    }
+
+    void upload_uniform(const int location, const int count, const float* values) noexcept {
+        glUniform1fv(location, count, values);
+    }
+
+    void upload_uniform(const int location, const int count, const glm::vec2* values) noexcept {
+        glUniform2fv(location, count, glm::value_ptr(values[0]));
+    }
+
+    void upload_uniform(const int location, const int count, const glm::vec3* values) noexcept {
+        glUniform3fv(location, count, glm::value_ptr(values[0]));
+    }
+
+    void upload_uniform(const int location, const int count, const glm::vec4* values) noexcept {
+        glUniform4fv(location, count, glm::value_ptr(values[0]));
+    }
+
+    void upload_uniform(const int location, const int count, const glm::mat4* values) noexcept {
+        glUniformMatrix4fv(location, count, GL_FALSE, glm::value_ptr(values[0]));
+    }
 }
\ No newline at end of file
@@ -1,20 +1,100 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include "opengl3_state_cache.h"
+
 #include <fmt/core.h>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <string>
 #include <string_view>
 #include <array>
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace engine {
+    struct ShaderUniform {
+        int location;           //  -1 for members of uniform blocks
+        GLenum type;
+        int array_size;
+        int block_index;        //  -1 outside of uniform blocks
+        int block_offset;       //  -1 outside of uniform blocks
+    };
+
+    struct ShaderUniformBlock {
+        unsigned int index;
+        int binding;
+        int data_size;
+    };
+
+    //  Shader object shared by the programs of a ShaderLibrary; the first of them to be used checks whether
+    //  it compiled, the others reuse the answer
+    struct ShaderStage {
+        unsigned int id;
+        std::string name;
+        std::optional<bool> compiled;
+    };
+
+    //  Location of an active uniform, checked against its GLSL type when it is resolved.
+    //  Handles of uniforms that are missing or of the wrong type are invalid and ignored when set.
+    template <typename T>
+    class Uniform {
+    public:
+        Uniform() = default;
+
+        [[nodiscard]] bool is_valid() const { return location >= 0; }
+        [[nodiscard]] int elements() const { return array_size; }
+
+    private:
+        friend class Shader;
+
+        Uniform(const int uniform_location, const int uniform_array_size)
+                : location{uniform_location}, array_size{uniform_array_size} {}
+
+        int location = -1;
+        int array_size = 0;
+    };
+
+    namespace impl_details {
+        struct StringHash {
+            using is_transparent = void;
+
+            [[nodiscard]] std::size_t operator()(const std::string_view s) const noexcept {
+                return std::hash<std::string_view>{}(s);
+            }
+        };
+
+        [[nodiscard]] bool is_sampler_type(GLenum type);
+
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<int>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<unsigned int>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<bool>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<float>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<glm::vec2>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<glm::vec3>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<glm::vec4>);
+        [[nodiscard]] bool matches_glsl_type(GLenum type, std::type_identity<glm::mat4>);
+
+        void upload_uniform(int location, int count, const int* values) noexcept;
+        void upload_uniform(int location, int count, const unsigned int* values) noexcept;
+        void upload_uniform(int location, int count, const bool* values) noexcept;
+        void upload_uniform(int location, int count, const float* values) noexcept;
+        void upload_uniform(int location, int count, const glm::vec2* values) noexcept;
+        void upload_uniform(int location, int count, const glm::vec3* values) noexcept;
+        void upload_uniform(int location, int count, const glm::vec4* values) noexcept;
+        void upload_uniform(int location, int count, const glm::mat4* values) noexcept;
+    }
+
     class Shader {
     public:
         unsigned int id;
-        bool successfully_built;
 
         Shader(std::string&& vertex_src, std::string&& fragment_src,
                const std::string_view vertex_name = "vertex", const std::string_view fragment_name = "fragment");
@@ -22,6 +102,15 @@ namespace engine {
                const std::string_view vertex_name = "vertex",
                const std::string_view geometry_name = "geometry",
                const std::string_view fragment_name = "fragment");
+        explicit Shader(std::string&& compute_src, const std::string_view compute_name = "compute");
+        //  Takes a program whose link has been issued but not waited for, with the stages attached to it.
+        //  Statuses are queried when the program is first used; once linked, the program is stored in the
+        //  binary cache under binary_cache_key, if there is one.
+        Shader(unsigned int linking_program, std::vector<std::shared_ptr<ShaderStage>>&& attached_stages,
+               std::optional<std::uint64_t> binary_cache_key);
+
+        //  Waits for a pending link
+        [[nodiscard]] bool successfully_built() const;
 
         void use() const;
         void set_int(const std::string_view name, const int val) const noexcept;
@@ -47,6 +136,21 @@ namespace engine {
         void set_float(const std::string_view name, const float val) const noexcept;
         void set_float(const int location, const float val) const noexcept;
 
+        //  Both use the tables filled at link time; array elements can be looked up as "name[i]"
+        [[nodiscard]] const ShaderUniform* find_uniform(std::string_view name) const;
+        [[nodiscard]] const ShaderUniformBlock* find_uniform_block(std::string_view name) const;
+        [[nodiscard]] const auto& active_uniforms() const { finish_linking(); return uniforms; }
+        [[nodiscard]] const auto& active_uniform_blocks() const { finish_linking(); return uniform_blocks; }
+
+        template <typename T>
+        [[nodiscard]] Uniform<T> uniform(std::string_view name) const;
+
+        //  The program must be in use
+        template <typename T>
+        void set(Uniform<T> handle, const T& value) const noexcept;
+        template <typename T>
+        void set(Uniform<T> handle, const T* values, int count) const noexcept;
+
     private:
         struct shader_object_src{
             std::string_view source;
@@ -61,7 +165,46 @@ namespace engine {
         static bool         check_shader_object_compilation(const unsigned int shader_id, const std::string_view shader_name);
         static bool         check_shader_program_linking(const unsigned int shader_id);
 
+        void finish_linking() const;
+        void reflect_active_interface() const;
+        [[nodiscard]] int location_of(std::string_view name) const noexcept;
+
+        //  Everything below is settled by finish_linking, which the const accessors call
+        mutable bool built = false;
+        mutable bool link_pending = false;
+        mutable std::vector<std::shared_ptr<ShaderStage>> pending_stages;
+        mutable std::optional<std::uint64_t> pending_binary_key;
+        mutable std::unordered_map<std::string, ShaderUniform, impl_details::StringHash, std::equal_to<>> uniforms;
+        mutable std::unordered_map<std::string, ShaderUniformBlock, impl_details::StringHash, std::equal_to<>> uniform_blocks;
     };
+
+    template <typename T>
+    Uniform<T> Shader::uniform(const std::string_view name) const {
+        finish_linking();
+        const auto uniform = find_uniform(name);
+        if (uniform == nullptr || uniform->location < 0) {
+            fmt::print("[SHADER] Program {} has no active uniform named {}\n", id, name);
+            return {};
+        }
+        if (!impl_details::matches_glsl_type(uniform->type, std::type_identity<T>{})) {
+            fmt::print("[SHADER] Uniform {} of program {} has GLSL type 0x{:X}, which does not match the handle\n",
+                       name, id, uniform->type);
+            return {};
+        }
+        return Uniform<T>(uniform->location, uniform->array_size);
+    }
+
+    template <typename T>
+    void Shader::set(const Uniform<T> handle, const T& value) const noexcept {
+        set(handle, &value, 1);
+    }
+
+    template <typename T>
+    void Shader::set(const Uniform<T> handle, const T* values, const int count) const noexcept {
+        if (handle.is_valid()) {
+            impl_details::upload_uniform(handle.location, std::min(count, handle.array_size), values);
+        }
+    }
 }
 
 #endif //SHADER_H
@@ -0,0 +1,130 @@
+#include "shader_library.h"
+
+#include "program_binary_cache.h"
+
+#include <fmt/core.h>
+
+#include <array>
+
+namespace engine {
+    ShaderLibrary::ShaderLibrary() : cache_binaries{shader::program_binaries_supported()} {
+        if (GLAD_GL_KHR_parallel_shader_compile) {
+            //  As many compiler threads as the driver is willing to use
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        }
+        if (cache_binaries) {
+            driver_key = shader::driver_hash();
+        }
+    }
+
+    ShaderLibrary::~ShaderLibrary() {
+        for (const auto& [path, stage] : stages) {
+            if (stage.compiled) {
+                glDeleteShader(stage.compiled->id);
+            }
+        }
+    }
+
+    std::shared_ptr<Shader> ShaderLibrary::program(const std::string& vertex_path, const std::string& fragment_path,
+                                                   const shader::ShaderDefines& defines) {
+        auto& cached = programs[fmt::format("{}|{}|{}", vertex_path, fragment_path,
+                                            shader::permutation_key(defines))];
+        if (!cached) {
+            const std::array<LoadedStage*, 2> program_stages{&stage_from(vertex_path, GL_VERTEX_SHADER, defines),
+                                                             &stage_from(fragment_path, GL_FRAGMENT_SHADER, defines)};
+            cached = link(program_stages);
+        }
+        return cached;
+    }
+
+    std::shared_ptr<Shader> ShaderLibrary::program(const std::string& vertex_path, const std::string& fragment_path,
+                                                   const std::string& geometry_path,
+                                                   const shader::ShaderDefines& defines) {
+        auto& cached = programs[fmt::format("{}|{}|{}|{}", vertex_path, fragment_path, geometry_path,
+                                            shader::permutation_key(defines))];
+        if (!cached) {
+            const std::array<LoadedStage*, 3> program_stages{&stage_from(vertex_path, GL_VERTEX_SHADER, defines),
+                                                             &stage_from(geometry_path, GL_GEOMETRY_SHADER, defines),
+                                                             &stage_from(fragment_path, GL_FRAGMENT_SHADER, defines)};
+            cached = link(program_stages);
+        }
+        return cached;
+    }
+
+    std::shared_ptr<Shader> ShaderLibrary::compute_program(const std::string& compute_path,
+                                                           const shader::ShaderDefines& defines) {
+        auto& cached = programs[fmt::format("{}|{}", compute_path, shader::permutation_key(defines))];
+        if (!cached) {
+            const std::array<LoadedStage*, 1> program_stages{&stage_from(compute_path, GL_COMPUTE_SHADER, defines)};
+            cached = link(program_stages);
+        }
+        return cached;
+    }
+
+    std::size_t ShaderLibrary::compiled_stages_count() const {
+        return static_cast<std::size_t>(std::count_if(std::begin(stages), std::end(stages), [](const auto& entry) {
+            return entry.second.compiled != nullptr;
+        }));
+    }
+
+    std::size_t ShaderLibrary::programs_count() const {
+        return programs.size();
+    }
+
+    ShaderLibrary::LoadedStage& ShaderLibrary::stage_from(const std::string& path, const GLenum type,
+                                                          const shader::ShaderDefines& defines) {
+        const auto absolute_path = files::make_path_absolute(std::string(path));
+        auto& source = sources[absolute_path.string()];
+        if (source.empty()) {
+            source = shader::resolve_includes(files::read_file(absolute_path), absolute_path);
+        }
+
+        const auto used_defines = shader::defines_used_by(source, defines);
+        const auto key = fmt::format("{}|{}", absolute_path.string(), shader::permutation_key(used_defines));
+        if (const auto found = stages.find(key); found != std::end(stages)) {
+            return found->second;
+        }
+        auto permutation = shader::inject_defines(std::string(source), used_defines);
+        return stages.emplace(key, LoadedStage{std::move(permutation), absolute_path.filename().string(), type,
+                                               nullptr}).first->second;
+    }
+
+    std::shared_ptr<Shader> ShaderLibrary::link(const std::span<LoadedStage* const> program_stages) {
+        auto program = glCreateProgram();
+        auto binary_key = std::optional<std::uint64_t>{};
+        if (cache_binaries) {
+            auto key = driver_key;
+            for (const auto* stage : program_stages) {
+                key = shader::hash_program_stage(key, stage->type, stage->source);
+            }
+            if (shader::load_program_binary(program, key)) {
+                return std::make_shared<Shader>(program, std::vector<std::shared_ptr<ShaderStage>>{}, std::nullopt);
+            }
+            //  A refused binary can leave the program in a state the driver will not link from
+            glDeleteProgram(program);
+            program = glCreateProgram();
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            binary_key = key;
+        }
+
+        std::vector<std::shared_ptr<ShaderStage>> attached;
+        attached.reserve(program_stages.size());
+        for (auto* stage : program_stages) {
+            if (!stage->compiled) {
+                compile(*stage);
+            }
+            glAttachShader(program, stage->compiled->id);
+            attached.push_back(stage->compiled);
+        }
+        glLinkProgram(program);
+        return std::make_shared<Shader>(program, std::move(attached), binary_key);
+    }
+
+    void ShaderLibrary::compile(LoadedStage& stage) {
+        const auto id = glCreateShader(stage.type);
+        const auto* source = stage.source.c_str();
+        glShaderSource(id, 1, &source, nullptr);
+        glCompileShader(id);
+        stage.compiled = std::make_shared<ShaderStage>(ShaderStage{id, stage.name, std::nullopt});
+    }
+}
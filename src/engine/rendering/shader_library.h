@@ -0,0 +1,67 @@
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include "shader.h"
+#include "shader_loading.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace engine {
+    //  Reads and compiles every stage file once, however many programs attach it. Compiles and links are
+    //  issued without waiting for them, so the driver can work on all the programs of a layer at once, on
+    //  its own threads when it has KHR_parallel_shader_compile; each program waits for its link when it is
+    //  first used. Programs found in the binary cache skip their stages altogether.
+    //  Permutations are programs built with defines: each is compiled the first time it is asked for and kept
+    //  under its paths and defines, and a stage only gets, and is only compiled again for, the defines it mentions.
+    class ShaderLibrary {
+    public:
+        //  Needs a current context
+        ShaderLibrary();
+
+        ShaderLibrary(const ShaderLibrary& other) = delete;
+        ShaderLibrary(ShaderLibrary&& other) = delete;
+        ShaderLibrary& operator=(const ShaderLibrary& other) = delete;
+        ShaderLibrary& operator=(ShaderLibrary&& other) = delete;
+        //  Stages still attached to a pending program live on until it is linked
+        ~ShaderLibrary();
+
+        [[nodiscard]] std::shared_ptr<Shader> program(const std::string& vertex_path,
+                                                      const std::string& fragment_path,
+                                                      const shader::ShaderDefines& defines = {});
+        [[nodiscard]] std::shared_ptr<Shader> program(const std::string& vertex_path,
+                                                      const std::string& fragment_path,
+                                                      const std::string& geometry_path,
+                                                      const shader::ShaderDefines& defines = {});
+        [[nodiscard]] std::shared_ptr<Shader> compute_program(const std::string& compute_path,
+                                                              const shader::ShaderDefines& defines = {});
+
+        [[nodiscard]] std::size_t compiled_stages_count() const;
+        [[nodiscard]] std::size_t programs_count() const;
+
+    private:
+        struct LoadedStage {
+            std::string source;
+            std::string name;
+            GLenum type;
+            std::shared_ptr<ShaderStage> compiled;      //  Empty until a program misses the binary cache
+        };
+
+        LoadedStage& stage_from(const std::string& path, GLenum type, const shader::ShaderDefines& defines);
+        [[nodiscard]] std::shared_ptr<Shader> link(std::span<LoadedStage* const> stages);
+        static void compile(LoadedStage& stage);
+
+        std::unordered_map<std::string, std::string> sources;      //  By absolute path, as read from the file
+        std::unordered_map<std::string, LoadedStage> stages;       //  By absolute path and the defines it got
+        std::unordered_map<std::string, std::shared_ptr<Shader>> programs;     //  By stage paths and defines
+        bool cache_binaries;
+        std::uint64_t driver_key = 0;
+    };
+}
+
+#endif //SHADER_LIBRARY_H
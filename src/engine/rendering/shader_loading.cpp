@@ -1,13 +1,19 @@
 #include "shader_loading.h"
 
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <string_view>
+
 namespace engine::shader{
 
     std::shared_ptr<Shader> create_shader_from(const std::string& vertex_path_as_string,
-                                               const std::string& fragment_path_as_string){
+                                               const std::string& fragment_path_as_string,
+                                               const ShaderDefines& defines){
         const auto vertex_path = files::make_path_absolute(std::string(vertex_path_as_string));
         const auto fragment_path = files::make_path_absolute(std::string(fragment_path_as_string));
-        auto vertex_source = files::read_file(vertex_path);
-        auto fragment_source = files::read_file(fragment_path);
+        auto vertex_source = inject_defines(resolve_includes(files::read_file(vertex_path), vertex_path), defines);
+        auto fragment_source = inject_defines(resolve_includes(files::read_file(fragment_path), fragment_path), defines);
         const std::string vertex_filename(vertex_path.filename().string());
         const std::string fragment_filename(fragment_path.filename().string());
         return std::make_shared<Shader>(std::move(vertex_source),
@@ -17,14 +23,14 @@ namespace engine::shader{
     }
 
     std::shared_ptr<Shader>
-    shader::create_shader_from(const std::string& vertex_path_as_string, const std::string& fragment_path_as_string,
-                               const std::string& geometry_path_as_string) {
+    create_shader_from(const std::string& vertex_path_as_string, const std::string& fragment_path_as_string,
+                       const std::string& geometry_path_as_string, const ShaderDefines& defines) {
         const auto vertex_path = files::make_path_absolute(std::string(vertex_path_as_string));
         const auto fragment_path = files::make_path_absolute(std::string(fragment_path_as_string));
         const auto geometry_path = files::make_path_absolute(std::string(geometry_path_as_string));
-        auto vertex_source = files::read_file(vertex_path);
-        auto fragment_source = files::read_file(fragment_path);
-        auto geometry_source = files::read_file(geometry_path);
+        auto vertex_source = inject_defines(resolve_includes(files::read_file(vertex_path), vertex_path), defines);
+        auto fragment_source = inject_defines(resolve_includes(files::read_file(fragment_path), fragment_path), defines);
+        auto geometry_source = inject_defines(resolve_includes(files::read_file(geometry_path), geometry_path), defines);
         const std::string vertex_filename(vertex_path.filename().string());
         const std::string fragment_filename(fragment_path.filename().string());
         const std::string geometry_filename(geometry_path.filename().string());
@@ -35,4 +41,105 @@ namespace engine::shader{
                                         std::string_view(geometry_filename),
                                         std::string_view(fragment_filename));
     }
-}
\ No newline at end of file
+
+    std::shared_ptr<Shader> create_compute_shader_from(const std::string& compute_path_as_string,
+                                                       const ShaderDefines& defines) {
+        const auto compute_path = files::make_path_absolute(std::string(compute_path_as_string));
+        auto compute_source = inject_defines(resolve_includes(files::read_file(compute_path), compute_path), defines);
+        const std::string compute_filename(compute_path.filename().string());
+        return std::make_shared<Shader>(std::move(compute_source),
+                                        std::string_view(compute_filename));
+    }
+
+    std::string resolve_includes(std::string&& source, const std::filesystem::path& including_path) {
+        return impl_details::resolve_includes(std::move(source), including_path, 0);
+    }
+
+    std::string inject_defines(std::string&& source, const std::span<const ShaderDefine> defines) {
+        if (defines.empty()) {
+            return std::move(source);
+        }
+
+        //  #version has to stay the first directive, sources without one get the defines on top
+        auto insertion = std::size_t{0};
+        if (const auto version = source.find("#version"); version != std::string::npos) {
+            const auto line_end = source.find('\n', version);
+            insertion = line_end == std::string::npos ? source.size() : line_end + 1;
+        }
+        const auto next_line = std::count(std::begin(source),
+                                          std::begin(source) + static_cast<std::ptrdiff_t>(insertion), '\n') + 1;
+
+        std::string injected;
+        for (const auto& define : defines) {
+            injected += fmt::format("#define {} {}\n", define.name, define.value);
+        }
+        injected += fmt::format("#line {}\n", next_line);
+        if (insertion == source.size() && !source.empty() && source.back() != '\n') {
+            injected.insert(0, "\n");
+        }
+        source.insert(insertion, injected);
+        return std::move(source);
+    }
+
+    ShaderDefines defines_used_by(const std::string_view source, const std::span<const ShaderDefine> defines) {
+        ShaderDefines used;
+        std::copy_if(std::begin(defines), std::end(defines), std::back_inserter(used), [source](const auto& define) {
+            return source.find(define.name) != std::string_view::npos;
+        });
+        return used;
+    }
+
+    std::string permutation_key(const std::span<const ShaderDefine> defines) {
+        auto sorted = ShaderDefines(std::begin(defines), std::end(defines));
+        std::sort(std::begin(sorted), std::end(sorted), [](const auto& a, const auto& b) { return a.name < b.name; });
+        std::string key;
+        for (const auto& define : sorted) {
+            key += fmt::format("{}={};", define.name, define.value);
+        }
+        return key;
+    }
+}
+
+namespace engine::shader::impl_details {
+    std::string resolve_includes(std::string&& source, const std::filesystem::path& including_path,
+                                 const unsigned int depth) {
+        if (source.find("#include") == std::string::npos) {
+            return std::move(source);
+        }
+
+        std::string resolved;
+        resolved.reserve(source.size());
+        auto line_number = 1;
+        auto line_start = std::size_t{0};
+        while (line_start < source.size()) {
+            const auto line_end = std::min(source.find('\n', line_start), source.size());
+            const auto line = std::string_view(source).substr(line_start, line_end - line_start);
+            const auto directive = line.substr(std::min(line.find_first_not_of(" \t"), line.size()));
+            const auto name_start = directive.find('"');
+            const auto name_end = name_start == std::string_view::npos ? name_start
+                                                                       : directive.find('"', name_start + 1);
+            if (directive.starts_with("#include") && name_end != std::string_view::npos) {
+                const auto name = directive.substr(name_start + 1, name_end - name_start - 1);
+                const auto included_path = (including_path.parent_path() / name).lexically_normal();
+                if (depth >= max_include_depth) {
+                    fmt::print("[SHADER LOADING] Includes nested too deep at {}\n", included_path.string());
+                } else {
+                    auto included = resolve_includes(files::read_file(included_path), included_path, depth + 1);
+                    resolved += included;
+                    if (!included.empty() && included.back() != '\n') {
+                        resolved += '\n';
+                    }
+                }
+                resolved += fmt::format("#line {}\n", line_number + 1);
+            } else {
+                resolved += line;
+                if (line_end < source.size()) {
+                    resolved += '\n';
+                }
+            }
+            line_start = line_end + 1;
+            ++line_number;
+        }
+        return resolved;
+    }
+}
@@ -4,12 +4,42 @@
 #include "shader.h"
 #include "../../utility/file_reader.h"
 
+#include <span>
+
 namespace engine::shader{
+    struct ShaderDefine {
+        std::string name;
+        std::string value;
+    };
+    using ShaderDefines = std::vector<ShaderDefine>;
+
+    //  Every stage gets the defines, written right after its #version line; a #line directive behind them
+    //  keeps the compiler's line numbers those of the file
     std::shared_ptr<Shader> create_shader_from(const std::string& vertex_path_as_string,
-                                               const std::string& fragment_path_as_string);
+                                               const std::string& fragment_path_as_string,
+                                               const ShaderDefines& defines = {});
     std::shared_ptr<Shader> create_shader_from(const std::string& vertex_path_as_string,
                                                const std::string& fragment_path_as_string,
-                                               const std::string& geometry_path_as_string);
+                                               const std::string& geometry_path_as_string,
+                                               const ShaderDefines& defines = {});
+    std::shared_ptr<Shader> create_compute_shader_from(const std::string& compute_path_as_string,
+                                                       const ShaderDefines& defines = {});
+
+    //  Replaces every #include "file" line with the content of file, looked up next to including_path; a #line
+    //  directive behind each keeps the compiler's line numbers those of the including file
+    [[nodiscard]] std::string resolve_includes(std::string&& source, const std::filesystem::path& including_path);
+    [[nodiscard]] std::string inject_defines(std::string&& source, std::span<const ShaderDefine> defines);
+    //  The defines the source mentions, so that stages indifferent to a permutation are not compiled once per variant
+    [[nodiscard]] ShaderDefines defines_used_by(std::string_view source, std::span<const ShaderDefine> defines);
+    //  Identical for the same defines in any order
+    [[nodiscard]] std::string permutation_key(std::span<const ShaderDefine> defines);
+
+    namespace impl_details {
+        constexpr unsigned int max_include_depth = 8;
+
+        [[nodiscard]] std::string resolve_includes(std::string&& source, const std::filesystem::path& including_path,
+                                                   unsigned int depth);
+    }
 };
 
 
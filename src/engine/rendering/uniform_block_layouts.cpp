@@ -0,0 +1,33 @@
+#include "uniform_block_layouts.h"
+
+namespace engine {
+    bool verify_block_layout(const Shader& shader, const std::string_view block_name,
+                             const std::span<const UniformBlockMember> members, const std::size_t block_size) {
+        const auto block = shader.find_uniform_block(block_name);
+        if (block == nullptr) {
+            return true;
+        }
+
+        auto matches = true;
+        if (static_cast<std::size_t>(block->data_size) > block_size) {
+            fmt::print("[UNIFORM BLOCK] {} takes {} bytes in program {}, its C++ layout only {}\n",
+                       block_name, block->data_size, shader.id, block_size);
+            matches = false;
+        }
+        for (const auto& member : members) {
+            //  Members of blocks with an instance name are reflected as "Block.member", arrays as "member[0]"
+            const auto qualified_name = fmt::format("{}.{}", block_name, member.name);
+            auto uniform = shader.find_uniform(member.name);
+            uniform = uniform != nullptr ? uniform : shader.find_uniform(qualified_name);
+            if (uniform == nullptr || uniform->block_index != static_cast<int>(block->index)) {
+                continue;
+            }
+            if (uniform->block_offset != member.offset) {
+                fmt::print("[UNIFORM BLOCK] {}.{} is at offset {} in program {}, at {} in its C++ layout\n",
+                           block_name, member.name, uniform->block_offset, shader.id, member.offset);
+                matches = false;
+            }
+        }
+        return matches;
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef UNIFORM_BLOCK_LAYOUTS_H
+#define UNIFORM_BLOCK_LAYOUTS_H
+
+#include "shader.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace engine {
+    //  C++ mirrors of the std140 blocks in resources/shaders/deferred; every block is written with a single copy.
+    //  Offsets are checked here at compile time and against the linked programs by verify_block_layout.
+
+    struct GBufferMatricesBlock {
+        glm::mat4 projection_view;
+        glm::mat4 model;
+        glm::mat4 transposed_inversed_model;
+    };
+
+    struct MaterialPropertiesBlock {
+        glm::vec4 diffuse_color;
+        float shininess;
+        float padding[3];
+    };
+
+    struct LightBlock {
+        glm::vec4 position;
+        glm::vec4 direction;
+        float constant_attenuation;
+        float linear_attenuation;
+        float quadratic_attenuation;
+        float intensity;
+        glm::vec4 color;
+        glm::mat4 world_to_profile;
+        int ies_profile_layer;
+        int padding[3];
+    };
+
+    struct CommonDataBlock {
+        glm::vec4 camera_position;
+        float light_camera_far_plane;
+        float shadow_threshold;
+        float distance_to_furthest_ies_vertex;
+        float padding;
+    };
+
+    struct IESHarmonicsBlock {
+        std::array<glm::vec4, 7> sh_coefficients;
+        int sh_order;
+        int padding[3];
+    };
+
+    static_assert(offsetof(GBufferMatricesBlock, model) == 64);
+    static_assert(offsetof(GBufferMatricesBlock, transposed_inversed_model) == 128);
+    static_assert(sizeof(GBufferMatricesBlock) == 192);
+
+    static_assert(offsetof(MaterialPropertiesBlock, shininess) == 16);
+    static_assert(sizeof(MaterialPropertiesBlock) == 32);
+
+    static_assert(offsetof(LightBlock, direction) == 16);
+    static_assert(offsetof(LightBlock, constant_attenuation) == 32);
+    static_assert(offsetof(LightBlock, linear_attenuation) == 36);
+    static_assert(offsetof(LightBlock, quadratic_attenuation) == 40);
+    static_assert(offsetof(LightBlock, intensity) == 44);
+    static_assert(offsetof(LightBlock, color) == 48);
+    static_assert(offsetof(LightBlock, world_to_profile) == 64);
+    static_assert(offsetof(LightBlock, ies_profile_layer) == 128);
+    static_assert(sizeof(LightBlock) == 144);
+
+    static_assert(offsetof(CommonDataBlock, light_camera_far_plane) == 16);
+    static_assert(offsetof(CommonDataBlock, shadow_threshold) == 20);
+    static_assert(offsetof(CommonDataBlock, distance_to_furthest_ies_vertex) == 24);
+    static_assert(sizeof(CommonDataBlock) == 32);
+
+    static_assert(offsetof(IESHarmonicsBlock, sh_order) == 112);
+    static_assert(sizeof(IESHarmonicsBlock) == 128);
+
+    struct UniformBlockMember {
+        std::string_view name;
+        int offset;
+    };
+
+    template <typename Block>
+    struct UniformBlockLayout;
+
+    template <>
+    struct UniformBlockLayout<GBufferMatricesBlock> {
+        static constexpr std::string_view name = "GBufferMatrices";
+        static constexpr std::array<UniformBlockMember, 3> members{{
+                {"projection_view", offsetof(GBufferMatricesBlock, projection_view)},
+                {"model", offsetof(GBufferMatricesBlock, model)},
+                {"transposed_inversed_model", offsetof(GBufferMatricesBlock, transposed_inversed_model)}
+        }};
+    };
+
+    template <>
+    struct UniformBlockLayout<MaterialPropertiesBlock> {
+        static constexpr std::string_view name = "MaterialProperties";
+        static constexpr std::array<UniformBlockMember, 2> members{{
+                {"diffuse_color", offsetof(MaterialPropertiesBlock, diffuse_color)},
+                {"shininess", offsetof(MaterialPropertiesBlock, shininess)}
+        }};
+    };
+
+    template <>
+    struct UniformBlockLayout<LightBlock> {
+        static constexpr std::string_view name = "Light";
+        static constexpr std::array<UniformBlockMember, 9> members{{
+                {"position", offsetof(LightBlock, position)},
+                {"direction", offsetof(LightBlock, direction)},
+                {"constant_attenuation", offsetof(LightBlock, constant_attenuation)},
+                {"linear_attenuation", offsetof(LightBlock, linear_attenuation)},
+                {"quadratic_attenuation", offsetof(LightBlock, quadratic_attenuation)},
+                {"intensity", offsetof(LightBlock, intensity)},
+                {"color", offsetof(LightBlock, color)},
+                {"world_to_profile", offsetof(LightBlock, world_to_profile)},
+                {"ies_profile_layer", offsetof(LightBlock, ies_profile_layer)}
+        }};
+    };
+
+    template <>
+    struct UniformBlockLayout<CommonDataBlock> {
+        static constexpr std::string_view name = "CommonData";
+        static constexpr std::array<UniformBlockMember, 4> members{{
+                {"camera_position", offsetof(CommonDataBlock, camera_position)},
+                {"light_camera_far_plane", offsetof(CommonDataBlock, light_camera_far_plane)},
+                {"shadow_threshold", offsetof(CommonDataBlock, shadow_threshold)},
+                {"distance_to_furthest_ies_vertex", offsetof(CommonDataBlock, distance_to_furthest_ies_vertex)}
+        }};
+    };
+
+    template <>
+    struct UniformBlockLayout<IESHarmonicsBlock> {
+        static constexpr std::string_view name = "IESHarmonics";
+        static constexpr std::array<UniformBlockMember, 2> members{{
+                {"sh_coefficients", offsetof(IESHarmonicsBlock, sh_coefficients)},
+                {"sh_order", offsetof(IESHarmonicsBlock, sh_order)}
+        }};
+    };
+
+    //  Members the program optimized away are not checked; blocks the program does not use pass trivially
+    bool verify_block_layout(const Shader& shader, std::string_view block_name,
+                             std::span<const UniformBlockMember> members, std::size_t block_size);
+
+    template <typename Block>
+    bool verify_block_layout(const Shader& shader) {
+        using Layout = UniformBlockLayout<Block>;
+        return verify_block_layout(shader, Layout::name, Layout::members, sizeof(Block));
+    }
+}
+
+#endif //UNIFORM_BLOCK_LAYOUTS_H
@@ -1,5 +1,9 @@
 #include "uniform_buffer.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
 namespace engine {
     UniformBuffer::UniformBuffer(const int buffer_size, const void* buffer_initial_data, const GLint usage_pattern = GL_STATIC_DRAW) : id(0){
         glGenBuffers(1, &id);
@@ -15,12 +19,51 @@ namespace engine {
         size = buffer_size;
     }
 
+    UniformBuffer::UniformBuffer(const int frame_capacity, const unsigned int frames_in_flight,
+                                 const UniformBufferMode requested_mode) : id(0), buffer_mode(requested_mode) {
+        offset_alignment = offset_alignment_requirement();
+        regions = buffer_mode == UniformBufferMode::Persistent_Ring
+                  ? std::clamp(frames_in_flight, 1u, max_frames_in_flight) : 1u;
+        //  Every region starts on an aligned offset, so that the ranges handed out by allocate() are aligned too
+        region_size = aligned_to_offset_requirement(frame_capacity);
+        size = static_cast<unsigned int>(region_size) * regions;
+
+        glGenBuffers(1, &id);
+        glBindBuffer(GL_UNIFORM_BUFFER, id);
+        if (buffer_mode == UniformBufferMode::Persistent_Ring && GLAD_GL_VERSION_4_4) {
+            constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_UNIFORM_BUFFER, size, nullptr, flags);
+            mapped_storage = static_cast<std::byte*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags));
+        } else {
+            glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        }
+        if (buffer_mode == UniformBufferMode::Persistent_Ring && mapped_storage == nullptr) {
+            client_storage.resize(size);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
     UniformBuffer::~UniformBuffer() {
+        for (auto& fence : region_fences) {
+            if (fence != nullptr) {
+                glDeleteSync(fence);
+            }
+        }
+        if (mapped_storage != nullptr) {
+            glBindBuffer(GL_UNIFORM_BUFFER, id);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        }
+        OpenGL3_State_Cache::forget_buffer(id);
         glDeleteBuffers(1, &id);
     }
 
     void UniformBuffer::bind_to_binding_point(const unsigned int binding_point) {
-        glBindBufferBase(GL_UNIFORM_BUFFER, binding_point, id);
+        OpenGL3_State_Cache::bind_buffer_base(GL_UNIFORM_BUFFER, binding_point, id);
+    }
+
+    void UniformBuffer::bind_range_to_binding_point(const unsigned int binding_point, const int starting_offset,
+                                                    const int range_size) {
+        OpenGL3_State_Cache::bind_buffer_range(GL_UNIFORM_BUFFER, binding_point, id, starting_offset, range_size);
     }
 
     void UniformBuffer::bind_to_uniform_buffer_target() {
@@ -33,6 +76,72 @@ namespace engine {
 
     void UniformBuffer::copy_to_buffer(const int starting_offset, const int copy_size,
                                        const void* data_source) {
-        glBufferSubData(GL_UNIFORM_BUFFER, starting_offset, copy_size, data_source);
+        if (buffer_mode == UniformBufferMode::Immediate) {
+            glBufferSubData(GL_UNIFORM_BUFFER, starting_offset, copy_size, data_source);
+            return;
+        }
+        auto* storage = mapped_storage != nullptr ? mapped_storage : client_storage.data();
+        std::memcpy(storage + starting_offset, data_source, copy_size);
+    }
+
+    void UniformBuffer::begin_frame() {
+        current_region = (current_region + 1) % regions;
+        //  The GPU may still be reading this region from frames_in_flight frames ago
+        if (auto& fence = region_fences[current_region]; fence != nullptr) {
+            constexpr GLuint64 one_second = 1'000'000'000;
+            if (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, one_second) == GL_TIMEOUT_EXPIRED) {
+                fmt::print("[UNIFORM BUFFER] Timed out waiting for region {} to be released\n", current_region);
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+        write_cursor = region_size * static_cast<int>(current_region);
+        committed_cursor = write_cursor;
+    }
+
+    int UniformBuffer::allocate(const int allocation_size) {
+        const auto region_start = region_size * static_cast<int>(current_region);
+        const auto aligned_size = (allocation_size + offset_alignment - 1) / offset_alignment * offset_alignment;
+        //  Earlier ranges of this frame may still be referenced by queued draws, so nothing is ever reused
+        //  within a frame; the region has to be sized for the whole frame's demand
+        if (write_cursor + aligned_size > region_start + region_size) {
+            assert(false && "uniform buffer frame region exhausted");
+            return -1;
+        }
+        const auto offset = write_cursor;
+        write_cursor += aligned_size;
+        return offset;
+    }
+
+    void UniformBuffer::commit_writes() {
+        //  Coherent persistent mappings are visible to the GPU without further calls
+        if (mapped_storage == nullptr && write_cursor > committed_cursor) {
+            glBindBuffer(GL_UNIFORM_BUFFER, id);
+            glBufferSubData(GL_UNIFORM_BUFFER, committed_cursor, write_cursor - committed_cursor,
+                            client_storage.data() + committed_cursor);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
+        committed_cursor = write_cursor;
+    }
+
+    void UniformBuffer::end_frame() {
+        if (mapped_storage != nullptr) {
+            region_fences[current_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    UniformBufferMode UniformBuffer::mode() const {
+        return buffer_mode;
+    }
+
+    int UniformBuffer::offset_alignment_requirement() {
+        auto alignment = 1;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return std::max(alignment, 1);
+    }
+
+    int UniformBuffer::aligned_to_offset_requirement(const int byte_size) {
+        const auto alignment = offset_alignment_requirement();
+        return (byte_size + alignment - 1) / alignment * alignment;
     }
 }
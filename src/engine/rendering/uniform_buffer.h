@@ -3,11 +3,23 @@
 
 #include "vertex_buffer.h"
 
+#include <array>
+
 namespace engine{
+    enum class UniformBufferMode {
+        Immediate,          //  glBufferSubData on every copy, the buffer has to be bound to GL_UNIFORM_BUFFER
+        Persistent_Ring     //  Per-frame regions written through a persistent mapping and bound by range
+    };
+
     class UniformBuffer{
     public:
+        static constexpr unsigned int max_frames_in_flight = 4;
+
         explicit UniformBuffer(int buffer_size, const void* buffer_initial_data, GLint usage_pattern);
         explicit UniformBuffer(int buffer_size, GLint usage_pattern);
+        //  frames_in_flight regions of frame_capacity bytes each; without GL 4.4 the ring is kept in client
+        //  memory and each frame's writes are uploaded at once by commit_writes()
+        UniformBuffer(int frame_capacity, unsigned int frames_in_flight, UniformBufferMode requested_mode);
         UniformBuffer(const UniformBuffer& other) = delete;
         UniformBuffer(UniformBuffer&& other) = delete;
         UniformBuffer& operator=(const UniformBuffer& other) = delete;
@@ -15,15 +27,39 @@ namespace engine{
         ~UniformBuffer();
 
         void bind_to_binding_point(unsigned int binding_point);
+        void bind_range_to_binding_point(unsigned int binding_point, int starting_offset, int range_size);
         void bind_to_uniform_buffer_target();
         void unbind_from_uniform_buffer_target();
 
+        //  In ring mode starting_offset is the one returned by allocate()
         void copy_to_buffer(int starting_offset, int copy_size, const void* data_source);
 
+        //  Ring mode only; allocate() returns -1 once the current frame region is exhausted
+        void begin_frame();
+        [[nodiscard]] int allocate(int allocation_size);
+        void commit_writes();
+        void end_frame();
+
+        [[nodiscard]] UniformBufferMode mode() const;
+
+        [[nodiscard]] static int offset_alignment_requirement();
+        [[nodiscard]] static int aligned_to_offset_requirement(int byte_size);
+
 
     private:
         unsigned int id;
         unsigned int size;
+
+        UniformBufferMode buffer_mode = UniformBufferMode::Immediate;
+        int region_size = 0;
+        int offset_alignment = 1;
+        unsigned int regions = 1;
+        unsigned int current_region = 0;
+        int write_cursor = 0;
+        int committed_cursor = 0;
+        std::byte* mapped_storage = nullptr;
+        std::vector<std::byte> client_storage;
+        std::array<GLsync, max_frames_in_flight> region_fences{};
     };
 }
 
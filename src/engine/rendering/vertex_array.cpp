@@ -7,19 +7,20 @@ namespace engine{
     }
 
     VertexArray::~VertexArray() {
+        OpenGL3_State_Cache::forget_vertex_array(id);
         glDeleteVertexArrays(1, &id);
     }
 
     void VertexArray::bind() const {
-        glBindVertexArray(id);
+        OpenGL3_State_Cache::bind_vertex_array(id);
     }
 
     void VertexArray::unbind() const {
-        glBindVertexArray(0);
+        OpenGL3_State_Cache::bind_vertex_array(0);
     }
 
     void VertexArray::set_vbo(std::shared_ptr<VertexBuffer>&& vertex_buffer_object) {
-        glBindVertexArray(id);
+        OpenGL3_State_Cache::bind_vertex_array(id);
         vbo_index = 0;
         vbo = std::move(vertex_buffer_object);
         vbo->bind();
@@ -55,7 +56,7 @@ namespace engine{
     }
 
     void VertexArray::set_ebo(std::shared_ptr<ElementBuffer>&& element_buffer_object) {
-        glBindVertexArray(id);
+        OpenGL3_State_Cache::bind_vertex_array(id);
         element_buffer_object->bind();
         ebo = std::move(element_buffer_object);
     }
@@ -68,6 +69,10 @@ namespace engine{
         return ebo;
     }
 
+    unsigned int VertexArray::get_id() const {
+        return id;
+    }
+
     void VertexArray::load_layout_element(const VertexBufferElement& element, const unsigned int layout_stride,
                                           const unsigned int bonus_offset) const {
         glEnableVertexAttribArray(vbo_index);
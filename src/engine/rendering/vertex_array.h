@@ -28,6 +28,7 @@ namespace engine{
 
         [[nodiscard]] const std::shared_ptr<VertexBuffer>& get_vbo() const;
         [[nodiscard]] const std::shared_ptr<ElementBuffer>& get_ebo() const;
+        [[nodiscard]] unsigned int get_id() const;
     private:
         unsigned int id;
         unsigned int vbo_index;
@@ -155,6 +155,7 @@ namespace engine {
     : VertexBuffer(data.size() * sizeof(T), data.data()) {};
 
     VertexBuffer::~VertexBuffer() {
+        OpenGL3_State_Cache::forget_buffer(id);
         glDeleteBuffers(1, &id);
     }
 
@@ -166,6 +167,10 @@ namespace engine {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    void VertexBuffer::bind_to_storage_binding_point(const unsigned int binding_point) const {
+        OpenGL3_State_Cache::bind_buffer_base(GL_SHADER_STORAGE_BUFFER, binding_point, id);
+    }
+
     const VertexBufferLayout& VertexBuffer::get_buffer_layout() const {
         return layout;
     }
@@ -181,4 +186,38 @@ namespace engine {
         glBindBuffer(GL_ARRAY_BUFFER, id);
         glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
     }
+
+    void VertexBuffer::set_sub_data(const unsigned int offset, const unsigned int size, const void* data) const {
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+
+    void* VertexBuffer::map_for_writing(const unsigned int offset, const unsigned int size) const {
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        return glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    }
+
+    bool VertexBuffer::unmap() const {
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    }
+
+    unsigned int VertexBuffer::size_in_bytes() const {
+        auto buffer_size = 0;
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &buffer_size);
+        return static_cast<unsigned int>(buffer_size);
+    }
+
+    unsigned int VertexBuffer::get_id() const {
+        return id;
+    }
+
+    void VertexBuffer::copy_to(const VertexBuffer& destination, const unsigned int destination_offset) const {
+        glBindBuffer(GL_COPY_READ_BUFFER, id);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, destination.id);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, destination_offset, size_in_bytes());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef VERTEX_BUFFER_H
 #define VERTEX_BUFFER_H
 
+#include "opengl3_state_cache.h"
+
 #include <fmt/core.h>
 #include <fmt/color.h>
 #include <glad/glad.h>
@@ -80,11 +82,23 @@ namespace engine {
 
         void bind() const;
         void unbind() const;
+        void bind_to_storage_binding_point(unsigned int binding_point) const;
 
         [[nodiscard]] const VertexBufferLayout& get_buffer_layout() const;
         void set_buffer_layout(const VertexBufferLayout& l);
 
         void set_data(const unsigned int size, const void* data) const;
+        void set_sub_data(const unsigned int offset, const unsigned int size, const void* data) const;
+
+        //  The returned pointer stays valid until unmap(); the previous content of the range is discarded
+        [[nodiscard]] void* map_for_writing(const unsigned int offset, const unsigned int size) const;
+        //  False when the store got corrupted while mapped, the written range then has to be uploaded again
+        [[nodiscard]] bool unmap() const;
+
+        [[nodiscard]] unsigned int size_in_bytes() const;
+        [[nodiscard]] unsigned int get_id() const;
+        //  GPU-side copy of the whole buffer into destination, starting at destination_offset bytes
+        void copy_to(const VertexBuffer& destination, unsigned int destination_offset) const;
 
     private:
         unsigned int      id;
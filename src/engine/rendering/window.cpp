@@ -1,9 +1,24 @@
 #include "window.h"
 
 #include "glfw_window_impl.h"
+#ifdef ENGINE_HEADLESS_EGL
+#include "egl_headless_window.h"
+#endif
 
 namespace engine {
     std::unique_ptr<Window> Window::create(const WindowProperties& w) {
+        if (w.headless) {
+#ifdef ENGINE_HEADLESS_EGL
+            auto headless_window = std::make_unique<EGL_Headless_Window>(w);
+            if (!headless_window->is_open()) {
+                return nullptr;
+            }
+            return headless_window;
+#else
+            fmt::print("[WINDOW] Headless windows need EGL, which this build was configured without\n");
+            return nullptr;
+#endif
+        }
         return std::make_unique<GLFW_Window_Impl>(w);
     }
 }
\ No newline at end of file
@@ -8,11 +8,15 @@
 #include "../events/event.h"
 
 namespace engine {
+    class RenderingContext;
 
     struct WindowProperties {
         std::string title;
         unsigned width;
         unsigned height;
+        bool vsync = true;          //  Frames are not capped otherwise
+        //  Rendered into a framebuffer object, with no display server; never capped, and no input events
+        bool headless = false;
 
         explicit WindowProperties(std::string_view w_title = "MainWindow",
                                   unsigned w_width = 800u,
@@ -34,8 +38,15 @@ namespace engine {
 
         [[nodiscard]] virtual void *get_native_window() const = 0;
 
+        //  In seconds, from a start fixed when the window is created
+        [[nodiscard]] virtual double get_time() const = 0;
+
         virtual void link_to_event_queue(const EventQueueAccess& push_function) = 0;
 
+        //  nullptr when the platform cannot share its context
+        [[nodiscard]] virtual std::unique_ptr<RenderingContext> create_shared_context() const = 0;
+
+        //  nullptr for a headless window in builds without EGL, or where EGL cannot create a context
         static std::unique_ptr<Window> create(const WindowProperties& w);
     };
 }
@@ -0,0 +1,132 @@
+#include "bounding_volumes.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace engine {
+    bool AABB::is_empty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    glm::vec3 AABB::center() const {
+        return (min + max) * 0.5f;
+    }
+
+    glm::vec3 AABB::half_extents() const {
+        return (max - min) * 0.5f;
+    }
+
+    float AABB::surface_area() const {
+        if (is_empty()) {
+            return 0.0f;
+        }
+        const auto size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    void AABB::expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void AABB::expand(const AABB& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    AABB AABB::transformed(const glm::mat4& transform) const {
+        if (is_empty()) {
+            return *this;
+        }
+        //  Arvo's method: the new extents are the old ones through the absolute value of the linear part
+        const auto linear = glm::mat3(transform);
+        auto absolute = linear;
+        for (auto column = 0; column < 3; ++column) {
+            absolute[column] = glm::abs(linear[column]);
+        }
+        const auto new_center = glm::vec3(transform * glm::vec4(center(), 1.0f));
+        const auto new_half_extents = absolute * half_extents();
+        return AABB{new_center - new_half_extents, new_center + new_half_extents};
+    }
+
+    Frustum::Frustum(const glm::mat4& view_projection) {
+        //  Gribb-Hartmann: rows of the matrix, combined with the w row
+        const auto row = [&view_projection](const int i) {
+            return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+        };
+        frustum_planes = {row(3) + row(0), row(3) - row(0),
+                          row(3) + row(1), row(3) - row(1),
+                          row(3) + row(2), row(3) - row(2)};
+        for (auto& plane : frustum_planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        constexpr auto always_inside = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        for (auto lane = 0; lane < 4; ++lane) {
+            const auto& plane = frustum_planes[lane];
+            const auto& second_plane = lane < 2 ? frustum_planes[4 + lane] : always_inside;
+            for (auto component = 0; component < 4; ++component) {
+                planes_0123[component][lane] = plane[component];
+                planes_45[component][lane] = second_plane[component];
+            }
+        }
+    }
+
+    const std::array<glm::vec4, 6>& Frustum::planes() const {
+        return frustum_planes;
+    }
+
+    Containment Frustum::classify(const AABB& box) const {
+        if (box.is_empty()) {
+            return Containment::Outside;
+        }
+        const auto c = box.center();
+        const auto e = box.half_extents();
+#ifdef ENGINE_FRUSTUM_SSE
+        const auto cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        const auto ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+        const auto sign_mask = _mm_set1_ps(-0.0f);
+        const auto zero = _mm_setzero_ps();
+
+        auto outside = 0;
+        auto intersecting = 0;
+        for (const auto planes : {&planes_0123, &planes_45}) {
+            const auto nx = _mm_load_ps((*planes)[0].data());
+            const auto ny = _mm_load_ps((*planes)[1].data());
+            const auto nz = _mm_load_ps((*planes)[2].data());
+            const auto w = _mm_load_ps((*planes)[3].data());
+            //  Signed distance of the center, and projected radius of the box on each normal
+            const auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                             _mm_add_ps(_mm_mul_ps(nz, cz), w));
+            const auto radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, nx), ex),
+                                                      _mm_mul_ps(_mm_andnot_ps(sign_mask, ny), ey)),
+                                           _mm_mul_ps(_mm_andnot_ps(sign_mask, nz), ez));
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+            intersecting |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+        }
+        if (outside != 0) {
+            return Containment::Outside;
+        }
+        return intersecting != 0 ? Containment::Intersecting : Containment::Inside;
+#else
+        auto result = Containment::Inside;
+        for (const auto& plane : frustum_planes) {
+            const auto normal = glm::vec3(plane);
+            const auto distance = glm::dot(normal, c) + plane.w;
+            const auto radius = glm::dot(glm::abs(normal), e);
+            if (distance + radius < 0.0f) {
+                return Containment::Outside;
+            }
+            if (distance - radius < 0.0f) {
+                result = Containment::Intersecting;
+            }
+        }
+        return result;
+#endif
+    }
+}
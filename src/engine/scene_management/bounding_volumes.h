@@ -0,0 +1,47 @@
+#ifndef BOUNDING_VOLUMES_H
+#define BOUNDING_VOLUMES_H
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <limits>
+
+namespace engine {
+    struct AABB {
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+        [[nodiscard]] bool is_empty() const;
+        [[nodiscard]] glm::vec3 center() const;
+        [[nodiscard]] glm::vec3 half_extents() const;
+        [[nodiscard]] float surface_area() const;
+
+        void expand(const glm::vec3& point);
+        void expand(const AABB& other);
+        //  Bounds of the transformed box, not of the transformed contents: can be looser than needed
+        [[nodiscard]] AABB transformed(const glm::mat4& transform) const;
+    };
+
+    enum class Containment {
+        Outside, Intersecting, Inside
+    };
+
+    //  Planes point inwards and are normalized; a point p is inside when dot(plane.xyz, p) + plane.w >= 0
+    //  for all of them. Planes are also kept transposed, four at a time, for the SIMD box test.
+    class Frustum {
+    public:
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& view_projection);
+
+        [[nodiscard]] const std::array<glm::vec4, 6>& planes() const;
+        [[nodiscard]] Containment classify(const AABB& box) const;
+
+    private:
+        std::array<glm::vec4, 6> frustum_planes{};
+        //  x, y, z and w of planes 0-3 and 4-5; the two unused lanes hold a plane every box is inside of
+        alignas(16) std::array<std::array<float, 4>, 4> planes_0123{};
+        alignas(16) std::array<std::array<float, 4>, 4> planes_45{};
+    };
+}
+
+#endif //BOUNDING_VOLUMES_H
@@ -0,0 +1,135 @@
+#include "draw_submission_benchmark.h"
+
+#include "../rendering/uniform_block_layouts.h"
+#include "../rendering/uniform_buffer.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cmath>
+
+namespace engine {
+    std::vector<SceneObject> make_benchmark_objects(const std::size_t object_count) {
+        //  Positions and normals of the 24 vertices of a cube, 4 per face
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        for (auto axis = 0; axis < 3; ++axis) {
+            for (const auto side : {-1.0f, 1.0f}) {
+                auto normal = glm::vec3(0.0f);
+                normal[axis] = side;
+                const auto u = glm::vec3(normal.y, normal.z, normal.x);
+                const auto v = glm::cross(normal, u);
+                const auto first_vertex = static_cast<unsigned int>(vertices.size() / 6);
+                for (const auto& corner : {-u - v, u - v, u + v, -u + v}) {
+                    const auto p = (normal + corner) * 0.5f;
+                    vertices.insert(std::end(vertices), {p.x, p.y, p.z, normal.x, normal.y, normal.z});
+                }
+                indices.insert(std::end(indices), {first_vertex, first_vertex + 1, first_vertex + 2,
+                                                   first_vertex + 2, first_vertex + 3, first_vertex});
+            }
+        }
+
+        const auto grid_side = static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(object_count))));
+        const auto cube_size = 3.0f / static_cast<float>(grid_side);
+        std::vector<SceneObject> objects(object_count);
+        for (auto i = 0u; i < object_count; ++i) {
+            auto& o = objects[i];
+            auto vbo = std::make_shared<VertexBuffer>(vertices.size() * sizeof(float), vertices.data());
+            vbo->set_buffer_layout(VertexBufferLayout({
+                                                              VertexBufferElement(ShaderDataType::Float3,
+                                                                                  "position"),
+                                                              VertexBufferElement(ShaderDataType::Float3,
+                                                                                  "normal")}));
+            o.vao->set_vbo(std::move(vbo));
+            o.vao->set_ebo(std::make_shared<ElementBuffer>(indices));
+            const auto cell = glm::vec3(i % grid_side, (i / grid_side) % grid_side, i / (grid_side * grid_side));
+            o.transform = glm::scale(glm::translate(glm::mat4(1.0f), cell * cube_size),
+                                     glm::vec3(cube_size * 0.5f));
+            o.transpose_inverse_transform = glm::transpose(glm::inverse(o.transform));
+            o.material.data.diffuse_color = glm::vec4(cell / static_cast<float>(grid_side), 1.0f);
+        }
+        return objects;
+    }
+
+    DrawSubmissionTimings benchmark_draw_submission(const Shader& per_object_shader, const Shader& indirect_shader,
+                                                    const glm::mat4& projection_view,
+                                                    const std::size_t object_count, const int repetitions) {
+        using milliseconds = std::chrono::duration<double, std::milli>;
+
+        const auto objects = make_benchmark_objects(object_count);
+        const auto batch = SceneDrawBatch(objects);
+
+        constexpr auto transformations_size = static_cast<int>(sizeof(GBufferMatricesBlock));
+        constexpr auto material_size = static_cast<int>(sizeof(MaterialPropertiesBlock));
+        const auto record_size = UniformBuffer::aligned_to_offset_requirement(transformations_size) +
+                                 UniformBuffer::aligned_to_offset_requirement(material_size);
+        auto arena = UniformBuffer(record_size * static_cast<int>(object_count), 2, UniformBufferMode::Persistent_Ring);
+        auto camera_block = UniformBuffer(transformations_size, GL_DYNAMIC_DRAW);
+        camera_block.bind_to_uniform_buffer_target();
+        const auto camera_matrices = GBufferMatricesBlock{projection_view, glm::mat4(1.0f), glm::mat4(1.0f)};
+        camera_block.copy_to_buffer(0, transformations_size, &camera_matrices);
+        camera_block.unbind_from_uniform_buffer_target();
+
+        unsigned int query = 0;
+        glGenQueries(1, &query);
+        const auto gpu_milliseconds = [query]() {
+            GLuint64 elapsed_nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_nanoseconds);
+            return static_cast<double>(elapsed_nanoseconds) / 1.0e6;
+        };
+
+        std::vector<std::pair<int, int>> ranges;
+        ranges.reserve(object_count);
+        DrawSubmissionTimings timings{object_count, repetitions};
+        for (auto r = 0; r < repetitions; ++r) {
+            glFinish();
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            auto start = std::chrono::steady_clock::now();
+            per_object_shader.use();
+            arena.begin_frame();
+            ranges.clear();
+            for (const auto& o : objects) {
+                const auto transformations = arena.allocate(transformations_size);
+                const auto material = arena.allocate(material_size);
+                ranges.emplace_back(transformations, material);
+                const auto matrices = GBufferMatricesBlock{projection_view, o.transform, o.transpose_inverse_transform};
+                const auto material_properties = MaterialPropertiesBlock{o.material.data.diffuse_color,
+                                                                         o.material.data.shininess, {}};
+                arena.copy_to_buffer(transformations, transformations_size, &matrices);
+                arena.copy_to_buffer(material, material_size, &material_properties);
+            }
+            arena.commit_writes();
+            for (auto i = 0u; i < objects.size(); ++i) {
+                arena.bind_range_to_binding_point(0, ranges[i].first, transformations_size);
+                arena.bind_range_to_binding_point(1, ranges[i].second, material_size);
+                OpenGL3_Renderer::draw(*(objects[i].vao));
+            }
+            arena.end_frame();
+            timings.per_object_cpu_ms += milliseconds(std::chrono::steady_clock::now() - start).count();
+            glEndQuery(GL_TIME_ELAPSED);
+            timings.per_object_gpu_ms += gpu_milliseconds();
+
+            glFinish();
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            start = std::chrono::steady_clock::now();
+            indirect_shader.use();
+            camera_block.bind_to_binding_point(0);
+            batch.draw();
+            timings.indirect_cpu_ms += milliseconds(std::chrono::steady_clock::now() - start).count();
+            glEndQuery(GL_TIME_ELAPSED);
+            timings.indirect_gpu_ms += gpu_milliseconds();
+        }
+        glDeleteQueries(1, &query);
+
+        const auto runs = static_cast<double>(std::max(repetitions, 1));
+        timings.per_object_cpu_ms /= runs;
+        timings.per_object_gpu_ms /= runs;
+        timings.indirect_cpu_ms /= runs;
+        timings.indirect_gpu_ms /= runs;
+        fmt::print("[DRAW BENCHMARK] {} objects: per-object draws {:.3f} ms CPU / {:.3f} ms GPU, "
+                   "multi-draw-indirect {:.3f} ms CPU / {:.3f} ms GPU\n",
+                   object_count, timings.per_object_cpu_ms, timings.per_object_gpu_ms,
+                   timings.indirect_cpu_ms, timings.indirect_gpu_ms);
+        return timings;
+    }
+}
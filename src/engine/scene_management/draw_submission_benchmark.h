@@ -0,0 +1,34 @@
+#ifndef DRAW_SUBMISSION_BENCHMARK_H
+#define DRAW_SUBMISSION_BENCHMARK_H
+
+#include "scene_draw_batch.h"
+
+#include "../rendering/shader.h"
+
+#include <glm/glm.hpp>
+
+namespace engine {
+    //  Averages over the repetitions, in milliseconds
+    struct DrawSubmissionTimings {
+        std::size_t objects = 0;
+        int repetitions = 0;
+        double per_object_cpu_ms = 0.0;
+        double per_object_gpu_ms = 0.0;
+        double indirect_cpu_ms = 0.0;
+        double indirect_gpu_ms = 0.0;
+    };
+
+    //  A grid of small cubes, each with its own buffers and VAO as scenes::upload_mesh creates them without a pool
+    [[nodiscard]] std::vector<SceneObject> make_benchmark_objects(std::size_t object_count);
+
+    //  Submits the same objects with one draw per object (per-object uniform ranges, as the deferred passes do)
+    //  and with a single multi-draw-indirect, into the currently bound framebuffer.
+    //  Uniform binding points 0 and 1 are left pointing to the benchmark's own buffers.
+    [[nodiscard]] DrawSubmissionTimings benchmark_draw_submission(const Shader& per_object_shader,
+                                                                  const Shader& indirect_shader,
+                                                                  const glm::mat4& projection_view,
+                                                                  std::size_t object_count = 10000,
+                                                                  int repetitions = 8);
+}
+
+#endif //DRAW_SUBMISSION_BENCHMARK_H
@@ -0,0 +1,296 @@
+#include "mesh_simplification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+namespace engine {
+    using namespace impl_details;
+
+    SimplifiedMesh simplify_mesh(const std::span<const float> vertices, const std::span<const unsigned int> indices,
+                                 const unsigned int target_triangles) {
+        //  Moving a border vertex off its border plane costs as much as moving an interior vertex 10 times as far
+        constexpr auto border_weight = 100.0;
+
+        const auto welded = weld_by_position(vertices);
+        const auto& positions = welded.positions;
+        const auto nodes_count = positions.size();
+
+        std::vector<std::array<unsigned int, 3>> triangles;
+        triangles.reserve(indices.size() / 3);
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const auto a = welded.node_of_vertex[indices[i]];
+            const auto b = welded.node_of_vertex[indices[i + 1]];
+            const auto c = welded.node_of_vertex[indices[i + 2]];
+            if (a != b && b != c && c != a) {
+                triangles.push_back({a, b, c});
+            }
+        }
+
+        const auto face_normal = [&positions](const std::array<unsigned int, 3>& corners) {
+            const auto origin = glm::dvec3(positions[corners[0]]);
+            return glm::cross(glm::dvec3(positions[corners[1]]) - origin, glm::dvec3(positions[corners[2]]) - origin);
+        };
+
+        std::vector<Quadric> quadrics(nodes_count);
+        std::vector<std::uint64_t> edges;
+        edges.reserve(triangles.size() * 3);
+        for (const auto& corners : triangles) {
+            const auto normal = face_normal(corners);
+            const auto length = glm::length(normal);
+            if (length > 0.0) {
+                const auto unit_normal = normal / length;
+                const auto distance = -glm::dot(unit_normal, glm::dvec3(positions[corners[0]]));
+                for (const auto corner : corners) {
+                    quadrics[corner].add_plane(unit_normal, distance, 1.0);
+                }
+            }
+            for (auto k = 0u; k < 3; ++k) {
+                edges.push_back(edge_key(corners[k], corners[(k + 1) % 3]));
+            }
+        }
+
+        //  Edges used by a single face are on a border
+        std::sort(std::begin(edges), std::end(edges));
+        for (const auto& corners : triangles) {
+            const auto normal = face_normal(corners);
+            for (auto k = 0u; k < 3; ++k) {
+                const auto a = corners[k];
+                const auto b = corners[(k + 1) % 3];
+                const auto [first, last] = std::equal_range(std::begin(edges), std::end(edges), edge_key(a, b));
+                if (std::distance(first, last) != 1) {
+                    continue;
+                }
+                const auto border_normal = glm::cross(glm::dvec3(positions[b]) - glm::dvec3(positions[a]), normal);
+                const auto length = glm::length(border_normal);
+                if (length > 0.0) {
+                    const auto unit_normal = border_normal / length;
+                    const auto distance = -glm::dot(unit_normal, glm::dvec3(positions[a]));
+                    quadrics[a].add_plane(unit_normal, distance, border_weight);
+                    quadrics[b].add_plane(unit_normal, distance, border_weight);
+                }
+            }
+        }
+
+        std::vector<std::vector<unsigned int>> triangles_of(nodes_count);
+        for (auto t = 0u; t < triangles.size(); ++t) {
+            for (const auto corner : triangles[t]) {
+                triangles_of[corner].push_back(t);
+            }
+        }
+
+        //  Candidates are never updated in place: a collapse bumps the version of the node it keeps, which
+        //  turns every queued candidate touching that node stale, and queues its edges again
+        struct Collapse {
+            double error;
+            unsigned int from;
+            unsigned int to;
+            unsigned int from_version;
+            unsigned int to_version;
+        };
+        const auto more_expensive = [](const Collapse& lhs, const Collapse& rhs) { return lhs.error > rhs.error; };
+        std::priority_queue<Collapse, std::vector<Collapse>, decltype(more_expensive)> candidates(more_expensive);
+        std::vector<unsigned int> versions(nodes_count, 0);
+        std::vector<bool> removed_nodes(nodes_count, false);
+        std::vector<bool> removed_triangles(triangles.size(), false);
+
+        const auto queue_cheaper_direction = [&](const unsigned int a, const unsigned int b) {
+            auto merged = quadrics[a];
+            merged += quadrics[b];
+            const auto onto_b = merged.error_at(positions[b]);
+            const auto onto_a = merged.error_at(positions[a]);
+            candidates.push(onto_b <= onto_a ? Collapse{onto_b, a, b, versions[a], versions[b]}
+                                             : Collapse{onto_a, b, a, versions[b], versions[a]});
+        };
+        for (const auto& corners : triangles) {
+            for (auto k = 0u; k < 3; ++k) {
+                queue_cheaper_direction(corners[k], corners[(k + 1) % 3]);
+            }
+        }
+
+        const auto contains = [](const std::array<unsigned int, 3>& corners, const unsigned int node) {
+            return std::find(std::begin(corners), std::end(corners), node) != std::end(corners);
+        };
+        const auto are_connected = [&](const unsigned int from, const unsigned int to) {
+            return std::any_of(std::begin(triangles_of[from]), std::end(triangles_of[from]), [&](const unsigned int t) {
+                return !removed_triangles[t] && contains(triangles[t], to);
+            });
+        };
+        //  The faces that survive the collapse must not flip over nor become degenerate
+        const auto keeps_orientation = [&](const unsigned int from, const unsigned int to) {
+            for (const auto t : triangles_of[from]) {
+                if (removed_triangles[t] || contains(triangles[t], to)) {
+                    continue;
+                }
+                auto corners = triangles[t];
+                const auto before = face_normal(corners);
+                std::replace(std::begin(corners), std::end(corners), from, to);
+                if (glm::dot(before, face_normal(corners)) <= 0.0) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto live_triangles = triangles.size();
+        auto largest_error = 0.0;
+        while (live_triangles > target_triangles && !candidates.empty()) {
+            const auto collapse = candidates.top();
+            candidates.pop();
+            const auto from = collapse.from;
+            const auto to = collapse.to;
+            if (removed_nodes[from] || removed_nodes[to] ||
+                versions[from] != collapse.from_version || versions[to] != collapse.to_version ||
+                !are_connected(from, to) || !keeps_orientation(from, to)) {
+                continue;
+            }
+
+            for (const auto t : triangles_of[from]) {
+                if (removed_triangles[t]) {
+                    continue;
+                }
+                auto& corners = triangles[t];
+                if (contains(corners, to)) {
+                    removed_triangles[t] = true;
+                    --live_triangles;
+                } else {
+                    std::replace(std::begin(corners), std::end(corners), from, to);
+                    triangles_of[to].push_back(t);
+                }
+            }
+            triangles_of[from].clear();
+            removed_nodes[from] = true;
+            quadrics[to] += quadrics[from];
+            ++versions[to];
+            largest_error = std::max(largest_error, collapse.error);
+
+            auto& around = triangles_of[to];
+            std::erase_if(around, [&removed_triangles](const unsigned int t) { return removed_triangles[t]; });
+            for (const auto t : around) {
+                for (const auto corner : triangles[t]) {
+                    if (corner != to) {
+                        queue_cheaper_direction(to, corner);
+                    }
+                }
+            }
+        }
+
+        //  Area-weighted, as the cross product is twice the area of the face
+        std::vector<glm::dvec3> face_normals(triangles.size());
+        for (auto t = 0u; t < triangles.size(); ++t) {
+            if (!removed_triangles[t]) {
+                face_normals[t] = face_normal(triangles[t]);
+            }
+        }
+        const auto unit_or_zero = [](const glm::dvec3& v) {
+            const auto length = glm::length(v);
+            return length > 0.0 ? v / length : glm::dvec3(0.0);
+        };
+        //  A corner averages the faces around its node that are within the crease angle of its own face
+        const auto corner_normal = [&](const unsigned int t, const unsigned int node) {
+            const auto own = unit_or_zero(face_normals[t]);
+            auto sum = glm::dvec3(0.0);
+            for (const auto u : triangles_of[node]) {
+                if (!removed_triangles[u] && glm::dot(unit_or_zero(face_normals[u]), own) >= crease_angle_cosine) {
+                    sum += face_normals[u];
+                }
+            }
+            const auto length = glm::length(sum);
+            return length > 0.0 ? glm::vec3(sum / length) : welded.normals[node];
+        };
+
+        SimplifiedMesh simplified;
+        simplified.geometric_error = static_cast<float>(std::sqrt(largest_error));
+        simplified.indices.reserve(live_triangles * 3);
+        //  A node is emitted once per distinct normal of its corners
+        std::vector<std::vector<std::pair<glm::vec3, unsigned int>>> emitted_of(nodes_count);
+        auto emitted_vertices = 0u;
+        for (auto t = 0u; t < triangles.size(); ++t) {
+            if (removed_triangles[t]) {
+                continue;
+            }
+            for (const auto corner : triangles[t]) {
+                const auto n = corner_normal(t, corner);
+                auto& emitted = emitted_of[corner];
+                auto found = std::find_if(std::begin(emitted), std::end(emitted), [&n](const auto& entry) {
+                    return entry.first == n;
+                });
+                if (found == std::end(emitted)) {
+                    const auto& p = positions[corner];
+                    simplified.vertices.insert(std::end(simplified.vertices), {p.x, p.y, p.z, n.x, n.y, n.z});
+                    found = emitted.insert(std::end(emitted), {n, emitted_vertices++});
+                }
+                simplified.indices.push_back(found->second);
+            }
+        }
+        return simplified;
+    }
+}
+
+namespace engine::impl_details {
+    void Quadric::add_plane(const glm::dvec3& normal, const double distance, const double weight) {
+        const auto plane = std::array<double, 4>{normal.x, normal.y, normal.z, distance};
+        auto k = 0u;
+        for (auto i = 0u; i < 4; ++i) {
+            for (auto j = i; j < 4; ++j) {
+                coefficients[k++] += weight * plane[i] * plane[j];
+            }
+        }
+    }
+
+    Quadric& Quadric::operator+=(const Quadric& other) {
+        std::transform(std::begin(coefficients), std::end(coefficients), std::begin(other.coefficients),
+                       std::begin(coefficients), std::plus<>{});
+        return *this;
+    }
+
+    double Quadric::error_at(const glm::dvec3& point) const {
+        const auto v = std::array<double, 4>{point.x, point.y, point.z, 1.0};
+        auto error = 0.0;
+        auto k = 0u;
+        for (auto i = 0u; i < 4; ++i) {
+            for (auto j = i; j < 4; ++j) {
+                //  Off-diagonal terms stand for both halves of the symmetric matrix
+                error += (i == j ? 1.0 : 2.0) * coefficients[k++] * v[i] * v[j];
+            }
+        }
+        //  Rounding can take the sum of squares slightly below zero
+        return std::max(error, 0.0);
+    }
+
+    WeldedVertices weld_by_position(const std::span<const float> vertices) {
+        const auto vertices_count = vertices.size() / floats_per_simplified_vertex;
+        const auto position_of = [&vertices](const std::size_t v) {
+            const auto* p = &vertices[v * floats_per_simplified_vertex];
+            return glm::vec3(p[0], p[1], p[2]);
+        };
+        const auto normal_of = [&vertices](const std::size_t v) {
+            const auto* n = &vertices[v * floats_per_simplified_vertex + 3];
+            return glm::vec3(n[0], n[1], n[2]);
+        };
+
+        std::vector<unsigned int> order(vertices_count);
+        std::iota(std::begin(order), std::end(order), 0u);
+        std::sort(std::begin(order), std::end(order), [&position_of](const unsigned int a, const unsigned int b) {
+            const auto p = position_of(a);
+            const auto q = position_of(b);
+            return std::tie(p.x, p.y, p.z, a) < std::tie(q.x, q.y, q.z, b);
+        });
+
+        //  Only the connectivity is welded: averaging the normals here would round off the hard edges
+        WeldedVertices welded;
+        welded.node_of_vertex.resize(vertices_count);
+        for (const auto v : order) {
+            if (welded.positions.empty() || welded.positions.back() != position_of(v)) {
+                welded.positions.push_back(position_of(v));
+                welded.normals.push_back(normal_of(v));
+            }
+            welded.node_of_vertex[v] = static_cast<unsigned int>(welded.positions.size() - 1);
+        }
+        return welded;
+    }
+}
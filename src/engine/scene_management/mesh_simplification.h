@@ -0,0 +1,58 @@
+#ifndef MESH_SIMPLIFICATION_H
+#define MESH_SIMPLIFICATION_H
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace engine {
+    struct SimplifiedMesh {
+        std::vector<float> vertices;            //  Interleaved position and normal, as the input
+        std::vector<unsigned int> indices;
+        //  Square root of the largest quadric error accepted: an estimate of how far, in model units,
+        //  the simplified surface strays from the original one
+        float geometric_error = 0.0f;
+    };
+
+    //  Quadric error metric simplification (Garland and Heckbert) by half-edge collapses, so the remaining
+    //  vertices keep their original positions. vertices are interleaved position/normal triplets, as built by
+    //  scenes::copy_vertices; vertices sharing a position are welded first, since meshes are loaded without
+    //  joining identical vertices. Open borders are held in place by planes orthogonal to the border faces.
+    //  Stops at target_triangles or when no collapse is left that keeps the orientation of the faces.
+    //  Normals are rebuilt from the simplified faces, smoothing only across edges sharper than the crease
+    //  angle, so that hard edges stay hard.
+    [[nodiscard]] SimplifiedMesh simplify_mesh(std::span<const float> vertices, std::span<const unsigned int> indices,
+                                               unsigned int target_triangles);
+
+    namespace impl_details {
+        constexpr unsigned int floats_per_simplified_vertex = 6;
+        //  cos(60 degrees): faces meeting at a larger angle get separate normals
+        constexpr double crease_angle_cosine = 0.5;
+
+        //  Upper triangle of the symmetric 4x4 matrix p p^T, summed over the planes p = (n, d)
+        struct Quadric {
+            std::array<double, 10> coefficients{};
+
+            void add_plane(const glm::dvec3& normal, double distance, double weight);
+            Quadric& operator+=(const Quadric& other);
+            [[nodiscard]] double error_at(const glm::dvec3& point) const;
+        };
+
+        struct WeldedVertices {
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec3> normals;         //  Of the first welded vertex, for corners of degenerate faces
+            std::vector<unsigned int> node_of_vertex;
+        };
+
+        [[nodiscard]] WeldedVertices weld_by_position(std::span<const float> vertices);
+
+        [[nodiscard]] constexpr std::uint64_t edge_key(unsigned int a, unsigned int b) {
+            return a < b ? (static_cast<std::uint64_t>(a) << 32) | b : (static_cast<std::uint64_t>(b) << 32) | a;
+        }
+    }
+}
+
+#endif //MESH_SIMPLIFICATION_H
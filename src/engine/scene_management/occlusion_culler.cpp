@@ -0,0 +1,185 @@
+#include "occlusion_culler.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace engine {
+    OcclusionCuller::OcclusionCuller(std::shared_ptr<Shader> depth_pyramid_shader,
+                                     std::shared_ptr<Shader> occlusion_culling_shader,
+                                     const int depth_width, const int depth_height)
+            : pyramid_shader(std::move(depth_pyramid_shader)),
+              culling_shader(std::move(occlusion_culling_shader)),
+              depth_resolution{depth_width, depth_height} {
+        //  Level 0 already halves the depth buffer, the last level is a single texel
+        const auto width = std::max(1, depth_width / 2);
+        const auto height = std::max(1, depth_height / 2);
+        levels = static_cast<int>(std::bit_width(static_cast<unsigned int>(std::max(width, height))));
+
+        glGenTextures(1, &depth_pyramid);
+        OpenGL3_State_Cache::bind_texture(0, GL_TEXTURE_2D, depth_pyramid);
+        glTexStorage2D(GL_TEXTURE_2D, levels, GL_R32F, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        pyramid_shader->use();
+        pyramid_shader->set(pyramid_shader->uniform<int>("source_depth"), 0);
+        source_level = pyramid_shader->uniform<int>("source_level");
+
+        culling_shader->use();
+        culling_shader->set(culling_shader->uniform<int>("depth_pyramid"), 0);
+        culling_projection_view = culling_shader->uniform<glm::mat4>("projection_view");
+        culling_depth_resolution = culling_shader->uniform<glm::vec2>("depth_resolution");
+        culling_objects_count = culling_shader->uniform<unsigned int>("objects_count");
+
+        counters = std::make_unique<VertexBuffer>(sizeof(OcclusionStatistics));
+        for (auto& buffer : readback_buffers) {
+            buffer = std::make_unique<VertexBuffer>(sizeof(OcclusionStatistics));
+        }
+    }
+
+    OcclusionCuller::~OcclusionCuller() {
+        discard_pending_readbacks();
+        OpenGL3_State_Cache::forget_texture(depth_pyramid);
+        glDeleteTextures(1, &depth_pyramid);
+    }
+
+    bool OcclusionCuller::is_supported() {
+        return GLAD_GL_VERSION_4_3 != 0;
+    }
+
+    void OcclusionCuller::reset(const SceneDrawBatch& batch, const std::span<const AABB> world_bounds) {
+        objects_count = batch.draw_count();
+        //  Empty buffers cannot be bound to storage binding points
+        const auto capacity = std::max(objects_count, 1u);
+        object_bounds = std::make_unique<VertexBuffer>(capacity * sizeof(ObjectBoundsData));
+        visible_commands = std::make_unique<VertexBuffer>(capacity * sizeof(DrawElementsIndirectCommand));
+        newly_visible_commands = std::make_unique<VertexBuffer>(capacity * sizeof(DrawElementsIndirectCommand));
+        if (objects_count > 0) {
+            batch.copy_commands_to(*visible_commands);
+            update_bounds(world_bounds);
+        }
+        discard_pending_readbacks();
+        last_statistics = OcclusionStatistics{};
+    }
+
+    void OcclusionCuller::update_bounds(const std::span<const AABB> world_bounds) {
+        if (world_bounds.size() != objects_count) {
+            fmt::print("[OCCLUSION CULLER] Got {} bounding boxes for {} objects\n", world_bounds.size(), objects_count);
+            return;
+        }
+        std::vector<ObjectBoundsData> data;
+        data.reserve(world_bounds.size());
+        for (const auto& bounds : world_bounds) {
+            data.push_back(ObjectBoundsData{glm::vec4(bounds.min, 1.0f), glm::vec4(bounds.max, 1.0f)});
+        }
+        object_bounds->set_sub_data(0, data.size() * sizeof(ObjectBoundsData), data.data());
+    }
+
+    void OcclusionCuller::draw_visible_last_frame(const SceneDrawBatch& batch) const {
+        if (objects_count > 0) {
+            batch.draw_with_commands(*visible_commands);
+        }
+    }
+
+    void OcclusionCuller::cull_against(const OpenGL3_Texture2D& depth, const glm::mat4& projection_view) {
+        if (objects_count == 0) {
+            return;
+        }
+        read_back_statistics();
+        build_depth_pyramid(depth);
+
+        const auto cleared = OcclusionStatistics{};
+        counters->set_sub_data(0, sizeof(cleared), &cleared);
+
+        culling_shader->use();
+        OpenGL3_State_Cache::bind_texture(0, GL_TEXTURE_2D, depth_pyramid);
+        culling_shader->set(culling_projection_view, projection_view);
+        culling_shader->set(culling_depth_resolution, glm::vec2(depth_resolution));
+        culling_shader->set(culling_objects_count, objects_count);
+        object_bounds->bind_to_storage_binding_point(0);
+        visible_commands->bind_to_storage_binding_point(1);
+        newly_visible_commands->bind_to_storage_binding_point(2);
+        counters->bind_to_storage_binding_point(3);
+
+        glDispatchCompute((objects_count + culling_work_group_size - 1) / culling_work_group_size, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        copy_statistics_for_readback();
+    }
+
+    void OcclusionCuller::draw_newly_visible(const SceneDrawBatch& batch) const {
+        if (objects_count > 0) {
+            batch.draw_with_commands(*newly_visible_commands);
+        }
+    }
+
+    const OcclusionStatistics& OcclusionCuller::statistics() const {
+        return last_statistics;
+    }
+
+    int OcclusionCuller::pyramid_levels() const {
+        return levels;
+    }
+
+    void OcclusionCuller::build_depth_pyramid(const OpenGL3_Texture2D& depth) const {
+        pyramid_shader->use();
+        depth.bind_to_slot(0);
+        for (auto level = 0; level < levels; ++level) {
+            //  Every level reads the previous one, level 0 reads the depth buffer itself
+            if (level > 0) {
+                OpenGL3_State_Cache::bind_texture(0, GL_TEXTURE_2D, depth_pyramid);
+            }
+            pyramid_shader->set(source_level, std::max(level - 1, 0));
+            glBindImageTexture(0, depth_pyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            const auto width = static_cast<unsigned int>(std::max(1, depth_resolution.x >> (level + 1)));
+            const auto height = static_cast<unsigned int>(std::max(1, depth_resolution.y >> (level + 1)));
+            glDispatchCompute((width + pyramid_work_group_size - 1) / pyramid_work_group_size,
+                              (height + pyramid_work_group_size - 1) / pyramid_work_group_size,
+                              1);
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        }
+    }
+
+    void OcclusionCuller::read_back_statistics() {
+        //  Oldest copy first, so that the newest finished one is what remains; a copy whose fence has not
+        //  signalled yet is left for a later frame instead of stalling on it
+        for (auto i = 0u; i < statistics_readbacks; ++i) {
+            const auto slot = (next_readback + i) % statistics_readbacks;
+            auto& fence = readback_fences[slot];
+            if (fence == nullptr) {
+                continue;
+            }
+            const auto status = glClientWaitSync(fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                continue;
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+            glBindBuffer(GL_COPY_READ_BUFFER, readback_buffers[slot]->get_id());
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(last_statistics), &last_statistics);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+    }
+
+    void OcclusionCuller::copy_statistics_for_readback() {
+        //  With every copy still in flight the GPU is more than a ring behind; this frame's counters are skipped
+        auto& fence = readback_fences[next_readback];
+        if (fence != nullptr) {
+            return;
+        }
+        counters->copy_to(*readback_buffers[next_readback], 0);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        next_readback = (next_readback + 1) % statistics_readbacks;
+    }
+
+    void OcclusionCuller::discard_pending_readbacks() {
+        for (auto& fence : readback_fences) {
+            if (fence != nullptr) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+    }
+}
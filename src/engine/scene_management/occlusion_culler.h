@@ -0,0 +1,95 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include "bounding_volumes.h"
+#include "scene_draw_batch.h"
+
+#include "../rendering/opengl3_texture.h"
+#include "../rendering/shader.h"
+
+#include <array>
+#include <memory>
+#include <span>
+
+namespace engine {
+    //  std430 layout of an element of Bounds in occlusion_culling.comp; w is unused
+    struct ObjectBoundsData {
+        glm::vec4 min_corner;
+        glm::vec4 max_corner;
+    };
+
+    //  Same layout as the Counters buffer in occlusion_culling.comp
+    struct OcclusionStatistics {
+        unsigned int first_phase_objects = 0;      //  Visible in the previous frame, drawn before the test
+        unsigned int second_phase_objects = 0;     //  Found visible against the pyramid of this frame
+        unsigned int culled_objects = 0;
+        unsigned int culled_triangles = 0;
+    };
+
+    //  Two-phase occlusion culling of a SceneDrawBatch. The objects visible in the previous frame are drawn
+    //  first; a Hi-Z pyramid of their depth, where every texel keeps the farthest depth of the texels it
+    //  covers, is built with a compute shader and the bounding box of every object is tested against it.
+    //  The objects that pass and were not drawn yet go into a second indirect draw, and the result becomes
+    //  the first phase of the next frame. Nothing is read back but the statistics: the counters are copied
+    //  into a small ring of buffers and each copy is read once its fence has signalled, a few frames late.
+    class OcclusionCuller {
+    public:
+        static constexpr unsigned int pyramid_work_group_size = 8;
+        static constexpr unsigned int culling_work_group_size = 64;
+        static constexpr unsigned int statistics_readbacks = 3;
+
+        OcclusionCuller(std::shared_ptr<Shader> depth_pyramid_shader, std::shared_ptr<Shader> occlusion_culling_shader,
+                        int depth_width, int depth_height);
+
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller();
+
+        [[nodiscard]] static bool is_supported();
+
+        //  Starts over with every object of the batch visible; world_bounds follow the order of the batch
+        void reset(const SceneDrawBatch& batch, std::span<const AABB> world_bounds);
+        //  For objects that moved; the count must not change
+        void update_bounds(std::span<const AABB> world_bounds);
+
+        void draw_visible_last_frame(const SceneDrawBatch& batch) const;
+        //  depth must hold the first phase only and have the size given at construction
+        void cull_against(const OpenGL3_Texture2D& depth, const glm::mat4& projection_view);
+        //  The program used by the first phase has to be bound again, cull_against leaves its own in use
+        void draw_newly_visible(const SceneDrawBatch& batch) const;
+
+        [[nodiscard]] const OcclusionStatistics& statistics() const;
+        [[nodiscard]] int pyramid_levels() const;
+
+    private:
+        void build_depth_pyramid(const OpenGL3_Texture2D& depth) const;
+        void read_back_statistics();
+        void copy_statistics_for_readback();
+        void discard_pending_readbacks();
+
+        std::shared_ptr<Shader> pyramid_shader;
+        std::shared_ptr<Shader> culling_shader;
+        Uniform<int> source_level;
+        Uniform<glm::mat4> culling_projection_view;
+        Uniform<glm::vec2> culling_depth_resolution;
+        Uniform<unsigned int> culling_objects_count;
+
+        unsigned int depth_pyramid = 0;
+        glm::vec<2, int> depth_resolution;
+        int levels = 1;
+
+        std::unique_ptr<VertexBuffer> object_bounds;
+        std::unique_ptr<VertexBuffer> visible_commands;     //  Instance counts are the visibility of the last test
+        std::unique_ptr<VertexBuffer> newly_visible_commands;
+        std::unique_ptr<VertexBuffer> counters;
+        std::array<std::unique_ptr<VertexBuffer>, statistics_readbacks> readback_buffers;
+        std::array<GLsync, statistics_readbacks> readback_fences{};     //  Pending while not null
+        unsigned int next_readback = 0;
+        unsigned int objects_count = 0;
+        OcclusionStatistics last_statistics;
+    };
+}
+
+#endif //OCCLUSION_CULLER_H
@@ -0,0 +1,169 @@
+#include "scene_bvh.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace engine {
+    void SceneBVH::build(const std::span<const AABB> object_bounds) {
+        bounds_of_objects.assign(std::begin(object_bounds), std::end(object_bounds));
+        object_indices.resize(object_bounds.size());
+        std::iota(std::begin(object_indices), std::end(object_indices), 0u);
+        nodes.clear();
+        if (!object_bounds.empty()) {
+            nodes.reserve(2 * object_bounds.size());
+            build_node(0, static_cast<unsigned int>(object_bounds.size()));
+        }
+    }
+
+    unsigned int SceneBVH::build_node(const unsigned int first, const unsigned int count) {
+        const auto node_index = static_cast<unsigned int>(nodes.size());
+        nodes.push_back(BVHNode{AABB{}, first, count, 0});
+
+        AABB bounds;
+        AABB centroids;
+        for (auto i = first; i < first + count; ++i) {
+            bounds.expand(bounds_of_objects[object_indices[i]]);
+            centroids.expand(bounds_of_objects[object_indices[i]].center());
+        }
+        nodes[node_index].bounds = bounds;
+        if (count <= max_leaf_size) {
+            return node_index;
+        }
+
+        const auto size = centroids.max - centroids.min;
+        const auto axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+        const auto begin = std::begin(object_indices) + first;
+        const auto middle = begin + count / 2;
+        std::nth_element(begin, middle, begin + count, [this, axis](const std::uint32_t a, const std::uint32_t b) {
+            return bounds_of_objects[a].center()[axis] < bounds_of_objects[b].center()[axis];
+        });
+
+        build_node(first, count / 2);
+        const auto second_child = build_node(first + count / 2, count - count / 2);
+        nodes[node_index].second_child = second_child;
+        return node_index;
+    }
+
+    void SceneBVH::refit(const std::span<const AABB> object_bounds) {
+        if (object_bounds.size() != bounds_of_objects.size()) {
+            build(object_bounds);
+            return;
+        }
+        std::copy(std::begin(object_bounds), std::end(object_bounds), std::begin(bounds_of_objects));
+        //  Children always come after their parent
+        for (auto node = nodes.rbegin(); node != nodes.rend(); ++node) {
+            if (node->second_child == 0) {
+                node->bounds = AABB{};
+                for (auto i = node->first; i < node->first + node->count; ++i) {
+                    node->bounds.expand(bounds_of_objects[object_indices[i]]);
+                }
+            } else {
+                const auto index = static_cast<std::size_t>(std::distance(node, nodes.rend())) - 1;
+                node->bounds = nodes[index + 1].bounds;
+                node->bounds.expand(nodes[node->second_child].bounds);
+            }
+        }
+    }
+
+    void SceneBVH::cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) const {
+        visible.clear();
+        if (nodes.empty()) {
+            return;
+        }
+        std::vector<unsigned int> pending{0};
+        while (!pending.empty()) {
+            const auto index = pending.back();
+            pending.pop_back();
+            const auto& node = nodes[index];
+
+            const auto containment = frustum.classify(node.bounds);
+            if (containment == Containment::Outside) {
+                continue;
+            }
+            if (containment == Containment::Inside) {
+                visible.insert(std::end(visible), std::begin(object_indices) + node.first,
+                               std::begin(object_indices) + node.first + node.count);
+            } else if (node.second_child == 0) {
+                for (auto i = node.first; i < node.first + node.count; ++i) {
+                    if (frustum.classify(bounds_of_objects[object_indices[i]]) != Containment::Outside) {
+                        visible.push_back(object_indices[i]);
+                    }
+                }
+            } else {
+                pending.push_back(node.second_child);
+                pending.push_back(index + 1);
+            }
+        }
+    }
+
+    void SceneBVH::cull_faces(const std::span<const Frustum> faces, std::vector<std::uint8_t>& culled_faces) const {
+        culled_faces.assign(bounds_of_objects.size(), 0);
+        if (nodes.empty()) {
+            return;
+        }
+        const auto faces_count = static_cast<unsigned int>(std::min<std::size_t>(faces.size(), 6));
+        const auto all_faces = static_cast<std::uint8_t>((1u << faces_count) - 1);
+
+        //  Node, faces the node still straddles, faces the node is outside of
+        struct Pending {
+            unsigned int node;
+            std::uint8_t undecided;
+            std::uint8_t culled;
+        };
+        std::vector<Pending> pending{{0, all_faces, 0}};
+        while (!pending.empty()) {
+            auto [index, undecided, culled] = pending.back();
+            pending.pop_back();
+            const auto& node = nodes[index];
+
+            for (auto face = 0u; face < faces_count; ++face) {
+                const auto bit = static_cast<std::uint8_t>(1u << face);
+                if ((undecided & bit) == 0) {
+                    continue;
+                }
+                const auto containment = faces[face].classify(node.bounds);
+                if (containment != Containment::Intersecting) {
+                    undecided &= static_cast<std::uint8_t>(~bit);
+                }
+                if (containment == Containment::Outside) {
+                    culled |= bit;
+                }
+            }
+
+            if (undecided == 0) {
+                assign_to_subtree(node, culled, culled_faces);
+            } else if (node.second_child == 0) {
+                for (auto i = node.first; i < node.first + node.count; ++i) {
+                    auto object_culled = culled;
+                    for (auto face = 0u; face < faces_count; ++face) {
+                        const auto bit = static_cast<std::uint8_t>(1u << face);
+                        if ((undecided & bit) != 0 &&
+                            faces[face].classify(bounds_of_objects[object_indices[i]]) == Containment::Outside) {
+                            object_culled |= bit;
+                        }
+                    }
+                    culled_faces[object_indices[i]] = object_culled;
+                }
+            } else {
+                pending.push_back({node.second_child, undecided, culled});
+                pending.push_back({index + 1, undecided, culled});
+            }
+        }
+    }
+
+    void SceneBVH::assign_to_subtree(const BVHNode& node, const std::uint8_t mask,
+                                     std::vector<std::uint8_t>& culled_faces) const {
+        for (auto i = node.first; i < node.first + node.count; ++i) {
+            culled_faces[object_indices[i]] = mask;
+        }
+    }
+
+    std::size_t SceneBVH::objects_count() const {
+        return bounds_of_objects.size();
+    }
+
+    std::size_t SceneBVH::nodes_count() const {
+        return nodes.size();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SCENE_BVH_H
+#define SCENE_BVH_H
+
+#include "bounding_volumes.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace engine {
+    //  Nodes are stored depth first: the first child of an interior node follows it, second_child points
+    //  to the other one. Every node covers a contiguous range of object_indices, so subtrees that are
+    //  entirely inside a frustum are accepted without visiting them.
+    struct BVHNode {
+        AABB bounds;
+        unsigned int first;
+        unsigned int count;
+        unsigned int second_child;      //  0 for leaves
+    };
+
+    class SceneBVH {
+    public:
+        static constexpr unsigned int max_leaf_size = 2;
+        static constexpr std::uint8_t all_faces_culled = 0x3F;
+
+        //  Median split on the longest axis of the centroids
+        void build(std::span<const AABB> object_bounds);
+        //  Keeps the topology and recomputes the bounds, for objects that moved; the count must not change
+        void refit(std::span<const AABB> object_bounds);
+
+        //  Indices of the objects whose bounds are not outside the frustum, in no particular order
+        void cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) const;
+        //  For every object a mask where bit f is set when it is outside faces[f]; at most 6 faces
+        void cull_faces(std::span<const Frustum> faces, std::vector<std::uint8_t>& culled_faces) const;
+
+        [[nodiscard]] std::size_t objects_count() const;
+        [[nodiscard]] std::size_t nodes_count() const;
+
+    private:
+        std::vector<BVHNode> nodes;
+        std::vector<std::uint32_t> object_indices;
+        std::vector<AABB> bounds_of_objects;
+
+        unsigned int build_node(unsigned int first, unsigned int count);
+        void assign_to_subtree(const BVHNode& node, std::uint8_t mask, std::vector<std::uint8_t>& culled_faces) const;
+    };
+}
+
+#endif //SCENE_BVH_H
@@ -0,0 +1,163 @@
+#include "scene_cache.h"
+
+#include <fmt/core.h>
+
+#include <fstream>
+#include <type_traits>
+
+namespace engine::scenes {
+    using namespace impl_details;
+
+    std::filesystem::path scene_cache_path_for(const std::string& path_to_scene) {
+        return std::filesystem::path(path_to_scene + ".scenecache");
+    }
+
+    std::optional<std::uint64_t> hash_file_contents(const std::filesystem::path& path) {
+        constexpr std::uint64_t fnv_prime = 0x100000001b3;
+        std::ifstream source(path, std::ios::binary);
+        if (!source) {
+            return std::nullopt;
+        }
+
+        std::uint64_t hash = 0xcbf29ce484222325;
+        std::array<char, 1 << 16> chunk{};
+        while (source.read(chunk.data(), chunk.size()) || source.gcount() > 0) {
+            for (auto i = 0; i < source.gcount(); ++i) {
+                hash ^= static_cast<unsigned char>(chunk[i]);
+                hash *= fnv_prime;
+            }
+        }
+        return hash;
+    }
+
+    std::optional<std::vector<MeshData>> read_scene_cache(const std::filesystem::path& cache_path,
+                                                          const std::uint64_t source_hash,
+                                                          const unsigned int postprocess_flags) {
+        std::error_code error;
+        const auto file_size = std::filesystem::file_size(cache_path, error);
+        std::ifstream stream(cache_path, std::ios::binary);
+        if (error || !stream) {
+            return std::nullopt;
+        }
+
+        auto magic = std::array<char, 4>{};
+        auto version = std::uint32_t{0};
+        auto material_data_size = std::uint32_t{0};
+        auto cached_flags = std::uint32_t{0};
+        auto cached_hash = std::uint64_t{0};
+        auto meshes_count = std::uint32_t{0};
+        if (!read_value(stream, magic) || !read_value(stream, version) || !read_value(stream, material_data_size) ||
+            !read_value(stream, cached_flags) || !read_value(stream, cached_hash) || !read_value(stream, meshes_count) ||
+            magic != scene_cache_magic) {
+            fmt::print("[SCENE CACHE] {} is not a scene cache, it will be rebuilt\n", cache_path.string());
+            return std::nullopt;
+        }
+        if (version != scene_cache_version || material_data_size != sizeof(MaterialData) ||
+            cached_flags != postprocess_flags || cached_hash != source_hash) {
+            fmt::print("[SCENE CACHE] {} is stale, it will be rebuilt\n", cache_path.string());
+            return std::nullopt;
+        }
+
+        //  Transform, material and the name, vertex, index and proxy counts, even for an empty mesh
+        constexpr auto minimum_mesh_size = sizeof(MeshData::transform) + sizeof(MaterialData) +
+                                           4 * sizeof(std::uint32_t);
+        if (meshes_count > file_size / minimum_mesh_size) {
+            fmt::print("[SCENE CACHE] {} is damaged, it will be rebuilt\n", cache_path.string());
+            return std::nullopt;
+        }
+
+        std::vector<MeshData> meshes(meshes_count);
+        for (auto& mesh : meshes) {
+            std::vector<char> name;
+            auto proxies_count = std::uint32_t{0};
+            auto complete = read_value(stream, mesh.transform) && read_value(stream, mesh.material.data) &&
+                            read_array(stream, name, file_size) && read_array(stream, mesh.vertices, file_size) &&
+                            read_array(stream, mesh.indices, file_size) && read_value(stream, proxies_count) &&
+                            proxies_count <= max_mesh_proxies;
+            mesh.material.name.assign(std::begin(name), std::end(name));
+            mesh.proxies.resize(complete ? proxies_count : 0);
+            for (auto& proxy : mesh.proxies) {
+                complete = complete && read_value(stream, proxy.geometric_error) &&
+                           read_array(stream, proxy.vertices, file_size) && read_array(stream, proxy.indices, file_size);
+            }
+            if (!complete) {
+                fmt::print("[SCENE CACHE] {} is damaged, it will be rebuilt\n", cache_path.string());
+                return std::nullopt;
+            }
+        }
+        return meshes;
+    }
+
+    bool write_scene_cache(const std::filesystem::path& cache_path, const std::uint64_t source_hash,
+                           const unsigned int postprocess_flags, const std::span<const MeshData> meshes) {
+        auto temporary_path = cache_path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+            write_value(stream, scene_cache_magic);
+            write_value(stream, scene_cache_version);
+            write_value(stream, static_cast<std::uint32_t>(sizeof(MaterialData)));
+            write_value(stream, static_cast<std::uint32_t>(postprocess_flags));
+            write_value(stream, source_hash);
+            write_value(stream, static_cast<std::uint32_t>(meshes.size()));
+            for (const auto& mesh : meshes) {
+                write_value(stream, mesh.transform);
+                write_value(stream, mesh.material.data);
+                write_array(stream, std::span<const char>(mesh.material.name));
+                write_array(stream, std::span<const float>(mesh.vertices));
+                write_array(stream, std::span<const unsigned int>(mesh.indices));
+                write_value(stream, static_cast<std::uint32_t>(mesh.proxies.size()));
+                for (const auto& proxy : mesh.proxies) {
+                    write_value(stream, proxy.geometric_error);
+                    write_array(stream, std::span<const float>(proxy.vertices));
+                    write_array(stream, std::span<const unsigned int>(proxy.indices));
+                }
+            }
+            if (!stream) {
+                fmt::print("[SCENE CACHE] Writing {} failed\n", temporary_path.string());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary_path, cache_path, error);
+        if (error) {
+            fmt::print("[SCENE CACHE] Could not replace {}: {}\n", cache_path.string(), error.message());
+            std::filesystem::remove(temporary_path, error);
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace engine::scenes::impl_details {
+    template<typename T>
+    void write_value(std::ostream& stream, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void write_array(std::ostream& stream, const std::span<const T> values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write_value(stream, static_cast<std::uint32_t>(values.size()));
+        stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+    }
+
+    template<typename T>
+    bool read_value(std::istream& stream, T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template<typename T>
+    bool read_array(std::istream& stream, std::vector<T>& values, const std::uintmax_t max_bytes) {
+        auto count = std::uint32_t{0};
+        if (!read_value(stream, count) || static_cast<std::uintmax_t>(count) * sizeof(T) > max_bytes) {
+            return false;
+        }
+        values.resize(count);
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(values.data()),
+                                             static_cast<std::streamsize>(count * sizeof(T))));
+    }
+}
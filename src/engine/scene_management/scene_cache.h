@@ -0,0 +1,51 @@
+#ifndef SCENE_CACHE_H
+#define SCENE_CACHE_H
+
+#include "scene_loading.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace engine::scenes {
+    //  Bump whenever MeshData or the processing that produces it changes, so older caches are rebuilt
+    constexpr std::uint32_t scene_cache_version = 1;
+
+    //  Native-endian binary file next to the source:
+    //    magic "ESCN", version, sizeof(MaterialData), post-process flags, FNV-1a hash of the source, mesh count;
+    //    per mesh its transform, MaterialData, material name, vertices and indices, then the proxy count and
+    //    for every proxy its error, vertices and indices.
+    //  Arrays are a 32-bit element count followed by the elements, laid out as the pool uploads them. Files
+    //  the source refers to, such as OBJ material libraries, are not part of the key.
+    [[nodiscard]] std::filesystem::path scene_cache_path_for(const std::string& path_to_scene);
+    [[nodiscard]] std::optional<std::uint64_t> hash_file_contents(const std::filesystem::path& path);
+
+    //  nullopt when the cache is missing, stale or damaged
+    [[nodiscard]] std::optional<std::vector<MeshData>> read_scene_cache(const std::filesystem::path& cache_path,
+                                                                        std::uint64_t source_hash,
+                                                                        unsigned int postprocess_flags);
+    //  Goes through a temporary file renamed at the end, so an interrupted write never leaves a truncated cache
+    bool write_scene_cache(const std::filesystem::path& cache_path, std::uint64_t source_hash,
+                           unsigned int postprocess_flags, std::span<const MeshData> meshes);
+
+    namespace impl_details {
+        constexpr std::array<char, 4> scene_cache_magic{'E', 'S', 'C', 'N'};
+
+        template<typename T>
+        void write_value(std::ostream& stream, const T& value);
+        template<typename T>
+        void write_array(std::ostream& stream, std::span<const T> values);
+
+        template<typename T>
+        [[nodiscard]] bool read_value(std::istream& stream, T& value);
+        //  Counts that would need more than max_bytes are taken as damage rather than allocated
+        template<typename T>
+        [[nodiscard]] bool read_array(std::istream& stream, std::vector<T>& values, std::uintmax_t max_bytes);
+    }
+}
+
+#endif //SCENE_CACHE_H
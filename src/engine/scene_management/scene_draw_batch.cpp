@@ -0,0 +1,128 @@
+#include "scene_draw_batch.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace engine {
+    SceneDrawBatch::SceneDrawBatch(const std::vector<SceneObject>& objects)
+            : commands_count{static_cast<unsigned int>(objects.size())} {
+        std::vector<DrawElementsIndirectCommand> commands;
+        commands.reserve(objects.size());
+
+        const auto& pool = objects.empty() ? nullptr : objects.front().geometry.pool();
+        const auto in_same_pool = [&pool](const SceneObject& o) { return o.geometry.pool() == pool; };
+        if (pool && std::all_of(std::begin(objects), std::end(objects), in_same_pool)) {
+            //  Pooled meshes already share their buffers, the commands only point into them
+            for (const auto& o : objects) {
+                const auto range = o.geometry_range();
+                commands.push_back(DrawElementsIndirectCommand{range.index_count, 1, range.first_index,
+                                                               range.base_vertex,
+                                                               static_cast<unsigned int>(commands.size())});
+            }
+            vao.set_vbo(std::shared_ptr<VertexBuffer>(pool->vertex_buffer()));
+            vao.set_ebo(std::shared_ptr<ElementBuffer>(pool->element_buffer()));
+        } else if (std::any_of(std::begin(objects), std::end(objects),
+                               [](const SceneObject& o) { return o.geometry.is_valid(); })) {
+            fmt::print("[SCENE DRAW BATCH] Objects from different geometry pools cannot share one batch\n");
+            commands_count = 0;
+        } else {
+            copy_geometry_of(objects, commands);
+        }
+
+        std::vector<unsigned int> indices_of_objects(objects.size());
+        std::iota(std::begin(indices_of_objects), std::end(indices_of_objects), 0u);
+        object_indices = std::make_shared<VertexBuffer>(indices_of_objects.size() * sizeof(unsigned int),
+                                                        indices_of_objects.data());
+        vao.bind();
+        object_indices->bind();
+        glEnableVertexAttribArray(object_index_location);
+        glVertexAttribIPointer(object_index_location, 1, GL_UNSIGNED_INT, sizeof(unsigned int), nullptr);
+        glVertexAttribDivisor(object_index_location, 1);
+        vao.unbind();
+
+        glGenBuffers(1, &commands_buffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+                     commands.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        object_data = std::make_shared<VertexBuffer>(objects.size() * sizeof(ObjectShaderData));
+        update_object_data(objects);
+    }
+
+    SceneDrawBatch::~SceneDrawBatch() {
+        glDeleteBuffers(1, &commands_buffer);
+    }
+
+    bool SceneDrawBatch::is_supported() {
+        return GLAD_GL_VERSION_4_3;
+    }
+
+    void SceneDrawBatch::update_object_data(const std::vector<SceneObject>& objects) {
+        std::vector<ObjectShaderData> data;
+        data.reserve(objects.size());
+        for (const auto& o : objects) {
+            data.push_back(ObjectShaderData{o.transform, o.transpose_inverse_transform,
+                                            o.material.data.diffuse_color,
+                                            glm::vec4(o.material.data.shininess, 0.0f, 0.0f, 0.0f)});
+        }
+        object_data->set_data(data.size() * sizeof(ObjectShaderData), data.data());
+    }
+
+    void SceneDrawBatch::draw() const {
+        object_data->bind_to_storage_binding_point(object_data_binding_point);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer);
+        OpenGL3_Renderer::multi_draw_indirect(vao, commands_count);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void SceneDrawBatch::draw_with_commands(const VertexBuffer& commands) const {
+        object_data->bind_to_storage_binding_point(object_data_binding_point);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.get_id());
+        OpenGL3_Renderer::multi_draw_indirect(vao, commands_count);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void SceneDrawBatch::copy_commands_to(const VertexBuffer& destination) const {
+        glBindBuffer(GL_COPY_READ_BUFFER, commands_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, destination.get_id());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            commands_count * sizeof(DrawElementsIndirectCommand));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+
+    void SceneDrawBatch::copy_geometry_of(const std::vector<SceneObject>& objects,
+                                          std::vector<DrawElementsIndirectCommand>& commands) {
+        auto vertices_size = 0u;
+        auto indices_count = 0u;
+        for (const auto& o : objects) {
+            const auto stride = o.vao->get_vbo()->get_buffer_layout().get_stride();
+            const auto object_indices_count = o.vao->get_ebo()->get_count();
+            commands.push_back(DrawElementsIndirectCommand{object_indices_count, 1, indices_count,
+                                                           static_cast<int>(vertices_size / stride),
+                                                           static_cast<unsigned int>(commands.size())});
+            vertices_size += o.vao->get_vbo()->size_in_bytes();
+            indices_count += object_indices_count;
+        }
+
+        auto vbo = std::make_shared<VertexBuffer>(vertices_size);
+        auto ebo = std::make_shared<ElementBuffer>(nullptr, indices_count);
+        for (auto i = 0u; i < objects.size(); ++i) {
+            const auto& o = objects[i];
+            o.vao->get_vbo()->copy_to(*vbo, commands[i].base_vertex * o.vao->get_vbo()->get_buffer_layout().get_stride());
+            o.vao->get_ebo()->copy_to(*ebo, commands[i].first_index);
+        }
+        vbo->set_buffer_layout(VertexBufferLayout({
+                                                          VertexBufferElement(ShaderDataType::Float3,
+                                                                              "position"),
+                                                          VertexBufferElement(ShaderDataType::Float3,
+                                                                              "normal")}));
+        vao.set_vbo(std::move(vbo));
+        vao.set_ebo(std::move(ebo));
+    }
+
+    unsigned int SceneDrawBatch::draw_count() const {
+        return commands_count;
+    }
+}
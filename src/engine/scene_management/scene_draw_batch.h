@@ -0,0 +1,69 @@
+#ifndef SCENE_DRAW_BATCH_H
+#define SCENE_DRAW_BATCH_H
+
+#include "scene_object.h"
+
+#include "../rendering/renderer.h"
+
+#include <vector>
+
+namespace engine {
+    //  Same layout as the command read by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        unsigned int count;
+        unsigned int instance_count;
+        unsigned int first_index;
+        int base_vertex;
+        unsigned int base_instance;
+    };
+
+    //  std430 layout of an element of the ObjectData buffer in the *_indirect.vert shaders
+    struct ObjectShaderData {
+        glm::mat4 model;
+        glm::mat4 transposed_inversed_model;
+        glm::vec4 diffuse_color;
+        glm::vec4 shininess;    //  Only x is used, the rest pads the element to a multiple of 16 bytes
+    };
+
+    //  All the geometry of a list of objects in one vertex and one element buffer, drawn with a single
+    //  glMultiDrawElementsIndirect; the base instance of every command is the index of its object in
+    //  ObjectData, read through the instanced object_index attribute. Objects from one GeometryPool are
+    //  drawn straight from the pool's buffers (rebuild the batch if the pool grows), objects with their own
+    //  buffers are copied into the batch.
+    class SceneDrawBatch {
+    public:
+        static constexpr unsigned int object_data_binding_point = 2;
+        static constexpr unsigned int object_index_location = 2;
+
+        explicit SceneDrawBatch(const std::vector<SceneObject>& objects);
+
+        SceneDrawBatch(const SceneDrawBatch& other) = delete;
+        SceneDrawBatch(SceneDrawBatch&& other) = delete;
+        SceneDrawBatch& operator=(const SceneDrawBatch& other) = delete;
+        SceneDrawBatch& operator=(SceneDrawBatch&& other) = delete;
+        ~SceneDrawBatch();
+
+        [[nodiscard]] static bool is_supported();
+
+        //  objects must be the same list, in the same order, the batch was built from
+        void update_object_data(const std::vector<SceneObject>& objects);
+        void draw() const;
+        //  Same as draw(), with commands read from another buffer holding draw_count() commands; commands
+        //  with an instance count of 0 are skipped by the GPU
+        void draw_with_commands(const VertexBuffer& commands) const;
+        void copy_commands_to(const VertexBuffer& destination) const;
+
+        [[nodiscard]] unsigned int draw_count() const;
+
+    private:
+        void copy_geometry_of(const std::vector<SceneObject>& objects, std::vector<DrawElementsIndirectCommand>& commands);
+
+        VertexArray vao;
+        std::shared_ptr<VertexBuffer> object_indices;
+        std::shared_ptr<VertexBuffer> object_data;
+        unsigned int commands_buffer = 0;
+        unsigned int commands_count = 0;
+    };
+}
+
+#endif //SCENE_DRAW_BATCH_H
@@ -1,4 +1,9 @@
 #include "scene_loading.h"
+#include "scene_cache.h"
+
+#include "../../utility/cpu_profiler.h"
+
+#include <cstring>
 
 namespace engine::scenes{
 
@@ -75,41 +80,50 @@ namespace engine::scenes{
         return m;
     }
 
-    SceneObject process_mesh(const aiScene* source_scene, const aiMesh* mesh, const aiMatrix4x4& mesh_transform){
-        std::vector<float> vertices;
-        std::vector<unsigned int> indices;
-
-        copy_vertices(mesh, vertices);
-        copy_indices(mesh, indices);
+    std::vector<SimplifiedMesh> build_mesh_proxies(const std::vector<float>& vertices,
+                                                   const std::vector<unsigned int>& indices){
+        std::vector<SimplifiedMesh> proxies;
+        auto triangles = static_cast<unsigned int>(indices.size() / 3);
+        auto accumulated_error = 0.0f;
+        while(proxies.size() < max_mesh_proxies && triangles >= min_triangles_for_proxies){
+            auto simplified = proxies.empty() ? simplify_mesh(vertices, indices, triangles / 4)
+                                              : simplify_mesh(proxies.back().vertices, proxies.back().indices,
+                                                              triangles / 4);
+            const auto simplified_triangles = static_cast<unsigned int>(simplified.indices.size() / 3);
+            //  Collapses that stop early would only add a level almost as heavy as the previous one
+            if(simplified_triangles * 4 > triangles * 3){
+                break;
+            }
+            accumulated_error += simplified.geometric_error;
+            simplified.geometric_error = accumulated_error;
+            triangles = simplified_triangles;
+            proxies.push_back(std::move(simplified));
+        }
+        return proxies;
+    }
 
-
-        auto vbo = std::make_shared<VertexBuffer>(vertices.size() * sizeof(float),
-                                                  vertices.data());
-        vbo->set_buffer_layout(VertexBufferLayout({
-                                                          VertexBufferElement(ShaderDataType::Float3,
-                                                                              "position"),
-                                                          VertexBufferElement(ShaderDataType::Float3,
-                                                                              "normal")}));
+    MeshData process_mesh(const aiScene* source_scene, const aiMesh* mesh, const aiMatrix4x4& mesh_transform){
+        MeshData data;
+        copy_vertices(mesh, data.vertices);
+        copy_indices(mesh, data.indices);
 
         const unsigned int material_index = mesh->mMaterialIndex;
         aiMaterial* assimp_material = source_scene->mMaterials[material_index];
+        data.material = convert_assimp_material(assimp_material);
 
-        SceneObject obj;
-        obj.set_transform_matrix(aiMatrix4x4(mesh_transform));
-        obj.vao->set_vbo(std::move(vbo));
-        obj.vao->set_ebo(std::make_shared<ElementBuffer>(indices));
-        obj.material = convert_assimp_material(assimp_material);
-        return obj;
+        data.transform = to_glm_matrix(mesh_transform);
+        data.proxies = build_mesh_proxies(data.vertices, data.indices);
+        return data;
     }
 
-    std::vector<SceneObject> process_scene_node(const aiScene* scene, const aiNode* node,
-                                                               const aiMatrix4x4& parent_transform){
-        std::vector<SceneObject> objects;
+    std::vector<MeshData> process_scene_node(const aiScene* scene, const aiNode* node,
+                                             const aiMatrix4x4& parent_transform){
+        std::vector<MeshData> meshes;
 
         const auto node_transform = parent_transform * node->mTransformation;
         for (auto i = 0u; i < node->mNumMeshes; ++i) {
             const auto mesh_index = node->mMeshes[i];
-            objects.emplace_back(process_mesh(scene, scene->mMeshes[mesh_index], node_transform));
+            meshes.emplace_back(process_mesh(scene, scene->mMeshes[mesh_index], node_transform));
         }
 
         for (auto child_index = 0u; child_index < node->mNumChildren; ++child_index) {
@@ -117,30 +131,139 @@ namespace engine::scenes{
                                                         node->mChildren[child_index],
                                                         node_transform);
             std::move(std::begin(processing_result), std::end(processing_result),
-                      std::back_inserter(objects));
+                      std::back_inserter(meshes));
         }
-        return objects;
+        return meshes;
     }
 
-    std::vector<SceneObject> load_scene_objects_from(const std::string& path_to_scene, unsigned int assimp_postprocess_flags) {
+    SceneObject upload_mesh(const MeshData& mesh, const std::shared_ptr<GeometryPool>& pool){
+        auto obj = impl_details::object_without_geometry(mesh);
+        if(pool){
+            obj.vao.reset();
+            obj.geometry = GeometryAllocation(pool, pool->allocate(mesh.vertices, mesh.indices));
+            for(const auto& proxy : mesh.proxies){
+                obj.proxies.push_back(MeshProxy{GeometryAllocation(pool, pool->allocate(proxy.vertices, proxy.indices)),
+                                                proxy.geometric_error,
+                                                static_cast<unsigned int>(proxy.indices.size() / 3)});
+            }
+            return obj;
+        }
+
+        auto vbo = std::make_shared<VertexBuffer>(mesh.vertices.size() * sizeof(float),
+                                                  mesh.vertices.data());
+        vbo->set_buffer_layout(VertexBufferLayout({
+                                                          VertexBufferElement(ShaderDataType::Float3,
+                                                                              "position"),
+                                                          VertexBufferElement(ShaderDataType::Float3,
+                                                                              "normal")}));
+
+        obj.vao->set_vbo(std::move(vbo));
+        obj.vao->set_ebo(std::make_shared<ElementBuffer>(mesh.indices));
+        return obj;
+    }
+
+    std::size_t staged_size_of(const MeshData& mesh){
+        auto size = mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int);
+        for(const auto& proxy : mesh.proxies){
+            size += proxy.vertices.size() * sizeof(float) + proxy.indices.size() * sizeof(unsigned int);
+        }
+        return size;
+    }
+
+    void write_staged_mesh(const MeshData& mesh, std::byte* destination){
+        const auto write = [&destination](const auto& values){
+            const auto bytes = values.size() * sizeof(values[0]);
+            std::memcpy(destination, values.data(), bytes);
+            destination += bytes;
+        };
+        write(mesh.vertices);
+        write(mesh.indices);
+        for(const auto& proxy : mesh.proxies){
+            write(proxy.vertices);
+            write(proxy.indices);
+        }
+    }
+
+    SceneObject upload_staged_mesh(const MeshData& mesh, const StagingBuffer& staged,
+                                   const std::shared_ptr<GeometryPool>& pool){
+        constexpr auto vertex_size = 6u * sizeof(float);      //  As written by copy_vertices
+
+        auto obj = impl_details::object_without_geometry(mesh);
+        obj.vao.reset();
+        auto offset = std::size_t{0};
+        const auto allocate_next = [&](const std::vector<float>& vertices, const std::vector<unsigned int>& indices){
+            const auto vertices_offset = offset;
+            const auto indices_offset = offset + vertices.size() * sizeof(float);
+            offset = indices_offset + indices.size() * sizeof(unsigned int);
+            return GeometryAllocation(pool, pool->allocate_from(staged.id, static_cast<unsigned int>(vertices_offset),
+                                                                static_cast<unsigned int>(vertices.size() * sizeof(float) / vertex_size),
+                                                                static_cast<unsigned int>(indices_offset),
+                                                                static_cast<unsigned int>(indices.size())));
+        };
+        obj.geometry = allocate_next(mesh.vertices, mesh.indices);
+        for(const auto& proxy : mesh.proxies){
+            obj.proxies.push_back(MeshProxy{allocate_next(proxy.vertices, proxy.indices), proxy.geometric_error,
+                                            static_cast<unsigned int>(proxy.indices.size() / 3)});
+        }
+        return obj;
+    }
+
+    std::vector<MeshData> load_scene_meshes_from(const std::string& path_to_scene, unsigned int assimp_postprocess_flags) {
+        PROFILE_ZONE("Scene loading");
+        const auto cache_path = scene_cache_path_for(path_to_scene);
+        const auto source_hash = hash_file_contents(path_to_scene);
+        auto cached_meshes = source_hash.has_value()
+                             ? read_scene_cache(cache_path, source_hash.value(), assimp_postprocess_flags)
+                             : std::nullopt;
+        if(cached_meshes.has_value()){
+            return std::move(cached_meshes.value());
+        }
+
         Assimp::Importer scene_importer;
         const aiScene* loaded_scene = scene_importer.ReadFile(path_to_scene, assimp_postprocess_flags);
 
         if(loaded_scene == nullptr){
             fmt::print("[SCENE LOADING] Reading scene failed.\n");
-            return std::vector<SceneObject>{};
+            return std::vector<MeshData>{};
         }
 
-        std::vector<SceneObject> objects;
-        objects.reserve(loaded_scene->mNumMeshes);
-
+        std::vector<MeshData> meshes;
+        meshes.reserve(loaded_scene->mNumMeshes);
         for (auto child_index = 0u; child_index < loaded_scene->mRootNode->mNumChildren; ++child_index) {
             auto processing_result = process_scene_node(loaded_scene,
                                                         loaded_scene->mRootNode->mChildren[child_index],
                                                         loaded_scene->mRootNode->mTransformation);
-            std::move(std::begin(processing_result), std::end(processing_result),
-                      std::back_inserter(objects));
+            std::move(std::begin(processing_result), std::end(processing_result), std::back_inserter(meshes));
+        }
+        if(source_hash.has_value()){
+            write_scene_cache(cache_path, source_hash.value(), assimp_postprocess_flags, meshes);
+        }
+        return meshes;
+    }
+
+    std::vector<SceneObject> load_scene_objects_from(const std::string& path_to_scene, unsigned int assimp_postprocess_flags,
+                                                     const std::shared_ptr<GeometryPool>& pool) {
+        const auto meshes = load_scene_meshes_from(path_to_scene, assimp_postprocess_flags);
+        std::vector<SceneObject> objects;
+        objects.reserve(meshes.size());
+        for(const auto& mesh : meshes){
+            objects.push_back(upload_mesh(mesh, pool));
         }
         return objects;
     }
+}
+
+namespace engine::scenes::impl_details{
+    SceneObject object_without_geometry(const MeshData& mesh){
+        constexpr auto floats_per_vertex = 6u;     //  As written by copy_vertices
+
+        SceneObject obj;
+        obj.transform = mesh.transform;
+        obj.transpose_inverse_transform = glm::transpose(glm::inverse(mesh.transform));
+        obj.material = mesh.material;
+        for(auto i = 0u; i + 2 < mesh.vertices.size(); i += floats_per_vertex){
+            obj.bounds.expand(glm::vec3(mesh.vertices[i], mesh.vertices[i + 1], mesh.vertices[i + 2]));
+        }
+        return obj;
+    }
 }
\ No newline at end of file
@@ -2,6 +2,13 @@
 #define SCENE_LOADING_H
 
 #include "scene_object.h"
+#include "mesh_simplification.h"
+
+#include "../rendering/opengl3_upload_thread.h"
+
+#include <cstddef>
+
+#include <vector>
 
 namespace engine::scenes{
     void copy_vertices(const aiMesh* source,
@@ -10,14 +17,55 @@ namespace engine::scenes{
     void copy_indices(const aiMesh* source,
                       std::vector<unsigned int>& destination);
 
-    SceneObject process_mesh(const aiScene* source_scene,
-                             const aiMesh* mesh,
-                             const aiMatrix4x4& mesh_transform);
-    std::vector<SceneObject> process_scene_node(const aiScene* scene,
-                                                const aiNode* node,
-                                                const aiMatrix4x4& parent_transform);
+    //  Meshes with fewer triangles are cheap enough to draw as they are in every pass
+    constexpr unsigned int min_triangles_for_proxies = 1024;
+    constexpr unsigned int max_mesh_proxies = 3;
+
+    //  Everything taken from one aiMesh before anything reaches the GPU; this is what the scene cache stores
+    struct MeshData {
+        glm::mat4 transform;
+        Material material;
+        std::vector<float> vertices;            //  Interleaved position and normal
+        std::vector<unsigned int> indices;
+        std::vector<SimplifiedMesh> proxies;
+    };
+
+    //  Each proxy keeps about a quarter of the triangles of the previous level and is simplified from it;
+    //  its error adds up the errors of the levels before it
+    [[nodiscard]] std::vector<SimplifiedMesh> build_mesh_proxies(const std::vector<float>& vertices,
+                                                                 const std::vector<unsigned int>& indices);
+
+    MeshData process_mesh(const aiScene* source_scene,
+                          const aiMesh* mesh,
+                          const aiMatrix4x4& mesh_transform);
+    std::vector<MeshData> process_scene_node(const aiScene* scene,
+                                             const aiNode* node,
+                                             const aiMatrix4x4& parent_transform);
+    //  Without a pool every mesh gets its own buffers and VAO, and the proxies are dropped
+    SceneObject upload_mesh(const MeshData& mesh,
+                            const std::shared_ptr<GeometryPool>& pool = nullptr);
+
+    //  Staging layout of a mesh: its vertices and indices, then those of every proxy in order
+    [[nodiscard]] std::size_t staged_size_of(const MeshData& mesh);
+    void write_staged_mesh(const MeshData& mesh, std::byte* destination);
+    //  Same as upload_mesh with a pool, copying on the GPU from a buffer written by write_staged_mesh
+    SceneObject upload_staged_mesh(const MeshData& mesh,
+                                   const StagingBuffer& staged,
+                                   const std::shared_ptr<GeometryPool>& pool);
+
+    //  Goes through the scene cache next to the source; the importer only runs when the cache is missing
+    //  or stale, and its result is cached for the next launch. Touches no GL state, so it can run on any thread
+    std::vector<MeshData> load_scene_meshes_from(const std::string& path_to_scene,
+                                                 const unsigned int assimp_postprocess_flags);
+    //  load_scene_meshes_from followed by upload_mesh for every mesh
     std::vector<SceneObject> load_scene_objects_from(const std::string& path_to_scene,
-                                                     const unsigned int assimp_postprocess_flags);
+                                                     const unsigned int assimp_postprocess_flags,
+                                                     const std::shared_ptr<GeometryPool>& pool = nullptr);
+
+    namespace impl_details {
+        //  Transform, material and bounds of the mesh, with no geometry yet
+        [[nodiscard]] SceneObject object_without_geometry(const MeshData& mesh);
+    }
 }
 
 
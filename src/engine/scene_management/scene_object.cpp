@@ -1,5 +1,7 @@
 #include "scene_object.h"
 
+#include <algorithm>
+
 namespace engine{
     SceneObject::SceneObject() :
         vao{std::make_unique<VertexArray>()},
@@ -8,14 +10,49 @@ namespace engine{
         material{}
         {}
 
-    void SceneObject::set_transform_matrix(aiMatrix4x4 model_matrix){
-        const auto& m = model_matrix.Transpose();
+    glm::mat4 to_glm_matrix(aiMatrix4x4 matrix){
+        const auto& m = matrix.Transpose();
 
-        transform = glm::mat4(m.a1, m.a2, m.a3, m.a4,
-                              m.b1, m.b2, m.b3, m.b4,
-                              m.c1, m.c2, m.c3, m.c4,
-                              m.d1, m.d2, m.d3, m.d4);
+        return glm::mat4(m.a1, m.a2, m.a3, m.a4,
+                         m.b1, m.b2, m.b3, m.b4,
+                         m.c1, m.c2, m.c3, m.c4,
+                         m.d1, m.d2, m.d3, m.d4);
+    }
 
+    void SceneObject::set_transform_matrix(aiMatrix4x4 model_matrix){
+        transform = to_glm_matrix(model_matrix);
         transpose_inverse_transform = glm::transpose(glm::inverse(transform));
     }
+
+    const VertexArray& SceneObject::vertex_array() const {
+        return geometry.is_valid() ? geometry.pool()->vertex_array() : *vao;
+    }
+
+    GeometryRange SceneObject::geometry_range() const {
+        if (geometry.is_valid()) {
+            return geometry.range();
+        }
+        return GeometryRange{0, 0, 0, vao->get_ebo()->get_count()};
+    }
+
+    AABB SceneObject::world_bounds() const {
+        return bounds.transformed(transform);
+    }
+
+    std::size_t SceneObject::lod_levels() const {
+        return proxies.size() + 1;
+    }
+
+    GeometryRange SceneObject::lod_range(const std::size_t level) const {
+        return level == 0 ? geometry_range() : proxies[std::min(level, proxies.size()) - 1].geometry.range();
+    }
+
+    float SceneObject::lod_world_error(const std::size_t level) const {
+        if (level == 0) {
+            return 0.0f;
+        }
+        const auto largest_scale = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                                             glm::length(glm::vec3(transform[2]))});
+        return proxies[std::min(level, proxies.size()) - 1].geometric_error * largest_scale;
+    }
 }
\ No newline at end of file
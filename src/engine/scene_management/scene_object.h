@@ -1,6 +1,9 @@
 #ifndef SCENE_OBJECT_H
 #define SCENE_OBJECT_H
 
+#include "bounding_volumes.h"
+
+#include "../rendering/geometry_pool.h"
 #include "../rendering/vertex_array.h"
 #include "../rendering/material.h"
 
@@ -15,16 +18,40 @@
 #pragma warning(error : 4061)
 
 namespace engine{
+    //  A coarser version of an object's mesh, in the same pool
+    struct MeshProxy {
+        GeometryAllocation geometry;
+        float geometric_error;      //  In model units, see SimplifiedMesh
+        unsigned int triangles;
+    };
+
+    //  assimp matrices are row-major, glm ones column-major
+    [[nodiscard]] glm::mat4 to_glm_matrix(aiMatrix4x4 matrix);
+
     class SceneObject{
     public:
         SceneObject();
 
         void set_transform_matrix(aiMatrix4x4 model_matrix);
 
+        //  Either the object owns its buffers through vao, or its mesh is a range of a shared GeometryPool
+        [[nodiscard]] const VertexArray& vertex_array() const;
+        [[nodiscard]] GeometryRange geometry_range() const;
+        [[nodiscard]] AABB world_bounds() const;
+
+        //  Level 0 is the mesh itself, the following ones are the proxies
+        [[nodiscard]] std::size_t lod_levels() const;
+        [[nodiscard]] GeometryRange lod_range(std::size_t level) const;
+        //  Geometric error of the level scaled by the largest axis scale of the transform
+        [[nodiscard]] float lod_world_error(std::size_t level) const;
+
         std::unique_ptr<VertexArray> vao;
+        GeometryAllocation geometry;
         glm::mat4 transform;
         glm::mat4 transpose_inverse_transform;
         Material material;
+        AABB bounds;        //  In model space
+        std::vector<MeshProxy> proxies;     //  From the finest
     };
 }
 
@@ -0,0 +1,163 @@
+#include "ies_intensity_map.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ies::adapter {
+    using namespace impl_details;
+
+    std::vector<float> normalized_intensity_map(const IES_Document& document,
+                                                const unsigned int columns, const unsigned int rows) {
+        const auto& light_data = document.photometric_description.measured_data;
+        const auto& light_type = document.photometric_description.data_type;
+
+        std::vector<float> intensities(columns * rows, 0.0f);
+        const auto& candelas = light_data.candelas_per_angle_pair;
+        const auto max_candela = candelas.empty() ? 0.0f : *std::max_element(std::begin(candelas),
+                                                                             std::end(candelas));
+        if (max_candela <= 0.0f) {
+            return intensities;
+        }
+
+        const auto sample_at = [&](const float vertical_angle, const float horizontal_angle) -> std::optional<float> {
+            if (const auto h = fold_horizontal_angle(light_data, light_type, horizontal_angle)) {
+                return sample_candelas(light_data, vertical_angle, h.value());
+            }
+            return std::nullopt;
+        };
+
+        for (auto row = 0u; row < rows; ++row) {
+            const auto vertical_angle = (static_cast<float>(row) + 0.5f) * 180.0f / static_cast<float>(rows);
+            for (auto column = 0u; column < columns; ++column) {
+                const auto horizontal_angle = (static_cast<float>(column) + 0.5f) * 360.0f / static_cast<float>(columns);
+                //  Negative vertical angles (types A and B) describe the same direction as the
+                //  opposite horizontal half-plane with a positive vertical angle
+                auto candela = sample_at(vertical_angle, horizontal_angle);
+                if (!candela.has_value()) {
+                    candela = sample_at(-vertical_angle, horizontal_angle + 180.0f);
+                }
+                intensities[row * columns + column] = candela.value_or(0.0f) / max_candela;
+            }
+        }
+        return intensities;
+    }
+
+    std::optional<float> fold_horizontal_angle(const Photometric_Angles& light_data,
+                                               const Photometric_Type& light_type,
+                                               const float horizontal_angle) {
+        const auto& angles = light_data.horizontal_angles;
+        if (angles.empty()) {
+            return std::nullopt;
+        }
+
+        auto h = std::fmod(horizontal_angle, 360.0f);
+        if (h < 0.0f) {
+            h += 360.0f;
+        }
+
+        if (light_type == Photometric_Type::Type_A || light_type == Photometric_Type::Type_B) {
+            if (h > 180.0f) {
+                h -= 360.0f;
+            }
+            if (angles.front() == 0.0f && angles.back() == 90.0f) {
+                h = std::abs(h);
+                h = h > 90.0f ? 180.0f - h : h;
+            } else if (angles.front() == -90.0f && angles.back() == 90.0f) {
+                if (h > 90.0f) {
+                    h = 180.0f - h;
+                } else if (h < -90.0f) {
+                    h = -180.0f - h;
+                }
+            }
+        } else if (light_type == Photometric_Type::Type_C) {
+            if (angles.size() == 1 && angles.front() == 0.0f) {
+                // The luminaire is symmetric in all [vertical] photometric planes
+                h = 0.0f;
+            } else if (angles.front() == 0.0f && angles.back() == 90.0f) {
+                h = h > 180.0f ? 360.0f - h : h;
+                h = h > 90.0f ? 180.0f - h : h;
+            } else if (angles.front() == 0.0f && angles.back() == 180.0f) {
+                h = h > 180.0f ? 360.0f - h : h;
+            } else if (angles.front() == 90.0f && angles.back() == 270.0f) {
+                if (h < 90.0f) {
+                    h = 180.0f - h;
+                } else if (h > 270.0f) {
+                    h = 540.0f - h;
+                }
+            }
+        }
+
+        if (h < angles.front() || h > angles.back()) {
+            return std::nullopt;
+        }
+        return h;
+    }
+
+    std::optional<float> sample_candelas(const Photometric_Angles& light_data,
+                                         const float vertical_angle, const float horizontal_angle) {
+        const auto& vertical_angles = light_data.vertical_angles;
+        const auto& horizontal_angles = light_data.horizontal_angles;
+        if (vertical_angles.empty() || horizontal_angles.empty() ||
+            vertical_angle < vertical_angles.front() || vertical_angle > vertical_angles.back()) {
+            return std::nullopt;
+        }
+
+        const auto [v, v_weight] = bracketing_interval(vertical_angles, vertical_angle);
+        const auto [h, h_weight] = bracketing_interval(horizontal_angles, horizontal_angle);
+        const auto next_v = std::min(v + 1, vertical_angles.size() - 1);
+        const auto next_h = std::min(h + 1, horizontal_angles.size() - 1);
+
+        //  Candelas are stored one horizontal angle after the other, as in points_from_directions
+        const auto columns = vertical_angles.size();
+        const auto& candelas = light_data.candelas_per_angle_pair;
+        const auto candela_at = [&](const std::size_t row, const std::size_t column) {
+            return candelas[row * columns + column];
+        };
+
+        const auto lower = candela_at(h, v) * (1.0f - v_weight) + candela_at(h, next_v) * v_weight;
+        const auto upper = candela_at(next_h, v) * (1.0f - v_weight) + candela_at(next_h, next_v) * v_weight;
+        return lower * (1.0f - h_weight) + upper * h_weight;
+    }
+
+    std::uint64_t photometric_content_hash(const IES_Document& document) {
+        const auto& light_data = document.photometric_description.measured_data;
+        const auto light_type = document.photometric_description.data_type;
+
+        std::uint64_t hash = 0xcbf29ce484222325;
+        hash_bytes(hash, &light_type, sizeof(light_type));
+        hash_floats(hash, light_data.vertical_angles);
+        hash_floats(hash, light_data.horizontal_angles);
+        hash_floats(hash, light_data.candelas_per_angle_pair);
+        return hash;
+    }
+}
+
+namespace ies::adapter::impl_details {
+    std::pair<std::size_t, float> bracketing_interval(const std::vector<float>& angles, const float angle) {
+        if (angles.size() == 1) {
+            return {0, 0.0f};
+        }
+        const auto upper = std::upper_bound(std::begin(angles), std::end(angles), angle);
+        const auto upper_index = std::clamp<std::size_t>(std::distance(std::begin(angles), upper),
+                                                         1, angles.size() - 1);
+        const auto lower_index = upper_index - 1;
+        const auto span = angles[upper_index] - angles[lower_index];
+        const auto weight = span > 0.0f ? (angle - angles[lower_index]) / span : 0.0f;
+        return {lower_index, std::clamp(weight, 0.0f, 1.0f)};
+    }
+
+    void hash_bytes(std::uint64_t& hash, const void* data, const std::size_t size) {
+        constexpr std::uint64_t fnv_prime = 0x100000001b3;
+        const auto bytes = static_cast<const unsigned char*>(data);
+        for (auto i = 0u; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= fnv_prime;
+        }
+    }
+
+    void hash_floats(std::uint64_t& hash, const std::vector<float>& values) {
+        const auto count = values.size();
+        hash_bytes(hash, &count, sizeof(count));
+        hash_bytes(hash, values.data(), values.size() * sizeof(float));
+    }
+}
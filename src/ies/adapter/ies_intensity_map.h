@@ -0,0 +1,41 @@
+#ifndef IES_INTENSITY_MAP_H
+#define IES_INTENSITY_MAP_H
+
+#include "../ies_document.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ies::adapter {
+    //  Columns span the horizontal angles in [0, 360), rows the vertical angles in [0, 180];
+    //  both are sampled at texel centers, using the same conventions as polar_coordinates_to_unit_vector
+    //  and the symmetries applied by the type-specific mesh adapters.
+    std::vector<float> normalized_intensity_map(const IES_Document& document,
+                                                unsigned int columns, unsigned int rows);
+
+    std::optional<float> fold_horizontal_angle(const Photometric_Angles& light_data,
+                                               const Photometric_Type& light_type,
+                                               float horizontal_angle);
+
+    std::optional<float> sample_candelas(const Photometric_Angles& light_data,
+                                         float vertical_angle, float horizontal_angle);
+
+    //  FNV-1a over the photometric type, the angles and the candela values; two documents
+    //  with the same hash produce the same intensity map.
+    std::uint64_t photometric_content_hash(const IES_Document& document);
+
+    namespace impl_details {
+        //  Returns the index i so that angles[i] <= angle <= angles[i + 1] and the interpolation weight
+        //  of angles[i + 1]; angles are sorted in ascending order, as mandated by the standard.
+        [[nodiscard]] std::pair<std::size_t, float> bracketing_interval(const std::vector<float>& angles,
+                                                                        float angle);
+
+        void hash_bytes(std::uint64_t& hash, const void* data, std::size_t size);
+
+        void hash_floats(std::uint64_t& hash, const std::vector<float>& values);
+    }
+}
+
+#endif //IES_INTENSITY_MAP_H
@@ -30,31 +30,48 @@ namespace ies::adapter {
 
 
     std::vector<float> IES_Mesh::get_vertices() const {
+        std::vector<float> vertices(interleaved_vertices_size());
+        write_vertices_to(vertices);
+        return vertices;
+    }
+
+    std::vector<unsigned int> IES_Mesh::get_indices() const noexcept {
+        return std::vector(indices);
+    }
+
+    std::span<const glm::vec3> IES_Mesh::positions_view() const noexcept {
+        return positions;
+    }
+
+    std::span<const glm::vec3> IES_Mesh::normals_view() const noexcept {
+        return normals;
+    }
+
+    std::span<const unsigned int> IES_Mesh::indices_view() const noexcept {
+        return indices;
+    }
+
+    std::size_t IES_Mesh::interleaved_vertices_size() const noexcept {
         constexpr auto vertex_position_components = 3;
         constexpr auto vertex_normal_components = 3;
-        const auto number_of_vertices = positions.size();
-
-        std::vector<float> vertices;
-        vertices.reserve((vertex_position_components + vertex_normal_components) * number_of_vertices);
+        return (vertex_position_components + vertex_normal_components) * std::min(positions.size(), normals.size());
+    }
 
-        auto vertices_back_inserter = std::back_inserter(vertices);
+    void IES_Mesh::write_vertices_to(std::span<float> destination) const {
+        auto destination_it = std::begin(destination);
         auto positions_it = std::begin(positions);
         auto normals_it = std::begin(normals);
-        while (positions_it != std::end(positions) && normals_it != std::end(normals)) {
-            vertices_back_inserter = positions_it->x;
-            vertices_back_inserter = positions_it->y;
-            vertices_back_inserter = positions_it->z;
-            vertices_back_inserter = normals_it->x;
-            vertices_back_inserter = normals_it->y;
-            vertices_back_inserter = normals_it->z;
+        while (positions_it != std::end(positions) && normals_it != std::end(normals) &&
+               std::distance(destination_it, std::end(destination)) >= 6) {
+            *destination_it++ = positions_it->x;
+            *destination_it++ = positions_it->y;
+            *destination_it++ = positions_it->z;
+            *destination_it++ = normals_it->x;
+            *destination_it++ = normals_it->y;
+            *destination_it++ = normals_it->z;
             ++positions_it;
             ++normals_it;
         }
-        return vertices;
-    }
-
-    std::vector<unsigned int> IES_Mesh::get_indices() const noexcept {
-        return std::vector(indices);
     }
 
     IES_Mesh::IES_Mesh(const IES_Document& document, const unsigned int interpolated_points_per_edge) {
@@ -7,6 +7,7 @@
 
 #include "glm/glm.hpp"
 
+#include <span>
 #include <utility>
 
 namespace ies::adapter {
@@ -36,6 +37,15 @@ namespace ies::adapter {
 
         [[nodiscard]] std::vector<unsigned int> get_indices() const noexcept;
 
+        [[nodiscard]] std::span<const glm::vec3> positions_view() const noexcept;
+        [[nodiscard]] std::span<const glm::vec3> normals_view() const noexcept;
+        [[nodiscard]] std::span<const unsigned int> indices_view() const noexcept;
+
+        //  Interleaved position/normal layout, the same returned by get_vertices
+        [[nodiscard]] std::size_t interleaved_vertices_size() const noexcept;
+        //  Destination must hold at least interleaved_vertices_size() floats, e.g. a mapped vertex buffer
+        void write_vertices_to(std::span<float> destination) const;
+
     private:
         IES_Mesh(const IES_Document& document,
                  const unsigned int interpolated_points_per_edge);
@@ -0,0 +1,105 @@
+#include "ies_spherical_harmonics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ies::adapter {
+    std::array<float, spherical_harmonics_coefficients(max_spherical_harmonics_order)>
+    spherical_harmonics_basis(const glm::vec3& direction) {
+        //  Textbook formulas have z as the polar axis: relabel the photometric frame accordingly
+        const auto x = direction.x;
+        const auto y = direction.z;
+        const auto z = direction.y;
+        const auto x2 = x * x;
+        const auto y2 = y * y;
+        const auto z2 = z * z;
+
+        return {0.282095f,
+
+                0.488603f * y,
+                0.488603f * z,
+                0.488603f * x,
+
+                1.092548f * x * y,
+                1.092548f * y * z,
+                0.315392f * (3.0f * z2 - 1.0f),
+                1.092548f * x * z,
+                0.546274f * (x2 - y2),
+
+                0.590044f * y * (3.0f * x2 - y2),
+                2.890611f * x * y * z,
+                0.457046f * y * (5.0f * z2 - 1.0f),
+                0.373176f * z * (5.0f * z2 - 3.0f),
+                0.457046f * x * (5.0f * z2 - 1.0f),
+                1.445306f * z * (x2 - y2),
+                0.590044f * x * (x2 - 3.0f * y2),
+
+                2.503343f * x * y * (x2 - y2),
+                1.770131f * y * z * (3.0f * x2 - y2),
+                0.946175f * x * y * (7.0f * z2 - 1.0f),
+                0.669047f * y * z * (7.0f * z2 - 3.0f),
+                0.105786f * (35.0f * z2 * z2 - 30.0f * z2 + 3.0f),
+                0.669047f * x * z * (7.0f * z2 - 3.0f),
+                0.473087f * (x2 - y2) * (7.0f * z2 - 1.0f),
+                1.770131f * x * z * (x2 - 3.0f * y2),
+                0.625836f * (x2 * (x2 - 3.0f * y2) - y2 * (3.0f * x2 - y2))};
+    }
+
+    Spherical_Harmonics_Fit fit_spherical_harmonics(const IES_Document& document, const unsigned int order,
+                                                    const unsigned int columns, const unsigned int rows) {
+        Spherical_Harmonics_Fit fit;
+        fit.order = std::min(order, max_spherical_harmonics_order);
+        const auto coefficients_number = spherical_harmonics_coefficients(fit.order);
+        fit.coefficients.assign(coefficients_number, 0.0f);
+
+        const auto intensities = normalized_intensity_map(document, columns, rows);
+        const auto d_horizontal = glm::two_pi<float>() / static_cast<float>(columns);
+        const auto d_vertical = glm::pi<float>() / static_cast<float>(rows);
+
+        const auto direction_at = [&](const unsigned int row, const unsigned int column) {
+            const auto vertical_angle = (static_cast<float>(row) + 0.5f) * 180.0f / static_cast<float>(rows);
+            const auto horizontal_angle = (static_cast<float>(column) + 0.5f) * 360.0f / static_cast<float>(columns);
+            return polar_coordinates_to_unit_vector(vertical_angle, horizontal_angle);
+        };
+        const auto solid_angle_at = [&](const unsigned int row) {
+            const auto vertical_angle = (static_cast<float>(row) + 0.5f) * d_vertical;
+            return std::sin(vertical_angle) * d_vertical * d_horizontal;
+        };
+
+        for (auto row = 0u; row < rows; ++row) {
+            const auto solid_angle = solid_angle_at(row);
+            for (auto column = 0u; column < columns; ++column) {
+                const auto basis = spherical_harmonics_basis(direction_at(row, column));
+                const auto intensity = intensities[row * columns + column];
+                for (auto i = 0u; i < coefficients_number; ++i) {
+                    fit.coefficients[i] += intensity * basis[i] * solid_angle;
+                }
+            }
+        }
+
+        auto squared_error_sum = 0.0f;
+        auto total_solid_angle = 0.0f;
+        for (auto row = 0u; row < rows; ++row) {
+            const auto solid_angle = solid_angle_at(row);
+            for (auto column = 0u; column < columns; ++column) {
+                const auto reconstructed = evaluate_spherical_harmonics(fit, direction_at(row, column));
+                const auto error = std::abs(reconstructed - intensities[row * columns + column]);
+                squared_error_sum += error * error * solid_angle;
+                total_solid_angle += solid_angle;
+                fit.max_error = std::max(fit.max_error, error);
+            }
+        }
+        fit.rms_error = total_solid_angle > 0.0f ? std::sqrt(squared_error_sum / total_solid_angle) : 0.0f;
+        return fit;
+    }
+
+    float evaluate_spherical_harmonics(const Spherical_Harmonics_Fit& fit, const glm::vec3& direction) {
+        const auto basis = spherical_harmonics_basis(direction);
+        auto result = 0.0f;
+        for (auto i = 0u; i < fit.coefficients.size(); ++i) {
+            result += fit.coefficients[i] * basis[i];
+        }
+        //  Ringing can make the truncated expansion negative; shaders clamp the same way
+        return std::max(result, 0.0f);
+    }
+}
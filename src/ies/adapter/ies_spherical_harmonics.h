@@ -0,0 +1,43 @@
+#ifndef IES_SPHERICAL_HARMONICS_H
+#define IES_SPHERICAL_HARMONICS_H
+
+#include "ies_intensity_map.h"
+#include "ies_mesh_adapter.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <array>
+#include <vector>
+
+namespace ies::adapter {
+    constexpr unsigned int max_spherical_harmonics_order = 4;
+
+    struct Spherical_Harmonics_Fit {
+        unsigned int order = 0;
+        std::vector<float> coefficients;
+        //  Errors on the normalized intensity, measured on the sampling grid used for the projection
+        float rms_error = 0.0f;
+        float max_error = 0.0f;
+    };
+
+    [[nodiscard]] constexpr unsigned int spherical_harmonics_coefficients(const unsigned int order) {
+        return (order + 1) * (order + 1);
+    }
+
+    //  Real spherical harmonics up to max_spherical_harmonics_order; the polar axis is the photometric
+    //  vertical (+y), matching polar_coordinates_to_unit_vector. Must stay in sync with the GLSL version.
+    [[nodiscard]] std::array<float, spherical_harmonics_coefficients(max_spherical_harmonics_order)>
+    spherical_harmonics_basis(const glm::vec3& direction);
+
+    //  Projects the normalized intensity of the document onto the first (order + 1)^2 basis functions,
+    //  integrating over a columns x rows longitude-latitude grid; order is clamped to the supported maximum.
+    [[nodiscard]] Spherical_Harmonics_Fit fit_spherical_harmonics(const IES_Document& document,
+                                                                  unsigned int order,
+                                                                  unsigned int columns = 128,
+                                                                  unsigned int rows = 64);
+
+    [[nodiscard]] float evaluate_spherical_harmonics(const Spherical_Harmonics_Fit& fit, const glm::vec3& direction);
+}
+
+#endif //IES_SPHERICAL_HARMONICS_H
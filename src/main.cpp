@@ -3,5 +3,8 @@
 int main(){
     BoxApp built_application;
     built_application.run();
+    if constexpr (profiling::enabled) {
+        profiling::write_chrome_trace("cpu_trace.json");
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "cpu_profiler.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace profiling {
+    using namespace impl_details;
+
+    ThreadZones::ThreadZones(const std::uint32_t id, std::string&& name)
+            : slots(std::make_unique<Slot[]>(zones_per_thread)), thread_id(id), thread_name(std::move(name)) {}
+
+    void set_thread_name(std::string name) {
+        auto& zones = zones_of_this_thread();
+        auto& threads = registry();
+        std::lock_guard lock(threads.mutex);
+        zones.thread_name = std::move(name);
+    }
+
+    bool write_chrome_trace(const std::filesystem::path& path) {
+        struct Zone {
+            const char* name;
+            std::int64_t begin_ns;
+            std::int64_t end_ns;
+        };
+
+        auto& threads = registry();
+        std::ofstream stream(path, std::ios::trunc);
+        stream << "{\"traceEvents\":[\n";
+        auto first_event = true;
+        const auto separator = [&first_event]() {
+            const auto* text = first_event ? "" : ",\n";
+            first_event = false;
+            return text;
+        };
+
+        std::lock_guard lock(threads.mutex);
+        std::vector<Zone> zones;
+        for (const auto& thread : threads.threads) {
+            stream << separator() << fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+                                                 thread->thread_id, escaped_for_json(thread->thread_name));
+
+            //  The owner keeps writing meanwhile: slots it may have reached again during the copy are dropped
+            const auto written = thread->written.load(std::memory_order_acquire);
+            const auto first = written > zones_per_thread ? written - zones_per_thread : 0;
+            zones.clear();
+            for (auto index = first; index < written; ++index) {
+                const auto& slot = thread->slots[index & (zones_per_thread - 1)];
+                zones.push_back(Zone{slot.name.load(std::memory_order_relaxed),
+                                     slot.begin_ns.load(std::memory_order_relaxed),
+                                     slot.end_ns.load(std::memory_order_relaxed)});
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const auto written_after_copy = thread->written.load(std::memory_order_relaxed);
+            //  The owner may be halfway through the zone at index written_after_copy, whose slot is shared
+            //  with the zone zones_per_thread before it
+            const auto reached = written_after_copy + 1;
+            const auto overwritten = reached > zones_per_thread ? reached - zones_per_thread : 0;
+            const auto valid_from = static_cast<std::size_t>(std::max(overwritten, first) - first);
+
+            for (auto i = std::min(valid_from, zones.size()); i < zones.size(); ++i) {
+                const auto& zone = zones[i];
+                stream << separator() << fmt::format(R"({{"name":"{}","cat":"cpu","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                                                     zone.name, thread->thread_id,
+                                                     static_cast<double>(zone.begin_ns - threads.epoch_ns) / 1000.0,
+                                                     static_cast<double>(zone.end_ns - zone.begin_ns) / 1000.0);
+            }
+        }
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        if (!stream) {
+            fmt::print("[CPU PROFILER] Writing {} failed\n", path.string());
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace profiling::impl_details {
+    ThreadRegistry& registry() {
+        static ThreadRegistry instance{{}, {}, now_ns()};
+        return instance;
+    }
+
+    ThreadZones& register_this_thread() {
+        auto& threads = registry();
+        std::lock_guard lock(threads.mutex);
+        const auto id = static_cast<std::uint32_t>(threads.threads.size() + 1);
+        auto& zones = threads.threads.emplace_back(std::make_shared<ThreadZones>(id, fmt::format("Thread {}", id)));
+        this_thread_zones = zones.get();
+        return *zones;
+    }
+
+    std::string escaped_for_json(const std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const auto character : text) {
+            if (character == '"' || character == '\\') {
+                escaped += '\\';
+            }
+            escaped += static_cast<unsigned char>(character) < 0x20 ? ' ' : character;
+        }
+        return escaped;
+    }
+}
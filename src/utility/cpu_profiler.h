@@ -0,0 +1,125 @@
+#ifndef CPU_PROFILER_H
+#define CPU_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//  Zones are only recorded in builds configured with CPU_PROFILING, everywhere else the macros expand to nothing.
+//  Names have to be string literals: only their address is stored, and it has to stay valid until the trace is written.
+#ifdef CPU_PROFILING_ENABLED
+#define PROFILE_CONCATENATE_IMPL(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_IMPL(a, b)
+#define PROFILE_ZONE(name) const profiling::ScopedZone PROFILE_CONCATENATE(profiled_zone_, __LINE__){"" name}
+#define PROFILE_THREAD(name) profiling::set_thread_name("" name)
+#else
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#define PROFILE_THREAD(name) static_cast<void>(0)
+#endif
+
+namespace profiling {
+#ifdef CPU_PROFILING_ENABLED
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    //  Zones kept per thread; older ones are overwritten, so a trace covers about the last
+    //  zones_per_thread / zones_per_frame frames of each thread
+    constexpr std::size_t zones_per_thread = 1 << 16;
+
+    //  Only its owning thread writes, and it never waits: the writer of the trace copies the slots and
+    //  discards the ones the owner overwrote meanwhile
+    class ThreadZones {
+    public:
+        ThreadZones(std::uint32_t id, std::string&& name);
+
+        ThreadZones(const ThreadZones& other) = delete;
+        ThreadZones(ThreadZones&& other) = delete;
+        ThreadZones& operator=(const ThreadZones& other) = delete;
+        ThreadZones& operator=(ThreadZones&& other) = delete;
+        ~ThreadZones() = default;
+
+        void record(const char* name, std::int64_t begin_ns, std::int64_t end_ns) noexcept {
+            const auto index = written.load(std::memory_order_relaxed);
+            auto& slot = slots[index & (zones_per_thread - 1)];
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+            slot.end_ns.store(end_ns, std::memory_order_relaxed);
+            written.store(index + 1, std::memory_order_release);
+        }
+
+    private:
+        friend bool write_chrome_trace(const std::filesystem::path& path);
+        friend void set_thread_name(std::string name);
+
+        struct Slot {
+            std::atomic<const char*> name{nullptr};
+            std::atomic<std::int64_t> begin_ns{0};
+            std::atomic<std::int64_t> end_ns{0};
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<std::uint64_t> written{0};
+        std::uint32_t thread_id;
+        std::string thread_name;        //  Guarded by the registry's mutex
+    };
+
+    namespace impl_details {
+        struct ThreadRegistry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadZones>> threads;
+            std::int64_t epoch_ns;
+        };
+
+        inline thread_local ThreadZones* this_thread_zones = nullptr;
+
+        [[nodiscard]] ThreadRegistry& registry();
+        [[nodiscard]] ThreadZones& register_this_thread();
+        //  Zone names are literals in the code, thread names are not
+        [[nodiscard]] std::string escaped_for_json(std::string_view text);
+    }
+
+    //  Registered on the first zone of the calling thread, and kept after it exits
+    [[nodiscard]] inline ThreadZones& zones_of_this_thread() {
+        auto* zones = impl_details::this_thread_zones;
+        return zones != nullptr ? *zones : impl_details::register_this_thread();
+    }
+
+    //  Shown in place of the thread id by trace viewers
+    void set_thread_name(std::string name);
+
+    [[nodiscard]] inline std::int64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    class ScopedZone {
+    public:
+        explicit ScopedZone(const char* zone_name) noexcept : name(zone_name), begin_ns(now_ns()) {}
+
+        ScopedZone(const ScopedZone& other) = delete;
+        ScopedZone(ScopedZone&& other) = delete;
+        ScopedZone& operator=(const ScopedZone& other) = delete;
+        ScopedZone& operator=(ScopedZone&& other) = delete;
+        ~ScopedZone() {
+            zones_of_this_thread().record(name, begin_ns, now_ns());
+        }
+
+    private:
+        const char* name;
+        std::int64_t begin_ns;
+    };
+
+    //  Chrome trace event format, which chrome://tracing and ui.perfetto.dev open: one complete event per zone
+    //  still held by any thread. Can be called at any time from any thread.
+    bool write_chrome_trace(const std::filesystem::path& path);
+}
+
+#endif //CPU_PROFILER_H
@@ -0,0 +1,101 @@
+#include "job_system.h"
+#include "cpu_profiler.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace jobs {
+    JobSystem::JobSystem(const unsigned int workers_count, const std::size_t max_pending_uploads)
+            : finished_jobs(max_pending_uploads) {
+        const auto threads = std::max(workers_count, 1u);
+        workers.reserve(threads);
+        for (auto i = 0u; i < threads; ++i) {
+            workers.emplace_back(&JobSystem::work, this);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock(jobs_mutex);
+            stopping = true;
+        }
+        jobs_available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void JobSystem::submit(Job job) {
+        in_flight.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(jobs_mutex);
+            queued_jobs.push_back(std::move(job));
+        }
+        jobs_available.notify_one();
+    }
+
+    void JobSystem::run_uploads(const std::chrono::microseconds budget) {
+        PROFILE_ZONE("Asset uploads");
+        const auto start = std::chrono::steady_clock::now();
+        UploadStep finished;
+        while (finished_jobs.try_pop(finished)) {
+            unfinished_uploads.push_back(std::move(finished));
+        }
+
+        //  Round robin, so that a long upload does not hold back the ones behind it
+        while (!unfinished_uploads.empty() && std::chrono::steady_clock::now() - start < budget) {
+            auto step = std::move(unfinished_uploads.front());
+            unfinished_uploads.pop_front();
+            if (step()) {
+                in_flight.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                unfinished_uploads.push_back(std::move(step));
+            }
+        }
+    }
+
+    unsigned int JobSystem::jobs_in_flight() const {
+        return in_flight.load(std::memory_order_relaxed);
+    }
+
+    unsigned int JobSystem::default_workers_count() {
+        return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    void JobSystem::work() {
+        PROFILE_THREAD("Job worker");
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock(jobs_mutex);
+                jobs_available.wait(lock, [this] { return stopping || !queued_jobs.empty(); });
+                if (stopping) {
+                    return;
+                }
+                job = std::move(queued_jobs.front());
+                queued_jobs.pop_front();
+            }
+
+            UploadStep upload;
+            try {
+                PROFILE_ZONE("Job");
+                upload = job();
+            } catch (const std::exception& error) {
+                fmt::print("[JOB SYSTEM] Job failed: {}\n", error.what());
+            }
+            if (!upload) {
+                in_flight.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            //  The GL thread drains the queue every frame, a full queue only lasts until the next one
+            while (!finished_jobs.try_push(std::move(upload))) {
+                if (std::lock_guard lock(jobs_mutex); stopping) {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "lock_free_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jobs {
+    //  Runs on the thread that calls run_uploads; returns true once done, false to be called again after
+    //  the other pending steps, on the same or a later frame
+    using UploadStep = std::function<bool()>;
+    //  Runs on a worker; returns what is left to do on the GL thread, or an empty step when nothing is
+    using Job = std::function<UploadStep()>;
+
+    //  Workers take jobs from a shared queue and hand the upload steps back through a lock-free queue,
+    //  which the GL thread drains within a time budget once per frame. Workers still running when the
+    //  system is destroyed are joined, queued jobs and pending uploads are dropped.
+    class JobSystem {
+    public:
+        explicit JobSystem(unsigned int workers_count = default_workers_count(),
+                           std::size_t max_pending_uploads = 64);
+
+        JobSystem(const JobSystem& other) = delete;
+        JobSystem(JobSystem&& other) = delete;
+        JobSystem& operator=(const JobSystem& other) = delete;
+        JobSystem& operator=(JobSystem&& other) = delete;
+        ~JobSystem();
+
+        void submit(Job job);
+        //  Steps are not interrupted, so a step longer than the budget still runs to its end
+        void run_uploads(std::chrono::microseconds budget);
+
+        //  Queued, running, or waiting for their uploads to finish
+        [[nodiscard]] unsigned int jobs_in_flight() const;
+        //  Leaves one hardware thread to the GL thread
+        [[nodiscard]] static unsigned int default_workers_count();
+
+    private:
+        void work();
+
+        std::vector<std::thread> workers;
+        std::mutex jobs_mutex;
+        std::condition_variable jobs_available;
+        std::deque<Job> queued_jobs;
+        bool stopping = false;
+
+        LockFreeQueue<UploadStep> finished_jobs;
+        std::deque<UploadStep> unfinished_uploads;     //  Only touched by the GL thread
+        std::atomic<unsigned int> in_flight{0};
+    };
+}
+
+#endif //JOB_SYSTEM_H
@@ -0,0 +1,94 @@
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace jobs {
+    //  Bounded multi-producer multi-consumer queue (Vyukov): every cell carries a sequence number telling
+    //  whether it is free for the producer at a position or filled for the consumer at that position, so
+    //  producers and consumers only contend on their own cursor. The capacity is rounded up to a power of two.
+    template<typename T>
+    class LockFreeQueue {
+    public:
+        explicit LockFreeQueue(const std::size_t capacity)
+                : cells(std::make_unique<Cell[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))),
+                  mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1) {
+            for (std::size_t i = 0; i <= mask; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        LockFreeQueue(const LockFreeQueue& other) = delete;
+        LockFreeQueue(LockFreeQueue&& other) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue& other) = delete;
+        LockFreeQueue& operator=(LockFreeQueue&& other) = delete;
+        ~LockFreeQueue() = default;
+
+        //  value is only moved from when the push succeeds; false when the queue is full
+        bool try_push(T&& value) {
+            auto position = enqueue_position.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true) {
+                cell = &cells[position & mask];
+                const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                if (difference == 0) {
+                    if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = std::move(value);
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        //  false when the queue is empty
+        bool try_pop(T& value) {
+            auto position = dequeue_position.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true) {
+                cell = &cells[position & mask];
+                const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence) -
+                                        static_cast<std::intptr_t>(position + 1);
+                if (difference == 0) {
+                    if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = dequeue_position.load(std::memory_order_relaxed);
+                }
+            }
+            value = std::move(cell->value);
+            //  The cell comes back to producers one lap later
+            cell->sequence.store(position + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        std::size_t mask;
+        //  On separate cache lines, so that producers and consumers do not invalidate each other's cursor
+        alignas(64) std::atomic<std::size_t> enqueue_position{0};
+        alignas(64) std::atomic<std::size_t> dequeue_position{0};
+    };
+}
+
+#endif //LOCK_FREE_QUEUE_H
@@ -1,9 +1,16 @@
 #include "random_numbers.h"
 
 namespace random_num {
+    static std::optional<std::uint32_t> fixed_seed;
+    static std::uint32_t next_stream = 0;
+
+    void use_fixed_seed(const std::optional<std::uint32_t> seed) {
+        fixed_seed = seed;
+        next_stream = 0;
+    }
+
     std::vector<float> uniform_samples_in_unit_interval(const unsigned int number_of_samples) {
-        std::random_device seeder;
-        std::mt19937 generator(seeder());
+        auto generator = impl_details::make_generator();
         std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
         std::vector<float> flattened_points;
         flattened_points.reserve(number_of_samples);
@@ -15,8 +22,7 @@ namespace random_num {
 
     std::vector<float>
     uniform_samples_in_interval(const unsigned int number_of_samples, const float min_value, const float max_value) {
-        std::random_device seeder;
-        std::mt19937 generator(seeder());
+        auto generator = impl_details::make_generator();
         std::uniform_real_distribution<float> distribution(min_value, max_value);
         std::vector<float> flattened_points;
         flattened_points.reserve(number_of_samples);
@@ -72,3 +78,15 @@ namespace random_num {
     }
 }
 
+namespace random_num::impl_details {
+    std::mt19937 make_generator() {
+        //  Seeding every generator with the bare seed would hand out the same sequence to every sample set
+        const auto stream = next_stream++;
+        if (fixed_seed.has_value()) {
+            std::seed_seq sequence{fixed_seed.value(), stream};
+            return std::mt19937(sequence);
+        }
+        std::random_device seeder;
+        return std::mt19937(seeder());
+    }
+}
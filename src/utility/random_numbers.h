@@ -4,16 +4,27 @@
 #include <glm/glm.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
+#include <optional>
 #include <random>
 #include <vector>
 
 namespace random_num{
+    //  Every later call draws from its own stream, derived from the seed and the number of calls made since,
+    //  so that the same sequence of calls gives the same samples and renders can be reproduced;
+    //  std::nullopt goes back to seeding from std::random_device
+    void use_fixed_seed(std::optional<std::uint32_t> seed);
+
     std::vector<float> uniform_samples_in_unit_interval(const unsigned int number_of_samples);
     std::vector<float> uniform_samples_in_interval(const unsigned int number_of_samples, const float min_value, const float max_value);
     std::vector <glm::vec3> random_polar_offsets(const unsigned int number_of_offsets);
     std::vector<glm::vec3> random_directions(const unsigned int number_of_directions);
     std::vector<glm::vec3> uniform_samples_on_unit_sphere(const unsigned int number_of_samples);
+
+    namespace impl_details {
+        [[nodiscard]] std::mt19937 make_generator();
+    }
 };
 
 #endif //RANDOM_NUMBERS_H